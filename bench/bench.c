@@ -0,0 +1,453 @@
+/*******************************************************************************************
+ * @file    bench.c
+ * @author  ka5j
+ * @brief   Host benchmark: replay command corpora through process_cmd()
+ * @version 1.0
+ * @date    2025-06-24
+ *
+ * @details
+ * Usage: bench [-n iterations] [-r] [-v] [-o results.json] corpus.txt ...
+ *
+ * A corpus is a text file with one terminal command per line; empty lines and lines
+ * starting with '#' are skipped. A line starting with '@' is hex bytes ("@00 07 03 01")
+ * that are fed through terminal_rx_char() as they are, in either mode and without an
+ * Enter, for binary frames and broken delimiters. Each corpus is replayed once to warm up, then
+ * `iterations` times while every command is timed. After each command the DMA model
+ * finishes any strip transfer it started (timed separately), so every command finds the
+ * drivers idle, as on the board.
+ *
+ * -r feeds the characters through terminal_rx_char() and the event loop instead of
+ * calling process_cmd() directly, which adds line assembly and dispatch to the cost.
+ *
+ * Each corpus runs on its own thread with a painted stack: the peak is measured from the
+ * thread entry to the deepest overwritten word. Heap calls made by the firmware are
+ * counted through the linker's --wrap (the firmware is expected to make none).
+ *
+ * Results are written as one JSON document (stdout by default); tools compare runs with
+ * bench/compare.py. Host numbers are for regression tracking, not target cycle counts.
+ *******************************************************************************************/
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "main_functions.h" // process_cmd(), terminal_start(), led inits
+#include "bare_dwt.h"       // Virtual cycle counter
+#include "event_loop.h"     // Dispatch in -r mode
+#include "ws2812.h"         // Strip init
+#include "apa102.h"         // Strip init
+#include "mem_pool.h"       // Scratch arena
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define BENCH_DEFAULT_ITERATIONS 1000U
+#define BENCH_MAX_COMMANDS 4096U         /*!< Lines per corpus                       */
+#define BENCH_STACK_BYTES (1024U * 1024U) /*!< Replay thread stack                   */
+#define BENCH_PAINT_WORD 0xA5A5A5A5U
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief One corpus and its results
+ */
+typedef struct
+{
+    const char *path;
+    const char *name;                    /*!< File name without directory and suffix */
+    char *lines[BENCH_MAX_COMMANDS];
+    uint16_t raw_len[BENCH_MAX_COMMANDS]; /*!< Bytes of an '@' line, 0 for a command */
+    uint32_t count;
+
+    uint32_t *samples;                   /*!< ns per timed command                   */
+    uint64_t total_ns;                   /*!< Sum of samples                         */
+    uint64_t dma_ns;                     /*!< Time in the DMA model                  */
+    uint64_t dma_isr_calls;
+    uint64_t tx_bytes;
+    uint32_t errors;                     /*!< UNKNOWN/INVALID responses per pass     */
+    uint64_t allocations;
+    uintptr_t stack_entry;               /*!< Replay thread's first frame            */
+    uint32_t stack_peak;                 /*!< Bytes below the thread entry           */
+} Bench_Corpus_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static uint32_t bench_iterations = BENCH_DEFAULT_ITERATIONS;
+static uint8_t bench_rx_mode;
+static volatile uint8_t bench_alloc_armed;
+static volatile uint64_t bench_alloc_calls;
+
+/*******************************************************************************************
+ *                                  Heap Call Counters
+ *******************************************************************************************/
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+void __real_free(void *p);
+
+void *__wrap_malloc(size_t size)
+{
+    bench_alloc_calls += bench_alloc_armed;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    bench_alloc_calls += bench_alloc_armed;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size)
+{
+    bench_alloc_calls += bench_alloc_armed;
+    return __real_realloc(p, size);
+}
+
+void __wrap_free(void *p)
+{
+    bench_alloc_calls += (p != NULL) ? bench_alloc_armed : 0U;
+    __real_free(p);
+}
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Monotonic time in ns.
+ */
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  Load a corpus file.
+ * @retval 0 on success, -1 on error (reported on stderr)
+ */
+static int bench_load(Bench_Corpus_t *c, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    char line[256];
+    c->path = path;
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#')
+        {
+            continue;
+        }
+        if (strlen(line) >= CMD_BUFFER_SIZE || c->count == BENCH_MAX_COMMANDS)
+        {
+            fprintf(stderr, "%s: line too long or too many lines: %s\n", path, line);
+            fclose(f);
+            return -1;
+        }
+        if (line[0] == '@')
+        {
+            uint16_t n = 0;
+            char *p = &line[1];
+            char *end;
+            unsigned long b = strtoul(p, &end, 16);
+            while (end != p && b <= 0xFFUL)
+            {
+                line[n++] = (char)b; // Behind p: every byte took at least one digit
+                p = end;
+                b = strtoul(p, &end, 16);
+            }
+            if (*p != '\0' || n == 0U)
+            {
+                fprintf(stderr, "%s: bad hex bytes at: %s\n", path, p);
+                fclose(f);
+                return -1;
+            }
+            c->raw_len[c->count] = n;
+            c->lines[c->count++] = memcpy(malloc(n), line, n);
+            continue;
+        }
+        c->lines[c->count++] = strdup(line);
+    }
+    fclose(f);
+
+    if (c->count == 0U)
+    {
+        fprintf(stderr, "%s: no commands\n", path);
+        return -1;
+    }
+
+    const char *base = strrchr(path, '/');
+    char *name = strdup((base != NULL) ? base + 1 : path);
+    char *dot = strrchr(name, '.');
+    if (dot != NULL)
+    {
+        *dot = '\0';
+    }
+    c->name = name;
+    return 0;
+}
+
+/**
+ * @brief  Execute one corpus line the configured way (raw bytes always take the RX path).
+ */
+static void bench_execute(const char *cmd, uint16_t raw_len)
+{
+    if (raw_len != 0U)
+    {
+        for (uint16_t i = 0; i < raw_len; i++)
+        {
+            bench_usart_rx(cmd[i]);
+        }
+    }
+    else if (!bench_rx_mode)
+    {
+        process_cmd(cmd);
+        return;
+    }
+    else
+    {
+        for (const char *p = cmd; *p != '\0'; p++)
+        {
+            bench_usart_rx(*p);
+        }
+        bench_usart_rx('\r');
+    }
+    while (event_loop_dispatch_one() != 0)
+    {
+        // Drain everything the line posted
+    }
+}
+
+/**
+ * @brief  Replay a corpus (thread entry).
+ */
+static void *bench_replay(void *arg)
+{
+    Bench_Corpus_t *c = arg;
+    volatile uint32_t entry_marker = 0;
+    Bench_Sink_t *sink = bench_sink();
+
+    for (uint32_t i = 0; i < c->count; i++) // Warm-up pass
+    {
+        bench_execute(c->lines[i], c->raw_len[i]);
+        (void)bench_hw_service();
+    }
+
+    uint64_t bytes = sink->bytes;
+    uint32_t errors = sink->errors;
+    uint32_t n = 0;
+
+    bench_alloc_calls = 0;
+    bench_alloc_armed = 1;
+    for (uint32_t it = 0; it < bench_iterations; it++)
+    {
+        for (uint32_t i = 0; i < c->count; i++)
+        {
+            uint64_t t0 = bench_now_ns();
+            bench_execute(c->lines[i], c->raw_len[i]);
+            uint64_t t1 = bench_now_ns();
+            c->dma_isr_calls += bench_hw_service();
+            uint64_t t2 = bench_now_ns();
+
+            c->samples[n++] = (uint32_t)(t1 - t0);
+            c->total_ns += t1 - t0;
+            c->dma_ns += t2 - t1;
+        }
+    }
+    bench_alloc_armed = 0;
+
+    c->allocations = bench_alloc_calls;
+    c->tx_bytes = sink->bytes - bytes;
+    c->errors = (sink->errors - errors) / bench_iterations;
+    c->stack_entry = (uintptr_t)&entry_marker;
+    return NULL;
+}
+
+/**
+ * @brief  Sort helper for the latency percentiles.
+ */
+static int bench_cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  Run one corpus on a thread with a painted stack.
+ * @retval 0 on success, -1 on error
+ */
+static int bench_run(Bench_Corpus_t *c)
+{
+    c->samples = malloc(sizeof(uint32_t) * (size_t)c->count * bench_iterations);
+    uint32_t *stack = mmap(NULL, BENCH_STACK_BYTES, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (c->samples == NULL || stack == MAP_FAILED)
+    {
+        fprintf(stderr, "bench: out of memory\n");
+        return -1;
+    }
+    for (uint32_t i = 0; i < BENCH_STACK_BYTES / 4U; i++)
+    {
+        stack[i] = BENCH_PAINT_WORD;
+    }
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, BENCH_STACK_BYTES);
+    if (pthread_create(&thread, &attr, bench_replay, c) != 0)
+    {
+        fprintf(stderr, "bench: cannot start the replay thread\n");
+        return -1;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    uint32_t untouched = 0;
+    while (untouched < BENCH_STACK_BYTES / 4U && stack[untouched] == BENCH_PAINT_WORD)
+    {
+        untouched++;
+    }
+    uintptr_t deepest = (uintptr_t)&stack[untouched];
+    c->stack_peak = (c->stack_entry > deepest) ? (uint32_t)(c->stack_entry - deepest) : 0U;
+
+    munmap(stack, BENCH_STACK_BYTES);
+    qsort(c->samples, (size_t)c->count * bench_iterations, sizeof(uint32_t), bench_cmp_u32);
+    return 0;
+}
+
+/**
+ * @brief  Write the results of every corpus as JSON.
+ */
+static void bench_report(FILE *out, Bench_Corpus_t *corpora, uint32_t count)
+{
+    fprintf(out, "{\n  \"harness\": \"process_cmd\",\n  \"format\": 1,\n");
+    fprintf(out, "  \"mode\": \"%s\",\n", bench_rx_mode ? "rx" : "line");
+    fprintf(out, "  \"iterations\": %u,\n  \"corpora\": [\n", bench_iterations);
+
+    for (uint32_t k = 0; k < count; k++)
+    {
+        Bench_Corpus_t *c = &corpora[k];
+        uint64_t runs = (uint64_t)c->count * bench_iterations;
+        double mean = (double)c->total_ns / (double)runs;
+
+        fprintf(out, "    {\n      \"name\": \"%s\",\n", c->name);
+        fprintf(out, "      \"commands\": %u,\n", c->count);
+        fprintf(out, "      \"runs\": %llu,\n", (unsigned long long)runs);
+        fprintf(out, "      \"cmds_per_sec\": %.0f,\n", 1e9 / mean);
+        fprintf(out, "      \"ns_per_cmd\": {\"mean\": %.1f, \"p50\": %u, \"p90\": %u, "
+                     "\"p99\": %u, \"max\": %u},\n",
+                mean, c->samples[runs / 2U], c->samples[runs * 9U / 10U],
+                c->samples[runs * 99U / 100U], c->samples[runs - 1U]);
+        fprintf(out, "      \"dma_service_ns_per_cmd\": %.1f,\n", (double)c->dma_ns / (double)runs);
+        fprintf(out, "      \"dma_isr_calls_per_cmd\": %.2f,\n",
+                (double)c->dma_isr_calls / (double)runs);
+        fprintf(out, "      \"tx_bytes_per_cmd\": %.2f,\n", (double)c->tx_bytes / (double)runs);
+        fprintf(out, "      \"error_responses\": %u,\n", c->errors);
+        fprintf(out, "      \"allocations\": %llu,\n", (unsigned long long)c->allocations);
+        fprintf(out, "      \"stack_peak_bytes\": %u\n", c->stack_peak);
+        fprintf(out, "    }%s\n", (k + 1U < count) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/*******************************************************************************************
+ *                                      Entry Point
+ *******************************************************************************************/
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:rvo:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            bench_iterations = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            bench_rx_mode = 1;
+            break;
+        case 'v':
+            bench_sink_echo(1);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            optind = argc + 1; // Usage error
+            break;
+        }
+    }
+    if (optind >= argc || bench_iterations == 0U)
+    {
+        fprintf(stderr, "usage: %s [-n iterations] [-r] [-v] [-o results.json] corpus.txt ...\n",
+                argv[0]);
+        return 2;
+    }
+
+    if (bench_hw_map() != 0)
+    {
+        return 1;
+    }
+
+    // Same bring-up as main(), minus the kernel and the fault/stack guards
+    bare_dwt_init();
+    mem_init();
+    fx_init();
+    event_loop_init();
+    led1_init();
+    led2_init();
+    anim_init();
+    ws2812_init();
+    apa102_init();
+    usart_terminal_init();
+    terminal_start();
+
+    uint32_t count = (uint32_t)(argc - optind);
+    Bench_Corpus_t *corpora = calloc(count, sizeof(Bench_Corpus_t));
+    if (corpora == NULL)
+    {
+        return 1;
+    }
+    for (uint32_t k = 0; k < count; k++)
+    {
+        if (bench_load(&corpora[k], argv[optind + (int)k]) != 0 || bench_run(&corpora[k]) != 0)
+        {
+            return 1;
+        }
+    }
+
+    FILE *out = (out_path != NULL) ? fopen(out_path, "w") : stdout;
+    if (out == NULL)
+    {
+        perror(out_path);
+        return 1;
+    }
+    bench_report(out, corpora, count);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return 0;
+}
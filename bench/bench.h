@@ -0,0 +1,83 @@
+/*******************************************************************************************
+ * @file    bench.h
+ * @author  ka5j
+ * @brief   Host benchmark harness: register model and terminal sink
+ * @version 1.0
+ * @date    2025-06-24
+ *
+ * @details
+ * The firmware is compiled for the host with HOST_BUILD. Peripheral pointers stay the
+ * fixed addresses of the register headers; bench_hw_map() backs those address ranges with
+ * zeroed memory so every register access lands in an ordinary page. Status bits the
+ * drivers poll are preset, and bench_hw_service() plays the DMA hardware by raising the
+ * completion flags and calling the stream ISRs until every transfer has finished.
+ *
+ * The USART driver is replaced by a sink that counts (and optionally echoes) the
+ * terminal output; the kernel, crash record and stack guard, which need the Cortex-M4,
+ * are replaced by inert stubs.
+ *******************************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Terminal output counters
+ */
+typedef struct
+{
+    uint64_t bytes;  /*!< Characters sent to the terminal                 */
+    uint32_t errors; /*!< Responses starting with "UNKNOWN" or "INVALID" */
+} Bench_Sink_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Back the peripheral and core register ranges with zeroed memory.
+ *
+ * @return 0 on success, -1 if a range cannot be mapped at its fixed address
+ */
+int bench_hw_map(void);
+
+/**
+ * @brief  Complete every running DMA transfer by calling the stream ISRs.
+ *
+ * @return Number of ISR calls made
+ */
+uint32_t bench_hw_service(void);
+
+/**
+ * @brief  Get the terminal output counters.
+ *
+ * @return Pointer to the counters
+ */
+Bench_Sink_t *bench_sink(void);
+
+/**
+ * @brief  Copy terminal output to stdout (0 = count only).
+ *
+ * @param  enable  1 to echo
+ */
+void bench_sink_echo(uint8_t enable);
+
+/**
+ * @brief  Run the first terminal's receive callback (USART2) as its ISR would.
+ *
+ * @param  c  Received character
+ */
+void bench_usart_rx(char c);
+
+/*******************************************************************************************
+ *                              Firmware Interrupt Handlers
+ *******************************************************************************************/
+void DMA1_Stream2_IRQHandler(void);
+void DMA2_Stream3_IRQHandler(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,115 @@
+/*******************************************************************************************
+ * @file    bench_hw.c
+ * @author  ka5j
+ * @brief   Host benchmark harness: register memory and DMA completion model
+ * @version 1.0
+ * @date    2025-06-24
+ *
+ * @details
+ * The register headers cast fixed addresses (0x4000xxxx, 0xE000xxxx) to register blocks.
+ * On a 64-bit Linux host those addresses are normally unmapped, so they are backed with
+ * anonymous pages at exactly the same addresses. Writes then simply stick, and a read
+ * returns the last value written, which is enough for everything the command path does.
+ *
+ * Bits that real hardware sets on its own and that drivers wait for are preset here
+ * (SPI1 TXE). DMA transfers are finished by bench_hw_service(): the stream's interrupt
+ * flags are raised and its ISR called until the driver reports idle, the way the
+ * transfer would complete between two commands on the board.
+ *******************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include "bench.h"
+#include "stm32f446re_addresses.h" // Register ranges to back
+#include "dma_registers.h"         // DMA flags
+#include "spi_registers.h"         // SPI1 status register
+#include "ws2812.h"                // ws2812_busy()
+#include "bare_spi.h"              // bare_spi_busy()
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define HW_PERIPH_SIZE 0x30000UL  /*!< APB1, APB2 and AHB1 up to the DMA controllers */
+#define HW_CORE_SIZE 0x100000UL   /*!< Cortex-M4 private peripheral bus              */
+#define HW_SPI_SR_TXE (1U << 1)   /*!< SPI1 transmit buffer empty                    */
+#define HW_MAX_ISR_CALLS 100000U  /*!< Bound on one service pass (a stuck driver)    */
+
+#define WS_STREAM_SHIFT DMA_FLAG_SHIFT(2UL)  /*!< DMA1 Stream 2, WS2812    */
+#define SPI_STREAM_SHIFT DMA_FLAG_SHIFT(3UL) /*!< DMA2 Stream 3, SPI1_TX   */
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Map zeroed memory at a fixed address.
+ * @param  base: first address of the range
+ * @param  size: bytes
+ * @retval 0 on success, -1 if the range is taken or cannot be mapped
+ */
+static int hw_map_range(uintptr_t base, size_t size)
+{
+    void *p = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p == MAP_FAILED || (uintptr_t)p != base)
+    {
+        fprintf(stderr, "bench: cannot map registers at 0x%08lx\n", (unsigned long)base);
+        return -1;
+    }
+    return 0;
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Back the peripheral and core register ranges with zeroed memory.
+ * @retval 0 on success, -1 on failure
+ */
+int bench_hw_map(void)
+{
+    if (hw_map_range(APB1PERIPH_BASE, HW_PERIPH_SIZE) != 0 ||
+        hw_map_range(CORTEX_M4_PERIPH_BASE, HW_CORE_SIZE) != 0)
+    {
+        return -1;
+    }
+
+    SPI1->SR = HW_SPI_SR_TXE; // Idle bus: TXE set, BSY clear
+    return 0;
+}
+
+/**
+ * @brief  Complete every running DMA transfer.
+ *
+ * @details
+ * WS2812: half-transfer and transfer-complete alternate, as in circular mode, until the
+ * latch time has been sent. APA102: transfer complete, which chains the end frame.
+ *
+ * @retval Number of ISR calls made
+ */
+uint32_t bench_hw_service(void)
+{
+    uint32_t calls = 0;
+
+    for (uint32_t half = 0; ws2812_busy() && calls < HW_MAX_ISR_CALLS; half ^= 1U)
+    {
+        DMA1->LISR = (half ? DMA_FLAG_TCIF : DMA_FLAG_HTIF) << WS_STREAM_SHIFT;
+        DMA1_Stream2_IRQHandler();
+        calls++;
+    }
+    DMA1->LISR = 0;
+
+    while (bare_spi_busy() && calls < HW_MAX_ISR_CALLS)
+    {
+        DMA2->LISR = DMA_FLAG_TCIF << SPI_STREAM_SHIFT;
+        DMA2_Stream3_IRQHandler();
+        calls++;
+    }
+    DMA2->LISR = 0;
+
+    return calls;
+}
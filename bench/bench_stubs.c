@@ -0,0 +1,357 @@
+/*******************************************************************************************
+ * @file    bench_stubs.c
+ * @author  ka5j
+ * @brief   Host benchmark harness: terminal sink and Cortex-M4-only module stubs
+ * @version 1.0
+ * @date    2025-06-24
+ *
+ * @details
+ * Replaces bare_usart.c with a sink that counts the terminal output, so the harness sees
+ * exactly what the board would transmit. kernel.c, crash.c and stack_check.c use core
+ * registers, exception entry and linker symbols that only exist on the target; the few
+ * functions the command path calls return "nothing to report" here.
+ *******************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "bare_usart.h"  // Replaced: terminal sink
+#include "fmt.h"         // Formatted output into the sink
+#include "kernel.h"      // Replaced: task list
+#include "crash.h"       // Replaced: crash record
+#include "stack_check.h" // Replaced: stack high-water marks
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define SINK_FMT_CHUNK 64U /*!< Formatted output is handed to the sink in chunks */
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Bench_Sink_t sink;
+static uint8_t sink_echo;
+static Bare_USART_t *sink_rx_usart; // First terminal switched to interrupts
+static Bare_USART_t *sink_console;
+static uint8_t sink_fmt_first; // Next chunk starts a formatted response
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Hand a formatted chunk to the sink, counting error responses like write_string.
+ */
+static uint32_t sink_fmt_more(Fmt_Out_t *out)
+{
+    const char *chunk = (const char *)out->buf;
+    if (sink_fmt_first && out->pos >= 8U &&
+        (strncmp(chunk, "\nUNKNOWN", 8) == 0 || strncmp(chunk, "\nINVALID", 8) == 0))
+    {
+        sink.errors++;
+    }
+    sink_fmt_first = 0;
+    for (uint32_t i = 0; i < out->pos; i++)
+    {
+        bare_usart_write_char((Bare_USART_t *)out->context, chunk[i]);
+    }
+    out->pos = 0;
+    return SINK_FMT_CHUNK;
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Get the terminal output counters.
+ * @retval Pointer to the counters
+ */
+Bench_Sink_t *bench_sink(void)
+{
+    return &sink;
+}
+
+/**
+ * @brief  Copy terminal output to stdout.
+ * @param  enable: 1 to echo
+ */
+void bench_sink_echo(uint8_t enable)
+{
+    sink_echo = enable;
+}
+
+/**
+ * @brief  Run the first terminal's receive callback as its ISR would.
+ * @param  c: received character
+ */
+void bench_usart_rx(char c)
+{
+    if (sink_rx_usart != NULL && sink_rx_usart->rx_callback != NULL)
+    {
+        sink_rx_usart->rx_callback(sink_rx_usart->context, c);
+    }
+}
+
+/*******************************************************************************************
+ *                                 USART Terminal Sink
+ *******************************************************************************************/
+
+int bare_usart_open(Bare_USART_t *usart, const Bare_USART_Config_t *cfg)
+{
+    usart->regs = cfg->regs; // Never dereferenced here, marks the handle open
+    usart->baud = cfg->baud;
+    return 0;
+}
+
+void bare_usart_enable_interrupts(Bare_USART_t *usart, bare_usart_rx_callback_t rx_cb,
+                                  bare_usart_tx_done_callback_t tx_done_cb, void *context)
+{
+    usart->rx_callback = rx_cb;
+    usart->tx_done_callback = tx_done_cb; // The sink never has anything pending
+    usart->context = context;
+    usart->irq_mode = 1;
+    if (sink_rx_usart == NULL)
+    {
+        sink_rx_usart = usart;
+    }
+}
+
+int bare_usart_set_baud(Bare_USART_t *usart, uint32_t baud)
+{
+    usart->baud = baud;
+    return 0;
+}
+
+uint32_t bare_usart_actual_baud(uint32_t baud)
+{
+    return baud; // The sink runs at any rate
+}
+
+void bare_usart_flush(Bare_USART_t *usart)
+{
+    (void)usart;
+}
+
+void bare_usart_autobaud(Bare_USART_t *usart)
+{
+    (void)usart;
+}
+
+void bare_usart_write_char(Bare_USART_t *usart, char c)
+{
+    (void)usart; // Every terminal feeds the same sink
+    sink.bytes++;
+    if (sink_echo)
+    {
+        putchar(c);
+    }
+}
+
+void bare_usart_write_string(Bare_USART_t *usart, const char *str)
+{
+    if (strncmp(str, "\nUNKNOWN", 8) == 0 || strncmp(str, "\nINVALID", 8) == 0)
+    {
+        sink.errors++;
+    }
+    while (*str)
+    {
+        bare_usart_write_char(usart, *str++);
+    }
+}
+
+uint32_t bare_usart_write_vfmt(Bare_USART_t *usart, const char *fmt, va_list ap)
+{
+    uint8_t chunk[SINK_FMT_CHUNK];
+    Fmt_Out_t out = {chunk, FMT_LINEAR, 0, SINK_FMT_CHUNK, sink_fmt_more, usart, 0};
+
+    sink_fmt_first = 1;
+    uint32_t n = fmt_vprint(&out, fmt, ap);
+    (void)sink_fmt_more(&out);
+    return n;
+}
+
+uint32_t bare_usart_write_fmt(Bare_USART_t *usart, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    uint32_t n = bare_usart_write_vfmt(usart, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+void bare_usart_tx_hold(Bare_USART_t *usart)
+{
+    (void)usart; // The sink has no transmission to delay
+}
+
+void bare_usart_tx_release(Bare_USART_t *usart)
+{
+    (void)usart;
+}
+
+char bare_usart_read(Bare_USART_t *usart)
+{
+    (void)usart;
+    return '\r';
+}
+
+uint16_t bare_usart_tx_high_water(const Bare_USART_t *usart)
+{
+    (void)usart;
+    return 0;
+}
+
+void bare_usart_set_console(Bare_USART_t *usart)
+{
+    sink_console = usart;
+}
+
+Bare_USART_t *bare_usart_get_console(void)
+{
+    return sink_console;
+}
+
+void bare_usart_send_char(char c)
+{
+    if (sink_console != NULL) // No console: output discarded, as on the board
+    {
+        bare_usart_write_char(sink_console, c);
+    }
+}
+
+void bare_usart_send_string(const char *str)
+{
+    if (sink_console != NULL)
+    {
+        bare_usart_write_string(sink_console, str);
+    }
+}
+
+void bare_usart_send_uint(uint32_t value)
+{
+    char digits[10];
+    uint32_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+
+    while (count > 0U)
+    {
+        bare_usart_send_char(digits[--count]);
+    }
+}
+
+void bare_usart_send_hex32(uint32_t value)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    for (int32_t shift = 28; shift >= 0; shift -= 4)
+    {
+        bare_usart_send_char(hex[(value >> shift) & 0xFU]);
+    }
+}
+
+uint32_t bare_usart_send_fmt(const char *fmt, ...)
+{
+    if (sink_console == NULL)
+    {
+        return 0;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    uint32_t n = bare_usart_write_vfmt(sink_console, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+char bare_usart_read_char(void)
+{
+    return '\r';
+}
+
+void bare_usart_clear_screen(void)
+{
+}
+
+/*******************************************************************************************
+ *                              Kernel, Crash, Stack Guard
+ *******************************************************************************************/
+
+const Kernel_TCB_t *kernel_get_task(uint32_t index)
+{
+    (void)index;
+    return NULL; // No tasks: the harness runs process_cmd() on its own thread
+}
+
+const Kernel_Stats_t *kernel_get_stats(void)
+{
+    static Kernel_Stats_t stats; // No context switches on the host
+    return &stats;
+}
+
+void crash_init(void)
+{
+}
+
+const Crash_Record_t *crash_get_record(void)
+{
+    return NULL;
+}
+
+void crash_report(void)
+{
+    bare_usart_send_string("\nNO CRASH RECORDED\r");
+}
+
+void crash_clear(void)
+{
+}
+
+void crash_test(void)
+{
+    // Never fault the host
+}
+
+void stack_check_init(void)
+{
+}
+
+void stack_check_guard_task(const uint32_t *base)
+{
+    (void)base;
+}
+
+void stack_check_paint(uint32_t *base, uint32_t words)
+{
+    for (uint32_t i = 0; i < words; i++)
+    {
+        base[i] = STACK_PAINT_WORD;
+    }
+}
+
+uint32_t stack_check_high_water(const uint32_t *base, uint32_t words)
+{
+    uint32_t untouched = 0;
+    while (untouched < words && base[untouched] == STACK_PAINT_WORD)
+    {
+        untouched++;
+    }
+    return (words - untouched) * 4U;
+}
+
+uint32_t stack_check_main_size(void)
+{
+    return 0;
+}
+
+uint32_t stack_check_main_high_water(void)
+{
+    return 0;
+}
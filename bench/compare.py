@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Compare two bench results files and fail on regressions.
+
+Usage:
+    compare.py [--threshold PCT] baseline.json current.json
+
+A corpus regresses when its median or mean ns per command, or its stack peak, grows by
+more than PCT percent (default 15), or when it makes more heap calls than before. A
+change in bytes sent or in error responses means the command output changed; it is
+reported but does not fail the check. Exit status is 1 on any regression.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        doc = json.load(f)
+    return doc, {c["name"]: c for c in doc["corpora"]}
+
+
+def grown(old, new, pct):
+    return old > 0 and (new - old) * 100.0 / old > pct
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--threshold", type=float, default=15.0)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    args = parser.parse_args()
+
+    base_doc, base = load(args.baseline)
+    cur_doc, cur = load(args.current)
+    if base_doc["mode"] != cur_doc["mode"]:
+        sys.exit("mode differs: %s vs %s" % (base_doc["mode"], cur_doc["mode"]))
+
+    failed = False
+    print("%-14s %10s %10s %8s  %s" % ("corpus", "p50 ns", "mean ns", "stack", "status"))
+    for name in sorted(cur):
+        c = cur[name]
+        if name not in base:
+            print("%-14s %10d %10.1f %8d  new" % (
+                name, c["ns_per_cmd"]["p50"], c["ns_per_cmd"]["mean"], c["stack_peak_bytes"]))
+            continue
+        b = base[name]
+        problems = []
+        for key in ("p50", "mean"):
+            if grown(b["ns_per_cmd"][key], c["ns_per_cmd"][key], args.threshold):
+                problems.append("%s %+.0f%%" % (key, (c["ns_per_cmd"][key] /
+                                                      b["ns_per_cmd"][key] - 1) * 100))
+        if grown(b["stack_peak_bytes"], c["stack_peak_bytes"], args.threshold):
+            problems.append("stack %d -> %d" % (b["stack_peak_bytes"], c["stack_peak_bytes"]))
+        if c["allocations"] > b["allocations"]:
+            problems.append("heap calls %d -> %d" % (b["allocations"], c["allocations"]))
+
+        notes = []
+        if abs(c["tx_bytes_per_cmd"] - b["tx_bytes_per_cmd"]) > 0.005:
+            notes.append("tx bytes %.2f -> %.2f" % (b["tx_bytes_per_cmd"], c["tx_bytes_per_cmd"]))
+        if c["error_responses"] != b["error_responses"]:
+            notes.append("errors %d -> %d" % (b["error_responses"], c["error_responses"]))
+
+        failed = failed or bool(problems)
+        status = "REGRESSION: " + ", ".join(problems) if problems else "ok"
+        if notes:
+            status += " (output changed: " + ", ".join(notes) + ")"
+        print("%-14s %10d %10.1f %8d  %s" % (
+            name, c["ns_per_cmd"]["p50"], c["ns_per_cmd"]["mean"], c["stack_peak_bytes"], status))
+
+    for name in sorted(set(base) - set(cur)):
+        print("%-14s missing from current run" % name)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
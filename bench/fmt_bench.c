@@ -0,0 +1,216 @@
+/*******************************************************************************************
+ * @file    fmt_bench.c
+ * @author  ka5j
+ * @brief   Host benchmark: fmt_snprint() against the C library's snprintf()
+ * @version 1.0
+ * @date    2025-07-02
+ *
+ * @details
+ * Usage: fmt_bench [-n iterations] [-o results.json]
+ *
+ * Every case is a format used by the terminal replies with representative arguments. The
+ * two outputs are compared first (a difference fails the run), then each formatter is
+ * timed over `iterations` calls into the same buffer. %q has no snprintf equivalent, so
+ * its case is timed against the "%d.%02d" the C library would need.
+ *
+ * Results are written as one JSON document (stdout by default). Host numbers are for
+ * comparing the two formatters and for regression tracking, not target cycle counts.
+ *******************************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fmt.h"
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define FMT_BENCH_DEFAULT_ITERATIONS 1000000U
+#define FMT_BENCH_BUFFER 128U
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief One format and the way both formatters print it
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t (*ours)(char *buf, uint32_t size);
+    int (*libc)(char *buf, size_t size);
+} Fmt_Bench_Case_t;
+
+/*******************************************************************************************
+ *                                  Benchmark Cases
+ *******************************************************************************************/
+
+/* volatile arguments keep the compiler from folding the calls */
+static volatile uint32_t arg_u = 115200U;
+static volatile int32_t arg_d = -1234;
+static volatile uint32_t arg_x = 0x08000000U;
+static const char *volatile arg_s = "USART2";
+
+static uint32_t ours_term(char *b, uint32_t n)
+{
+    return fmt_snprint(b, n, " %u BAUD CMDS %u TX BURSTS %u PEAK %u/%u", arg_u, 17U, 42U,
+                       96U, 255U);
+}
+static int libc_term(char *b, size_t n)
+{
+    return snprintf(b, n, " %u BAUD CMDS %u TX BURSTS %u PEAK %u/%u", arg_u, 17U, 42U, 96U,
+                    255U);
+}
+
+static uint32_t ours_hex(char *b, uint32_t n)
+{
+    return fmt_snprint(b, n, "\nIMAGE 0x%08X %u BYTES", arg_x, 40960U);
+}
+static int libc_hex(char *b, size_t n)
+{
+    return snprintf(b, n, "\nIMAGE 0x%08X %u BYTES", arg_x, 40960U);
+}
+
+static uint32_t ours_pad(char *b, uint32_t n)
+{
+    return fmt_snprint(b, n, "%-8s%5d %+d %04u", arg_s, arg_d, 7, 42U);
+}
+static int libc_pad(char *b, size_t n)
+{
+    return snprintf(b, n, "%-8s%5d %+d %04u", arg_s, arg_d, 7, 42U);
+}
+
+static uint32_t ours_short(char *b, uint32_t n)
+{
+    return fmt_snprint(b, n, "LED2 %u%%", 50U);
+}
+static int libc_short(char *b, size_t n)
+{
+    return snprintf(b, n, "LED2 %u%%", 50U);
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat"            // %q is not a printf conversion,
+#pragma GCC diagnostic ignored "-Wformat-extra-args" // so its argument looks unused
+static uint32_t ours_fixed(char *b, uint32_t n)
+{
+    return fmt_snprint(b, n, "%.2q", arg_d);
+}
+#pragma GCC diagnostic pop
+static int libc_fixed(char *b, size_t n)
+{
+    int32_t v = arg_d;
+    uint32_t mag = (v < 0) ? 0U - (uint32_t)v : (uint32_t)v;
+    return snprintf(b, n, "%s%u.%02u", (v < 0) ? "-" : "", mag / 100U, mag % 100U);
+}
+
+static const Fmt_Bench_Case_t cases[] = {
+    {"term_line", ours_term, libc_term},  {"hex_image", ours_hex, libc_hex},
+    {"padding", ours_pad, libc_pad},      {"short", ours_short, libc_short},
+    {"fixed_point", ours_fixed, libc_fixed},
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Monotonic time in nanoseconds.
+ */
+static uint64_t fmt_bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*******************************************************************************************
+ *                                      Entry Point
+ *******************************************************************************************/
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = FMT_BENCH_DEFAULT_ITERATIONS;
+    const char *out_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            iterations = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        default:
+            iterations = 0; // Usage error
+            break;
+        }
+    }
+    if (optind != argc || iterations == 0U)
+    {
+        fprintf(stderr, "usage: %s [-n iterations] [-o results.json]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *out = (out_path != NULL) ? fopen(out_path, "w") : stdout;
+    if (out == NULL)
+    {
+        perror(out_path);
+        return 1;
+    }
+
+    char a[FMT_BENCH_BUFFER];
+    char b[FMT_BENCH_BUFFER];
+    uint32_t count = sizeof(cases) / sizeof(cases[0]);
+    int status = 0;
+
+    fprintf(out, "{\n  \"harness\": \"fmt\",\n  \"format\": 1,\n");
+    fprintf(out, "  \"iterations\": %u,\n  \"cases\": [\n", iterations);
+    for (uint32_t k = 0; k < count; k++)
+    {
+        const Fmt_Bench_Case_t *c = &cases[k];
+
+        uint32_t len = c->ours(a, sizeof(a));
+        int libc_len = c->libc(b, sizeof(b));
+        if (strcmp(a, b) != 0 || (int)len != libc_len)
+        {
+            fprintf(stderr, "fmt_bench: %s: \"%s\" (%u) != \"%s\" (%d)\n", c->name, a, len, b,
+                    libc_len);
+            status = 1;
+        }
+
+        uint64_t t0 = fmt_bench_now_ns();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            (void)c->ours(a, sizeof(a));
+        }
+        uint64_t t1 = fmt_bench_now_ns();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            (void)c->libc(b, sizeof(b));
+        }
+        uint64_t t2 = fmt_bench_now_ns();
+
+        double ours_ns = (double)(t1 - t0) / (double)iterations;
+        double libc_ns = (double)(t2 - t1) / (double)iterations;
+        fprintf(out, "    {\"name\": \"%s\", \"bytes\": %u, \"fmt_ns\": %.1f, "
+                     "\"snprintf_ns\": %.1f, \"speedup\": %.2f}%s\n",
+                c->name, len, ours_ns, libc_ns, libc_ns / ours_ns, (k + 1U < count) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return status;
+}
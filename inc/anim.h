@@ -0,0 +1,141 @@
+/*******************************************************************************************
+ * @file    anim.h
+ * @author  ka5j
+ * @brief   Keyframe animation engine with incremental fixed-point evaluation
+ * @version 1.0
+ * @date    2025-06-11
+ *
+ * @details
+ * A curve is a looping list of keyframes (time in ms, level in permille). anim_start()
+ * compiles it once into a table of linear segments holding a Q8.24 start level, a Q8.24
+ * per-tick delta and a step count. The TIM2 update ISR (1 kHz) then advances every active
+ * channel with a single add per tick; the curve is never re-evaluated.
+ *******************************************************************************************/
+
+#ifndef ANIM_H_
+#define ANIM_H_
+
+#include <stdint.h>
+
+#include "led_output.h"
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define ANIM_MAX_KEYFRAMES 8U /*!< Keyframes per curve (segments per channel) */
+#define ANIM_LEVEL_MAX 1000U  /*!< Full brightness in keyframe units (permille) */
+#define ANIM_TICK_HZ 1000U    /*!< TIM2 update rate, 1 tick = 1 ms */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Built-in curves
+ */
+typedef enum
+{
+    ANIM_CURVE_CUSTOM = 0U,    /*!< User keyframes                       */
+    ANIM_CURVE_BREATHE = 1U,   /*!< Triangle 0 -> 100 % -> 0             */
+    ANIM_CURVE_STROBE = 2U,    /*!< 100 % for 5 % of the period          */
+    ANIM_CURVE_HEARTBEAT = 3U, /*!< Double pulse then rest               */
+    ANIM_CURVE_COUNT
+} Anim_Curve_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Keyframe (the first keyframe must be at t = 0, the last one closes the loop)
+ */
+typedef struct
+{
+    uint16_t time_ms; /*!< Time since the start of the loop */
+    uint16_t level;   /*!< Brightness 0 - ANIM_LEVEL_MAX     */
+} Anim_Keyframe_t;
+
+/**
+ * @brief Snapshot of one channel for status reporting
+ */
+typedef struct
+{
+    uint8_t active;   /*!< Channel is animating          */
+    uint8_t curve;    /*!< Anim_Curve_t                  */
+    uint8_t segment;  /*!< Current segment index         */
+    uint8_t segments; /*!< Number of compiled segments   */
+    uint16_t level;   /*!< Current level (permille)      */
+} Anim_ChannelInfo_t;
+
+/**
+ * @brief Cost of the TIM2 animation tick, in DWT cycles
+ */
+typedef struct
+{
+    uint32_t last_cycles;        /*!< Whole tick, last run           */
+    uint32_t max_cycles;         /*!< Whole tick, worst case         */
+    uint32_t active_channels;    /*!< Channels advanced in last tick */
+    uint32_t cycles_per_channel; /*!< last_cycles / active_channels  */
+} Anim_Stats_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Start the TIM2 animation time base (1 kHz update interrupt).
+ */
+void anim_init(void);
+
+/**
+ * @brief  Compile keyframes and start animating an output.
+ *
+ * @param  out    Output to drive
+ * @param  curve  Curve id recorded for status (ANIM_CURVE_CUSTOM for user keyframes)
+ * @param  keys   Keyframes, strictly starting at t = 0 with non-decreasing times
+ * @param  count  Number of keyframes (2 - ANIM_MAX_KEYFRAMES)
+ * @return 0 on success, -1 if the keyframes are invalid
+ */
+int anim_start(LED_Output_t out, Anim_Curve_t curve, const Anim_Keyframe_t *keys, uint32_t count);
+
+/**
+ * @brief  Start a built-in curve.
+ *
+ * @param  out        Output to drive
+ * @param  curve      Built-in curve (not ANIM_CURVE_CUSTOM)
+ * @param  period_ms  Loop period (20 - 65535 ms)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int anim_start_preset(LED_Output_t out, Anim_Curve_t curve, uint16_t period_ms);
+
+/**
+ * @brief  Stop animating an output (the output keeps its last level).
+ *
+ * @param  out  Output to release
+ */
+void anim_stop(LED_Output_t out);
+
+/**
+ * @brief  Read the state of a channel.
+ *
+ * @param  out   Output
+ * @param  info  Filled with the channel state
+ */
+void anim_get_info(LED_Output_t out, Anim_ChannelInfo_t *info);
+
+/**
+ * @brief  Get the per-tick cost statistics.
+ *
+ * @return Pointer to the statistics record
+ */
+const Anim_Stats_t *anim_get_stats(void);
+
+/**
+ * @brief  Get the printable name of a curve.
+ *
+ * @param  curve  Curve id
+ * @return Upper-case curve name
+ */
+const char *anim_curve_name(Anim_Curve_t curve);
+
+#endif /* ANIM_H_ */
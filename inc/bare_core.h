@@ -0,0 +1,156 @@
+/*******************************************************************************************
+ * @file    bare_core.h
+ * @author  ka5j
+ * @brief   Cortex-M4 core instruction wrappers (bare metal)
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @note    Thin inline wrappers around the few core instructions the drivers need
+ *          (interrupt masking, sleep, barriers). Replaces the CMSIS intrinsics this
+ *          project does not use. HOST_BUILD has no interrupts: masking and barriers are
+ *          no-ops, BASEPRI reads back 0 and the code always runs in thread mode.
+ *******************************************************************************************/
+
+#ifndef BARE_CORE_H_
+#define BARE_CORE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ * Inline Core Functions
+ *******************************************************************************************/
+
+#ifdef HOST_BUILD
+
+static inline void bare_core_enable_irq(void)
+{
+}
+
+static inline void bare_core_disable_irq(void)
+{
+}
+
+static inline void bare_core_wfi(void)
+{
+}
+
+static inline uint32_t bare_core_get_basepri(void)
+{
+    return 0;
+}
+
+static inline void bare_core_set_basepri(uint32_t value)
+{
+    (void)value;
+}
+
+static inline void bare_core_set_basepri_max(uint32_t value)
+{
+    (void)value;
+}
+
+static inline uint32_t bare_core_get_ipsr(void)
+{
+    return 0;
+}
+
+static inline void bare_core_dsb(void)
+{
+}
+
+static inline void bare_core_isb(void)
+{
+}
+
+#else
+
+/**
+ * @brief Globally enable interrupts (clear PRIMASK).
+ */
+static inline void bare_core_enable_irq(void)
+{
+    __asm volatile("cpsie i" ::: "memory");
+}
+
+/**
+ * @brief Globally disable interrupts (set PRIMASK).
+ */
+static inline void bare_core_disable_irq(void)
+{
+    __asm volatile("cpsid i" ::: "memory");
+}
+
+/**
+ * @brief Sleep until the next interrupt becomes pending.
+ *
+ * @note  Wakes even while PRIMASK is set, which allows a race-free
+ *        "check, then sleep" sequence with interrupts disabled.
+ */
+static inline void bare_core_wfi(void)
+{
+    __asm volatile("wfi" ::: "memory");
+}
+
+/**
+ * @brief Read the BASEPRI register (0 = no priority masking).
+ *
+ * @return Current BASEPRI value
+ */
+static inline uint32_t bare_core_get_basepri(void)
+{
+    uint32_t value;
+    __asm volatile("mrs %0, basepri" : "=r"(value));
+    return value;
+}
+
+/**
+ * @brief Write the BASEPRI register unconditionally.
+ *
+ * @param value New BASEPRI value (0 disables masking)
+ */
+static inline void bare_core_set_basepri(uint32_t value)
+{
+    __asm volatile("msr basepri, %0" ::"r"(value) : "memory");
+}
+
+/**
+ * @brief Raise BASEPRI; the write is ignored if it would lower the current mask.
+ *
+ * @param value New BASEPRI value
+ */
+static inline void bare_core_set_basepri_max(uint32_t value)
+{
+    __asm volatile("msr basepri_max, %0" ::"r"(value) : "memory");
+}
+
+/**
+ * @brief Read the IPSR register (active exception number, 0 in thread mode).
+ *
+ * @return Exception number
+ */
+static inline uint32_t bare_core_get_ipsr(void)
+{
+    uint32_t value;
+    __asm volatile("mrs %0, ipsr" : "=r"(value));
+    return value;
+}
+
+/**
+ * @brief Data synchronization barrier.
+ */
+static inline void bare_core_dsb(void)
+{
+    __asm volatile("dsb" ::: "memory");
+}
+
+/**
+ * @brief Instruction synchronization barrier.
+ */
+static inline void bare_core_isb(void)
+{
+    __asm volatile("isb" ::: "memory");
+}
+
+#endif /* HOST_BUILD */
+
+#endif /* BARE_CORE_H_ */
@@ -0,0 +1,107 @@
+/*******************************************************************************************
+ * @file    bare_crc.h
+ * @author  ka5j
+ * @brief   Bare-metal CRC-32 driver for STM32F446RE (hardware unit, DMA feed)
+ * @version 1.0
+ * @date    2025-07-01
+ *
+ * @note    The CRC unit computes CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF, no
+ *          reflection, no final XOR) over 32-bit words, most significant byte first.
+ *
+ *          bare_crc_compute() gives the standard byte-stream CRC: the CPU byte-reverses
+ *          each word on its way to the unit (one REV) and finishes the last 1-3 bytes in
+ *          software. bare_crc_words() and bare_crc_words_dma() feed memory words as they
+ *          are, which is what the DMA can do without the CPU; tools/patch_crc.py uses that
+ *          convention for the flash image.
+ *
+ *          HOST_BUILD has no CRC unit: every function runs the table fallback and the DMA
+ *          variant completes before it returns.
+ *******************************************************************************************/
+
+#ifndef BARE_CRC_H_
+#define BARE_CRC_H_
+
+#include <stdint.h>
+
+#include "bare_dma.h" // DMA feed stream
+
+/*******************************************************************************************
+ * CRC Configuration Constants
+ *******************************************************************************************/
+#define BARE_CRC_INIT 0xFFFFFFFFUL              /*!< Start value of a CRC              */
+#define BARE_CRC_DMA_STREAM BARE_DMA2_STREAM1   /*!< Memory-to-memory feed (DMA2 only) */
+
+/*******************************************************************************************
+ * Callback Types
+ *******************************************************************************************/
+
+/**
+ * @brief Called from the DMA ISR when bare_crc_words_dma() has finished
+ *
+ * @param crc CRC of the words
+ * @param ok  0 if the transfer failed (bus error), crc is then meaningless
+ */
+typedef void (*bare_crc_callback_t)(uint32_t crc, uint8_t ok);
+
+/*******************************************************************************************
+ * API Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief Enable the CRC unit clock and claim BARE_CRC_DMA_STREAM
+ *
+ * The stream's interrupt priority is set by the caller (irq_priorities.h).
+ */
+void bare_crc_init(void);
+
+/**
+ * @brief CRC-32/MPEG-2 of a byte buffer (check value of "123456789": 0x0376E6E7)
+ *
+ * Runs on the unit, or in software while a DMA computation holds it. Thread context only.
+ *
+ * @param data Data (any alignment)
+ * @param len  Bytes
+ * @return uint32_t CRC
+ */
+uint32_t bare_crc_compute(const void *data, uint32_t len);
+
+/**
+ * @brief CRC of 32-bit words, each fed most significant byte first (the unit's order)
+ *
+ * @param words Word-aligned data
+ * @param count Words
+ * @return uint32_t CRC
+ */
+uint32_t bare_crc_words(const uint32_t *words, uint32_t count);
+
+/**
+ * @brief Compute bare_crc_words() with the DMA feeding the unit, asynchronously
+ *
+ * Transfers longer than BARE_DMA_MAX_ITEMS words are chained from the ISR. The unit is
+ * held until done_cb runs; bare_crc_compute() falls back to software meanwhile.
+ *
+ * @param words   Word-aligned data (flash or SRAM)
+ * @param count   Words
+ * @param done_cb Called from the DMA ISR with the result (may be NULL)
+ * @return int 0 on success, -1 if a computation is running or count is 0
+ */
+int bare_crc_words_dma(const uint32_t *words, uint32_t count, bare_crc_callback_t done_cb);
+
+/**
+ * @brief Check whether a bare_crc_words_dma() computation is running
+ *
+ * @return uint8_t 1 while the DMA feeds the unit
+ */
+uint8_t bare_crc_busy(void);
+
+/**
+ * @brief Continue a CRC-32/MPEG-2 over bytes in software (nibble table)
+ *
+ * @param crc  CRC so far (BARE_CRC_INIT to start)
+ * @param data Data
+ * @param len  Bytes
+ * @return uint32_t Updated CRC
+ */
+uint32_t bare_crc_sw_update(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#endif /* BARE_CRC_H_ */
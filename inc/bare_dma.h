@@ -0,0 +1,254 @@
+/*******************************************************************************************
+ * @file    bare_dma.h
+ * @author  ka5j
+ * @brief   Bare-metal DMA1/DMA2 stream driver for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-27
+ *
+ * @note    Streams are claimed by number: the request channel of a peripheral is fixed
+ *          by the DMA request mapping (RM0390 tables 28/29), so the driver only checks
+ *          that no two users share a stream. A claimed stream is configured once
+ *          (direction, widths, normal / circular / double-buffer mode, FIFO and bursts)
+ *          and then started as often as needed. The driver owns every DMAx_Streamy ISR:
+ *          it clears the stream's flags and hands them to the owner's callback.
+ *
+ *          bare_dma_memcpy() copies memory to memory on DMA2 (DMA1 cannot), using
+ *          BARE_DMA_COPY_STREAM, which no peripheral user may claim.
+ *******************************************************************************************/
+
+#ifndef BARE_DMA_H_
+#define BARE_DMA_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h" // Low-level register definitions
+#include "dma_registers.h"         // DMA register map and flags
+
+/*******************************************************************************************
+ * Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief DMA streams (controller * 8 + stream)
+ */
+typedef enum
+{
+    BARE_DMA1_STREAM0 = 0U,
+    BARE_DMA1_STREAM1,
+    BARE_DMA1_STREAM2,
+    BARE_DMA1_STREAM3,
+    BARE_DMA1_STREAM4,
+    BARE_DMA1_STREAM5,
+    BARE_DMA1_STREAM6,
+    BARE_DMA1_STREAM7,
+    BARE_DMA2_STREAM0,
+    BARE_DMA2_STREAM1,
+    BARE_DMA2_STREAM2,
+    BARE_DMA2_STREAM3,
+    BARE_DMA2_STREAM4,
+    BARE_DMA2_STREAM5,
+    BARE_DMA2_STREAM6,
+    BARE_DMA2_STREAM7,
+    BARE_DMA_STREAM_COUNT
+} Bare_DMA_Stream_t;
+
+/**
+ * @brief Transfer direction (PAR is the source of a memory-to-memory copy)
+ */
+typedef enum
+{
+    BARE_DMA_P2M = 0U, /*!< Peripheral to memory              */
+    BARE_DMA_M2P = 1U, /*!< Memory to peripheral              */
+    BARE_DMA_M2M = 2U  /*!< Memory to memory (DMA2, FIFO only) */
+} Bare_DMA_Dir_t;
+
+/**
+ * @brief Stream mode
+ */
+typedef enum
+{
+    BARE_DMA_NORMAL = 0U,   /*!< Stop after NDTR items                              */
+    BARE_DMA_CIRCULAR,      /*!< Restart at the buffer start, forever               */
+    BARE_DMA_DOUBLE_BUFFER  /*!< Alternate between two buffers (DBM), forever       */
+} Bare_DMA_Mode_t;
+
+/**
+ * @brief Item size on the peripheral or memory side
+ */
+typedef enum
+{
+    BARE_DMA_BYTE = 0U,
+    BARE_DMA_HALFWORD = 1U,
+    BARE_DMA_WORD = 2U
+} Bare_DMA_Width_t;
+
+/**
+ * @brief FIFO use: direct mode or the threshold that triggers a memory burst
+ */
+typedef enum
+{
+    BARE_DMA_FIFO_DIRECT = 0U,  /*!< No FIFO, one item per request */
+    BARE_DMA_FIFO_QUARTER,      /*!< 1/4 full (4 bytes)            */
+    BARE_DMA_FIFO_HALF,         /*!< 1/2 full (8 bytes)            */
+    BARE_DMA_FIFO_3QUARTERS,    /*!< 3/4 full (12 bytes)           */
+    BARE_DMA_FIFO_FULL          /*!< Full (16 bytes)               */
+} Bare_DMA_Fifo_t;
+
+/**
+ * @brief Burst length in items (needs the FIFO)
+ */
+typedef enum
+{
+    BARE_DMA_BURST_SINGLE = 0U,
+    BARE_DMA_BURST_INCR4 = 1U,
+    BARE_DMA_BURST_INCR8 = 2U,
+    BARE_DMA_BURST_INCR16 = 3U
+} Bare_DMA_Burst_t;
+
+/*******************************************************************************************
+ * Events (stream 0 flag positions, handed to the callback as they were raised)
+ *******************************************************************************************/
+#define BARE_DMA_EVT_HALF DMA_FLAG_HTIF                    /*!< First half transferred  */
+#define BARE_DMA_EVT_DONE DMA_FLAG_TCIF                    /*!< Last item transferred   */
+#define BARE_DMA_EVT_ERROR (DMA_FLAG_TEIF | DMA_FLAG_DMEIF) /*!< Bus or direct mode error */
+
+#define BARE_DMA_COPY_STREAM BARE_DMA2_STREAM0 /*!< Reserved for bare_dma_memcpy() */
+#define BARE_DMA_MAX_ITEMS 65535U              /*!< NDTR limit of one transfer      */
+
+/*******************************************************************************************
+ * Types
+ *******************************************************************************************/
+
+/**
+ * @brief Called from the stream ISR with the events that were raised (BARE_DMA_EVT_*)
+ *
+ * In circular mode EVT_DONE marks the end of each lap; in double-buffer mode the end of
+ * each buffer, bare_dma_current_target() then tells which buffer the stream moved on to.
+ * A transfer error (TEIF) also disables the stream in hardware.
+ */
+typedef void (*bare_dma_callback_t)(uint32_t events);
+
+/**
+ * @brief Stream configuration
+ */
+typedef struct
+{
+    uint8_t channel;          /*!< Request channel 0-7 (ignored for BARE_DMA_M2M)      */
+    Bare_DMA_Dir_t dir;       /*!< Direction                                           */
+    Bare_DMA_Mode_t mode;     /*!< Normal, circular or double-buffer                   */
+    Bare_DMA_Width_t psize;   /*!< Peripheral (or copy source) item size               */
+    Bare_DMA_Width_t msize;   /*!< Memory item size                                    */
+    uint8_t pinc;             /*!< 1 to increment the peripheral address               */
+    uint8_t minc;             /*!< 1 to increment the memory address                   */
+    uint8_t priority;         /*!< 0 low to 3 very high                                */
+    Bare_DMA_Fifo_t fifo;     /*!< Direct mode or FIFO threshold                       */
+    Bare_DMA_Burst_t pburst;  /*!< Peripheral burst (FIFO only)                        */
+    Bare_DMA_Burst_t mburst;  /*!< Memory burst (FIFO only)                            */
+    uint32_t events;          /*!< BARE_DMA_EVT_* to interrupt on (0 = no interrupt)   */
+} Bare_DMA_Config_t;
+
+/*******************************************************************************************
+ * API Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief Claim a stream, enable its controller clock and apply the configuration.
+ *
+ * The stream's NVIC interrupt is enabled when cfg->events is not 0; its priority is set
+ * by the caller (irq_priorities.h).
+ *
+ * @param stream   Stream
+ * @param cfg      Configuration (copied)
+ * @param callback Event callback (ISR context, may be NULL)
+ * @return int 0 on success, -1 if the stream is already claimed or the setup is invalid
+ *         (memory-to-memory on DMA1 or without FIFO, double buffer with memory-to-memory)
+ */
+int bare_dma_claim(Bare_DMA_Stream_t stream, const Bare_DMA_Config_t *cfg,
+                   bare_dma_callback_t callback);
+
+/**
+ * @brief Stop a stream and give it back.
+ *
+ * @param stream Stream
+ */
+void bare_dma_release(Bare_DMA_Stream_t stream);
+
+/**
+ * @brief Start a transfer on a claimed stream.
+ *
+ * Waits for a previous transfer to wind down, clears the stream's flags and enables it.
+ * In double-buffer mode mem1 is the second buffer; it is ignored otherwise.
+ *
+ * @param stream Stream
+ * @param periph Peripheral register (or copy source) address
+ * @param mem0   Memory buffer
+ * @param mem1   Second buffer (BARE_DMA_DOUBLE_BUFFER only)
+ * @param items  Items per transfer (per buffer in double-buffer mode), 1-65535
+ * @return int 0 on success, -1 if the stream is not claimed or items is 0
+ */
+int bare_dma_start(Bare_DMA_Stream_t stream, uint32_t periph, const void *mem0,
+                   const void *mem1, uint16_t items);
+
+/**
+ * @brief Disable a stream and wait until it has stopped.
+ *
+ * @param stream Stream
+ */
+void bare_dma_stop(Bare_DMA_Stream_t stream);
+
+/**
+ * @brief Check whether a stream is enabled.
+ *
+ * @param stream Stream
+ * @return uint8_t 1 while the stream runs
+ */
+uint8_t bare_dma_busy(Bare_DMA_Stream_t stream);
+
+/**
+ * @brief Get the number of items left in the current transfer (NDTR).
+ *
+ * @param stream Stream
+ * @return uint16_t Items left
+ */
+uint16_t bare_dma_remaining(Bare_DMA_Stream_t stream);
+
+/**
+ * @brief Get the buffer a double-buffer stream is working on.
+ *
+ * @param stream Stream
+ * @return uint8_t 0 for mem0, 1 for mem1 (the other one may be refilled)
+ */
+uint8_t bare_dma_current_target(Bare_DMA_Stream_t stream);
+
+/**
+ * @brief Point the idle buffer of a double-buffer stream elsewhere (while it runs).
+ *
+ * @param stream Stream
+ * @param target 0 for mem0, 1 for mem1; must not be the current target
+ * @param mem    New buffer
+ */
+void bare_dma_set_buffer(Bare_DMA_Stream_t stream, uint8_t target, const void *mem);
+
+/**
+ * @brief Copy memory with DMA2 (BARE_DMA_COPY_STREAM), asynchronously.
+ *
+ * Words are moved through the FIFO when both addresses and the length are word aligned,
+ * bytes otherwise; with 16-byte alignment the words go in INCR4 bursts. Copies longer than one transfer are chained from
+ * the ISR. Neither buffer may be touched until done_cb runs or bare_dma_copy_busy()
+ * returns 0.
+ *
+ * @param dst     Destination
+ * @param src     Source
+ * @param bytes   Bytes to copy
+ * @param done_cb Called from the ISR once the copy has finished (may be NULL)
+ * @return int 0 on success, -1 if a copy is running or bytes is 0
+ */
+int bare_dma_memcpy(void *dst, const void *src, uint32_t bytes, bare_dma_callback_t done_cb);
+
+/**
+ * @brief Check whether a bare_dma_memcpy() copy is running.
+ *
+ * @return uint8_t 1 while copying
+ */
+uint8_t bare_dma_copy_busy(void);
+
+#endif /* BARE_DMA_H_ */
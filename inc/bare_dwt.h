@@ -0,0 +1,51 @@
+/*******************************************************************************************
+ * @file    bare_dwt.h
+ * @author  ka5j
+ * @brief   Bare-metal DWT cycle counter driver for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @note    Provides a free-running CPU cycle counter used to time handlers, ISRs and
+ *          other code paths without relying on CMSIS. HOST_BUILD replaces the DWT with a
+ *          virtual counter that only moves through bare_dwt_host_advance(), so every
+ *          cycle statistic (trace, PERF) is deterministic on the host.
+ *******************************************************************************************/
+
+#ifndef BARE_DWT_H_
+#define BARE_DWT_H_
+
+#include "stm32f446re_addresses.h" // Low-level register definitions
+#include "dwt_registers.h"         // DWT / CoreDebug register map
+#include <stdint.h>                // Standard integer types
+
+/*******************************************************************************************
+ * DWT Configuration Constants
+ *******************************************************************************************/
+#define DWT_CPU_FREQ_HZ 16000000UL /*!< Core clock (HSI, no PLL) used to convert cycles */
+
+/*******************************************************************************************
+ * API Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief Enable the trace block and start the DWT cycle counter from zero.
+ */
+void bare_dwt_init(void);
+
+/**
+ * @brief Read the current value of the free-running cycle counter.
+ *
+ * @return uint32_t Cycle count (wraps every 2^32 cycles, ~268 s at 16 MHz)
+ */
+uint32_t bare_dwt_get_cycles(void);
+
+#ifdef HOST_BUILD
+/**
+ * @brief Advance the virtual cycle counter that replaces the DWT on host builds.
+ *
+ * @param cycles Simulated CPU cycles
+ */
+void bare_dwt_host_advance(uint32_t cycles);
+#endif
+
+#endif /* BARE_DWT_H_ */
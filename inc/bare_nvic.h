@@ -0,0 +1,166 @@
+/*******************************************************************************************
+ * @file    bare_nvic.h
+ * @author  ka5j
+ * @brief   Bare-metal NVIC priority / enable driver and BASEPRI critical sections
+ * @version 1.0
+ * @date    2025-06-09
+ *
+ * @note    Priorities are given as logical levels 0-15 (0 = most urgent) and shifted into
+ *          the 4 implemented upper bits of the priority registers by the driver.
+ *******************************************************************************************/
+
+#ifndef BARE_NVIC_H_
+#define BARE_NVIC_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h" // Low-level register definitions
+#include "nvic_registers.h"        // NVIC register map
+#include "scb_registers.h"         // SHPR / AIRCR
+#include "bare_core.h"             // BASEPRI access
+
+/*******************************************************************************************
+ * NVIC Configuration Constants
+ *******************************************************************************************/
+#define NVIC_PRIO_BITS 4U /*!< Priority bits implemented by the STM32F446 */
+
+/*******************************************************************************************
+ * Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Interrupt numbers (negative values are Cortex-M4 system exceptions)
+ */
+typedef enum
+{
+    MEMMANAGE_IRQn = -12,
+    BUSFAULT_IRQn = -11,
+    USAGEFAULT_IRQn = -10,
+    SVCALL_IRQn = -5,
+    DEBUGMON_IRQn = -4,
+    PENDSV_IRQn = -2,
+    SYSTICK_IRQn = -1,
+    DMA1_STREAM0_IRQn = 11,
+    DMA1_STREAM1_IRQn = 12,
+    DMA1_STREAM2_IRQn = 13,
+    DMA1_STREAM3_IRQn = 14,
+    DMA1_STREAM4_IRQn = 15,
+    DMA1_STREAM5_IRQn = 16,
+    DMA1_STREAM6_IRQn = 17,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    TIM4_IRQn = 30,
+    SPI1_IRQn = 35,
+    SPI2_IRQn = 36,
+    USART1_IRQn = 37,
+    USART2_IRQn = 38,
+    USART3_IRQn = 39,
+    DMA1_STREAM7_IRQn = 47,
+    TIM5_IRQn = 50,
+    SPI3_IRQn = 51,
+    UART4_IRQn = 52,
+    UART5_IRQn = 53,
+    DMA2_STREAM0_IRQn = 56,
+    DMA2_STREAM1_IRQn = 57,
+    DMA2_STREAM2_IRQn = 58,
+    DMA2_STREAM3_IRQn = 59,
+    DMA2_STREAM4_IRQn = 60,
+    DMA2_STREAM5_IRQn = 68,
+    DMA2_STREAM6_IRQn = 69,
+    DMA2_STREAM7_IRQn = 70,
+    USART6_IRQn = 71
+} IRQn_t;
+
+/**
+ * @brief Priority grouping (preemption bits . sub-priority bits), AIRCR PRIGROUP value
+ */
+typedef enum
+{
+    NVIC_GROUP_4_0 = 3U, /*!< 16 preemption levels, no sub-priority */
+    NVIC_GROUP_3_1 = 4U, /*!< 8 preemption levels, 2 sub-priorities */
+    NVIC_GROUP_2_2 = 5U, /*!< 4 preemption levels, 4 sub-priorities */
+    NVIC_GROUP_1_3 = 6U, /*!< 2 preemption levels, 8 sub-priorities */
+    NVIC_GROUP_0_4 = 7U  /*!< No preemption, 16 sub-priorities      */
+} NVIC_Grouping_t;
+
+/*******************************************************************************************
+ * API Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief Select how the priority bits split into preemption and sub-priority.
+ *
+ * @param group Priority grouping
+ */
+void bare_nvic_set_priority_grouping(NVIC_Grouping_t group);
+
+/**
+ * @brief Combine a preemption level and a sub-priority for the current grouping.
+ *
+ * @param preempt Preemption level (0 = most urgent)
+ * @param sub     Sub-priority within the preemption level
+ * @return uint8_t Logical priority 0-15 for bare_nvic_set_priority()
+ */
+uint8_t bare_nvic_encode_priority(uint8_t preempt, uint8_t sub);
+
+/**
+ * @brief Set the priority of an interrupt or system exception.
+ *
+ * @param irqn     Interrupt number
+ * @param priority Logical priority 0-15 (0 = most urgent)
+ */
+void bare_nvic_set_priority(IRQn_t irqn, uint8_t priority);
+
+/**
+ * @brief Read back the priority of an interrupt or system exception.
+ *
+ * @param irqn Interrupt number
+ * @return uint8_t Logical priority 0-15
+ */
+uint8_t bare_nvic_get_priority(IRQn_t irqn);
+
+/**
+ * @brief Enable a device interrupt in the NVIC.
+ *
+ * @param irqn Interrupt number (>= 0)
+ */
+void bare_nvic_enable_irq(IRQn_t irqn);
+
+/**
+ * @brief Disable a device interrupt in the NVIC.
+ *
+ * @param irqn Interrupt number (>= 0)
+ */
+void bare_nvic_disable_irq(IRQn_t irqn);
+
+/*******************************************************************************************
+ * Critical Sections
+ *******************************************************************************************/
+
+/**
+ * @brief Enter a critical section that masks interrupts at priority ceiling and below.
+ *
+ * Interrupts more urgent than the ceiling keep running. Sections nest: an inner section
+ * with a lower ceiling never unmasks what an outer section masked (BASEPRI_MAX).
+ *
+ * @param ceiling Logical priority 1-15 (0 cannot be masked by BASEPRI)
+ * @return uint32_t State to hand back to bare_nvic_crit_exit()
+ */
+static inline uint32_t bare_nvic_crit_enter(uint8_t ceiling)
+{
+    uint32_t prev = bare_core_get_basepri();
+    bare_core_set_basepri_max((uint32_t)ceiling << (8U - NVIC_PRIO_BITS));
+    bare_core_isb();
+    return prev;
+}
+
+/**
+ * @brief Leave a critical section, restoring the mask that was active on entry.
+ *
+ * @param prev Value returned by the matching bare_nvic_crit_enter()
+ */
+static inline void bare_nvic_crit_exit(uint32_t prev)
+{
+    bare_core_set_basepri(prev);
+}
+
+#endif /* BARE_NVIC_H_ */
@@ -0,0 +1,99 @@
+/*******************************************************************************************
+ * @file    bare_spi.h
+ * @author  ka5j
+ * @brief   Bare-metal SPI1 transmit driver for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-14
+ *
+ * @note    Provides SPI1 master transmit (PA5 SCK / PA7 MOSI, AF5) without relying on STM32
+ *          HAL drivers. Uses one-line transmit-only mode (no MISO, no receive overrun),
+ *          mode 0, 8-bit MSB first. Transfers are sent by polling or by DMA2 Stream 3.
+ *******************************************************************************************/
+
+#ifndef BARE_SPI_H_
+#define BARE_SPI_H_
+
+#include "stm32f446re_addresses.h" // Include low-level register definitions
+#include "spi_registers.h"         // Include SPI register map
+#include "rcc_registers.h"         // Include RCC definitions for SPI clock enable
+#include <stdint.h>                // Include standard integer types
+
+/*******************************************************************************************
+ * SPI Configuration Constants
+ *******************************************************************************************/
+#define SPI_PCLK2_FREQ 16000000UL /*!< APB2 clock feeding SPI1 (Hz) */
+
+/*******************************************************************************************
+ * Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief SCK = PCLK2 / divider (CR1 BR field)
+ */
+typedef enum
+{
+    SPI_BAUD_DIV2 = 0U,  /*!< 8 MHz    */
+    SPI_BAUD_DIV4 = 1U,  /*!< 4 MHz    */
+    SPI_BAUD_DIV8 = 2U,  /*!< 2 MHz    */
+    SPI_BAUD_DIV16 = 3U, /*!< 1 MHz    */
+    SPI_BAUD_DIV32 = 4U, /*!< 500 kHz  */
+    SPI_BAUD_DIV64 = 5U, /*!< 250 kHz  */
+    SPI_BAUD_DIV128 = 6U, /*!< 125 kHz */
+    SPI_BAUD_DIV256 = 7U  /*!< 62.5 kHz */
+} SPI_BaudDiv_t;
+
+/*******************************************************************************************
+ * Callback Types
+ *******************************************************************************************/
+
+/**
+ * @brief Called from the DMA2 Stream 3 ISR once the last bit has left the shift register
+ */
+typedef void (*bare_spi_done_callback_t)(void);
+
+/*******************************************************************************************
+ * API Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief Initialize SPI1 as transmit-only master and prepare its TX DMA stream
+ *
+ * @param div SCK divider (SPI_BAUD_DIV2 gives 8 MHz)
+ */
+void bare_spi_init(SPI_BaudDiv_t div);
+
+/**
+ * @brief Change the SCK divider (waits for the current transfer to finish)
+ *
+ * @param div SCK divider
+ */
+void bare_spi_set_baud(SPI_BaudDiv_t div);
+
+/**
+ * @brief Send a single byte by polling
+ *
+ * @param data Byte to be transmitted
+ */
+void bare_spi_send_byte(uint8_t data);
+
+/**
+ * @brief Start a DMA transfer
+ *
+ * The buffer must stay unchanged until the done callback runs or bare_spi_busy()
+ * returns 0.
+ *
+ * @param data    Bytes to transmit
+ * @param len     Number of bytes (1-65535)
+ * @param done_cb Called from the ISR at the end of the transfer (may be NULL)
+ * @return int 0 on success, -1 if a transfer is already running
+ */
+int bare_spi_send_dma(const uint8_t *data, uint16_t len, bare_spi_done_callback_t done_cb);
+
+/**
+ * @brief Check whether a DMA transfer is running
+ *
+ * @return uint8_t 1 while busy, 0 otherwise
+ */
+uint8_t bare_spi_busy(void);
+
+#endif /* BARE_SPI_H_ */
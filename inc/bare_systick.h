@@ -19,6 +19,7 @@
  * SysTick Configuration Constants
  *******************************************************************************************/
 #define SYSTICK_1SEC_RELOAD_16MHZ 16000000U /*!< Reload value for 1s delay at 16 MHz */
+#define SYSTICK_1MS_RELOAD_16MHZ (SYSTICK_1SEC_RELOAD_16MHZ / 1000U) /*!< 1 ms tick at 16 MHz */
 
 /*******************************************************************************************
  * SysTick Control Enumerations
@@ -93,4 +94,16 @@ void SysTick_Init(uint32_t reload,
  */
 void SysTick_Set_TIMER(uint32_t reload);
 
+/**
+ * @brief Advance the system tick counter (call once per SysTick interrupt).
+ */
+void SysTick_Inc_Tick(void);
+
+/**
+ * @brief Read the number of SysTick interrupts since boot.
+ *
+ * @return uint32_t Tick count (1 tick = 1 ms with SYSTICK_1MS_RELOAD_16MHZ)
+ */
+uint32_t SysTick_Get_Ticks(void);
+
 #endif /* BARE_SYSTICK_H_ */
@@ -29,6 +29,10 @@
 // Auto-reload value for 1-second cycle at 1 kHz tick rate
 #define TIM2_5_1SEC_ARR 999U
 
+// DMA/interrupt enable register bits
+#define TIM2_5_DIER_UIE (1U << 0) // Update interrupt enable
+#define TIM2_5_DIER_UDE (1U << 8) // Update DMA request enable
+
 /*******************************************************************************************
  * Enumerations for Timer Control
  *******************************************************************************************/
@@ -92,6 +96,15 @@ void bare_tim2_5_stop(TIM2_5_TypeDef *TIMx);
  */
 void bare_tim2_5_PWM(TIM2_5_TypeDef *TIMx);
 
+/**
+ * @brief Set TIM2–TIM5 timer to PWM mode in channel 1 with a custom period
+ *
+ * @param TIMx Pointer to timer peripheral (e.g., TIM2, TIM3, etc.)
+ * @param psc Prescaler (timer clock = 16 MHz / (psc + 1))
+ * @param arr Auto-reload value (PWM period = arr + 1 timer ticks)
+ */
+void bare_tim2_5_PWM_init(TIM2_5_TypeDef *TIMx, uint32_t psc, uint32_t arr);
+
 /**
  * @brief Set duty cycle of TIM2–TIM5 timer in PWM mode
  *
@@ -100,4 +113,12 @@ void bare_tim2_5_PWM(TIM2_5_TypeDef *TIMx);
  */
 void bare_pwm_set_duty(TIM2_5_TypeDef *TIMx, uint8_t percent);
 
+/**
+ * @brief Set the raw channel 1 compare value of TIM2–TIM5 timer in PWM mode
+ *
+ * @param TIMx Pointer to timer peripheral (e.g., TIM2, TIM3, etc.)
+ * @param compare CCR1 value (0 to ARR + 1, ARR + 1 is 100 % duty)
+ */
+void bare_pwm_set_compare(TIM2_5_TypeDef *TIMx, uint32_t compare);
+
 #endif // BARE_TIM2_5_H_
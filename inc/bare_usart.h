@@ -2,11 +2,23 @@
  * @file    bare_usart.h
  * @author  ka5j
  * @brief   Bare-metal USART driver for STM32F446RE
- * @version 1.0
+ * @version 1.3
  * @date    2025-05-14
  *
  * @note    Provides high-level USART functionality without relying on STM32 HAL drivers.
- *          Includes basic TX/RX functions using memory-mapped registers.
+ *          Every USART1-USART6 instance is driven through a handle (BARE_USART_DEFINE)
+ *          holding its pins, baud rate, TX ring and callbacks. The bare_usart_send_*()
+ *          helpers write to the console: the handle selected by bare_usart_set_console(),
+ *          e.g. the terminal whose command is being executed.
+ *
+ *          The baud rate divider is computed at run time from USART_PCLK_FREQ: 16x
+ *          oversampling where the divider allows it, 8x (OVER8) above PCLK / 16, which
+ *          doubles the top rate to PCLK / 8. A rate is refused when the nearest divider is
+ *          more than BARE_USART_BAUD_TOLERANCE off.
+ *
+ *          bare_usart_write_fmt() formats (fmt.h) straight into the TX ring and publishes
+ *          the whole output at once. bare_usart_tx_hold() / bare_usart_tx_release() make
+ *          a reply written in several calls leave as one transmission.
  *******************************************************************************************/
 
 #ifndef BARE_USART_H_
@@ -15,43 +27,293 @@
 #include "stm32f446re_addresses.h" // Include low-level register definitions
 #include "usart_registers.h"       // Include USART register map
 #include "rcc_registers.h"         // Include RCC definitions for USART clock enable
+#include "gpio_registers.h"        // GPIO ports for the pin mapping
+#include "bare_gpio.h"             // Pin and alternate function enumerations
 #include <stdint.h>                // Include standard integer types
+#include <stdarg.h>                // va_list for bare_usart_write_vfmt()
+#include "fmt.h"                   // FMT_PRINTF format checking
+
+/*******************************************************************************************
+ * USART Configuration Constants
+ *******************************************************************************************/
+#define USART_TX_BUFFER_SIZE 256U /*!< Default transmit ring size in bytes (power of two) */
+#define USART_PCLK_FREQ 16000000UL /*!< APB1 and APB2 clock (HSI, no prescaler) in Hz     */
+#define BARE_USART_BAUD_TOLERANCE 25U /*!< Largest accepted baud rate error in permille     */
+#define BARE_USART_BAUD_MIN (USART_PCLK_FREQ / 0xFFFFUL + 1UL) /*!< Divider 0xFFFF (OVER16) */
+#define BARE_USART_BAUD_MAX (USART_PCLK_FREQ / 8UL)            /*!< Divider 8 (OVER8)       */
+#define BARE_USART_AUTOBAUD_CHAR '\r' /*!< Character the host sends during auto-baud       */
+
+/*******************************************************************************************
+ * Callback Types
+ *******************************************************************************************/
+
+/**
+ * @brief Called from the USART ISR for every received character
+ */
+typedef void (*bare_usart_rx_callback_t)(void *context, char c);
+
+/**
+ * @brief Called from the USART ISR once the transmit ring has fully drained
+ */
+typedef void (*bare_usart_tx_done_callback_t)(void *context);
+
+/*******************************************************************************************
+ * Types
+ *******************************************************************************************/
+
+/**
+ * @brief Instance, pin mapping and line settings for bare_usart_open()
+ */
+typedef struct
+{
+    USART_TypeDef *regs;   /*!< USART1-USART6                         */
+    GPIO_TypeDef *tx_port; /*!< TX pin port                           */
+    GPIO_Pins_t tx_pin;    /*!< TX pin                                */
+    GPIO_TypeDef *rx_port; /*!< RX pin port                           */
+    GPIO_Pins_t rx_pin;    /*!< RX pin                                */
+    GPIO_AFs_t af;         /*!< AF7 (USART1-3) or AF8 (UART4-USART6)  */
+    uint32_t baud;         /*!< Baud rate, 8N1                        */
+} Bare_USART_Config_t;
+
+/**
+ * @brief USART handle (define with BARE_USART_DEFINE)
+ */
+typedef struct
+{
+    const char *name;                             /*!< Label for the diagnostics         */
+    volatile uint8_t *tx_buffer;                  /*!< TX ring storage                   */
+    uint16_t tx_mask;                             /*!< TX ring size - 1                  */
+    volatile uint16_t tx_head;                    /*!< Written under CRIT_CEILING_TERMINAL */
+    volatile uint16_t tx_tail;                    /*!< Written by the ISR (or polling)   */
+    uint16_t tx_high_water;                       /*!< Deepest TX ring fill              */
+    volatile uint8_t irq_mode;                    /*!< 1 once interrupts are enabled     */
+    uint8_t index;                                /*!< Hardware instance 0-5             */
+    USART_TypeDef *regs;                          /*!< Registers, NULL until opened      */
+    uint32_t baud;                                /*!< Configured baud rate              */
+    bare_usart_rx_callback_t rx_callback;         /*!< ISR context                       */
+    bare_usart_tx_done_callback_t tx_done_callback; /*!< ISR context                     */
+    void *context;                                /*!< Handed to both callbacks          */
+    volatile uint8_t autobaud;                    /*!< Rate table entry + 1 while hunting */
+    uint32_t autobaud_tick;                       /*!< SysTick of the last rate step     */
+    uint8_t tx_hold;                              /*!< Nested bare_usart_tx_hold() calls */
+} Bare_USART_t;
+
+/**
+ * @brief  Define a USART handle with a TX ring of tx_size bytes (power of two).
+ */
+#define BARE_USART_DEFINE(var, label, tx_size)                                          \
+    _Static_assert(((tx_size) & ((tx_size) - 1U)) == 0U, "TX ring size not a power of two"); \
+    static volatile uint8_t var##_tx[(tx_size)];                                        \
+    static Bare_USART_t var = {(label), var##_tx, (uint16_t)((tx_size) - 1U), 0, 0, 0,  \
+                               0, 0, NULL, 0, NULL, NULL, NULL, 0, 0, 0}
 
 /*******************************************************************************************
  * API Function Prototypes
  *******************************************************************************************/
 
 /**
- * @brief Initialize USART peripheral with default configuration (9600 8N1)
+ * @brief Open a USART instance: clocks, pins, baud rate, TX and RX enabled (polling)
  *
- * This function enables USART2, configures baud rate, enables TX and RX,
- * and prepares the USART for basic serial communication.
+ * @param usart Handle
+ * @param cfg   Instance, pins and baud rate
+ * @return int 0 on success, -1 if cfg->regs is not a USART or the instance is taken
  */
-void bare_usart_init(void);
+int bare_usart_open(Bare_USART_t *usart, const Bare_USART_Config_t *cfg);
 
 /**
- * @brief Send a single character over USART
+ * @brief Switch a USART to interrupt-driven operation
+ *
+ * Enables the RXNE interrupt and the instance's IRQ in the NVIC. Received characters are
+ * handed to rx_cb from the ISR; tx_done_cb is called when the transmit ring empties.
+ * Either callback may be NULL. Once enabled, bare_usart_read() must not be used.
+ *
+ * @param usart      Handle
+ * @param rx_cb      Receive callback (ISR context)
+ * @param tx_done_cb Transmit complete callback (ISR context)
+ * @param context    Handed to both callbacks
+ */
+void bare_usart_enable_interrupts(Bare_USART_t *usart, bare_usart_rx_callback_t rx_cb,
+                                  bare_usart_tx_done_callback_t tx_done_cb, void *context);
+
+/**
+ * @brief Change the baud rate of an open USART
+ *
+ * The USART is briefly disabled: a character being sent or received is lost, so call
+ * bare_usart_flush() first when the last reply must arrive at the old rate. A running
+ * auto-baud hunt ends.
+ *
+ * @param usart Handle
+ * @param baud  New baud rate
+ * @return int 0 on success, -1 if the rate is out of range or tolerance (rate unchanged)
+ */
+int bare_usart_set_baud(Bare_USART_t *usart, uint32_t baud);
+
+/**
+ * @brief Get the rate the divider for a baud rate actually produces
+ *
+ * @param baud Requested baud rate
+ * @return uint32_t Actual baud rate, 0 if the request cannot be met within tolerance
+ */
+uint32_t bare_usart_actual_baud(uint32_t baud);
+
+/**
+ * @brief Wait until the TX ring is empty and the last stop bit has left the USART
+ *
+ * @param usart Handle
+ */
+void bare_usart_flush(Bare_USART_t *usart);
+
+/**
+ * @brief Detect the host's baud rate from the characters it sends
+ *
+ * The STM32F4 USART has no hardware auto-baud (no ABREN), so this hunts through a table
+ * of standard rates, 9600 to 2000000 baud, instead of measuring the start bit. Every
+ * received character is checked against BARE_USART_AUTOBAUD_CHAR (Enter) and, when it
+ * arrives garbled or with a framing error, the USART steps to the next rate in the table
+ * (wrapping around). The first clean BARE_USART_AUTOBAUD_CHAR locks the rate and is
+ * handed to the RX callback; nothing else reaches it while hunting. A host at a rate
+ * outside the table is never found: the hunt has no deadline of its own, the caller
+ * ends it with bare_usart_set_baud(). Needs interrupts enabled.
+ *
+ * @param usart Handle
+ */
+void bare_usart_autobaud(Bare_USART_t *usart);
+
+/**
+ * @brief Send a single character on a USART
+ *
+ * The character is queued in the transmit ring and sent by the ISR. If the ring is full
+ * the oldest byte is sent by polling first, so the call never drops data.
+ *
+ * @param usart Handle
+ * @param c     Character to be transmitted
+ */
+void bare_usart_write_char(Bare_USART_t *usart, char c);
+
+/**
+ * @brief Send a null-terminated string on a USART
+ *
+ * @param usart Handle
+ * @param str   String to be transmitted
+ */
+void bare_usart_write_string(Bare_USART_t *usart, const char *str);
+
+/**
+ * @brief Format (fmt.h conversions) directly into the transmit ring of a USART
+ *
+ * The output is written in place and published with one head update, so it leaves as a
+ * single transmission. The terminal critical section is held while formatting; if the
+ * ring fills up, what is formatted so far is published and sent by polling to make room.
+ *
+ * @param usart Handle
+ * @param fmt   Format string
+ * @return uint32_t Characters written
+ */
+uint32_t bare_usart_write_fmt(Bare_USART_t *usart, const char *fmt, ...) FMT_PRINTF(2, 3);
+
+/**
+ * @brief bare_usart_write_fmt() with a va_list
+ *
+ * @param usart Handle
+ * @param fmt   Format string
+ * @param ap    Arguments
+ * @return uint32_t Characters written
+ */
+uint32_t bare_usart_write_vfmt(Bare_USART_t *usart, const char *fmt, va_list ap)
+    FMT_PRINTF(2, 0);
+
+/**
+ * @brief Queue output without starting the transmission (nestable)
+ *
+ * Until the matching bare_usart_tx_release(), characters collect in the TX ring; a full
+ * ring is still drained by polling. Do not call bare_usart_flush() while held.
+ *
+ * @param usart Handle (NULL is ignored, e.g. bare_usart_get_console() without a console)
+ */
+void bare_usart_tx_hold(Bare_USART_t *usart);
+
+/**
+ * @brief End a bare_usart_tx_hold(): send everything queued as one transmission
+ *
+ * @param usart Handle (NULL is ignored)
+ */
+void bare_usart_tx_release(Bare_USART_t *usart);
+
+/**
+ * @brief Read a single character from a USART by polling
+ *
+ * @param usart Handle
+ * @return char Received character
+ */
+char bare_usart_read(Bare_USART_t *usart);
+
+/**
+ * @brief Get the deepest fill of a TX ring
+ *
+ * @param usart Handle
+ * @return uint16_t Bytes (out of the ring size - 1)
+ */
+uint16_t bare_usart_tx_high_water(const Bare_USART_t *usart);
+
+/**
+ * @brief Select the USART the bare_usart_send_*() helpers write to
+ *
+ * @param usart Handle (NULL discards console output)
+ */
+void bare_usart_set_console(Bare_USART_t *usart);
+
+/**
+ * @brief Get the console USART
+ *
+ * @return Bare_USART_t* Handle, or NULL
+ */
+Bare_USART_t *bare_usart_get_console(void);
+
+/**
+ * @brief Send a single character to the console
  *
  * @param c Character to be transmitted
  */
 void bare_usart_send_char(char c);
 
 /**
- * @brief Send a null-terminated string over USART
+ * @brief Send a null-terminated string to the console
  *
  * @param str Pointer to string to be transmitted
  */
 void bare_usart_send_string(const char *str);
 
 /**
- * @brief Read a single character from USART
+ * @brief Send an unsigned integer in decimal to the console
+ *
+ * @param value Value to be transmitted (no padding, no sign)
+ */
+void bare_usart_send_uint(uint32_t value);
+
+/**
+ * @brief Send a 32-bit value as 8 uppercase hex digits to the console
+ *
+ * @param value Value to be transmitted (no prefix)
+ */
+void bare_usart_send_hex32(uint32_t value);
+
+/**
+ * @brief Format (fmt.h conversions) directly into the console's transmit ring
+ *
+ * @param fmt Format string
+ * @return uint32_t Characters written, 0 without a console
+ */
+uint32_t bare_usart_send_fmt(const char *fmt, ...) FMT_PRINTF(1, 2);
+
+/**
+ * @brief Read a single character from the console by polling
  *
  * @return char Received character
  */
 char bare_usart_read_char(void);
 
 /**
- * @brief Clear the terminal screen
+ * @brief Clear the console terminal screen
  *
  */
 void bare_usart_clear_screen(void);
@@ -0,0 +1,86 @@
+/*******************************************************************************************
+ * @file    coroutine.h
+ * @author  ka5j
+ * @brief   Stackless coroutines (protothread-style local continuations)
+ * @version 1.0
+ * @date    2025-06-06
+ *
+ * @details
+ * A coroutine is an ordinary function whose body is wrapped in CORO_BEGIN / CORO_END.
+ * Its only saved state is a 16-bit resume point (the source line of the last yield), so
+ * thousands of coroutines fit in a few bytes each and share a single stack.
+ *
+ * Rules (as for any switch-based protothread):
+ * - Locals do not survive a yield; keep loop counters in the caller-owned state struct
+ * - Do not yield from inside a nested switch statement
+ *******************************************************************************************/
+
+#ifndef COROUTINE_H_
+#define COROUTINE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Coroutine resume point (0 = start of the body)
+ */
+typedef uint16_t Coro_LC_t;
+
+/**
+ * @brief Coroutine return codes
+ */
+typedef enum
+{
+    CORO_WAITING = 0U, /*!< Suspended at a yield, call again later */
+    CORO_ENDED = 1U    /*!< Ran off the end of its body            */
+} Coro_Status_t;
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+
+/**
+ * @brief Start of a coroutine body, resumes at the saved point.
+ */
+#define CORO_BEGIN(lc) \
+    switch (*(lc))     \
+    {                  \
+    case 0:
+
+/**
+ * @brief Suspend until cond is true (cond is re-evaluated on every resume).
+ */
+#define CORO_YIELD_UNTIL(lc, cond) \
+    do                             \
+    {                              \
+        *(lc) = __LINE__;          \
+    case __LINE__:                 \
+        if (!(cond))               \
+        {                          \
+            return CORO_WAITING;   \
+        }                          \
+    } while (0)
+
+/**
+ * @brief Suspend once unconditionally.
+ */
+#define CORO_YIELD(lc)                \
+    do                                \
+    {                                 \
+        *(lc) = __LINE__;             \
+        return CORO_WAITING;          \
+    case __LINE__:;                   \
+    } while (0)
+
+/**
+ * @brief End of a coroutine body; the next call starts over from the beginning.
+ */
+#define CORO_END(lc) \
+    }                \
+    *(lc) = 0;       \
+    return CORO_ENDED
+
+#endif /* COROUTINE_H_ */
@@ -0,0 +1,93 @@
+/*******************************************************************************************
+ * @file    crash.h
+ * @author  ka5j
+ * @brief   Fault handlers with a post-mortem crash record kept across resets
+ * @version 1.0
+ * @date    2025-06-17
+ *
+ * @details
+ * HardFault, MemManage, BusFault and UsageFault share one handler. It switches to a
+ * private fault stack, stores the stacked registers, the fault status/address registers
+ * and a snapshot of the stack above the exception frame in a .noinit record, then resets
+ * the MCU through AIRCR. .noinit is neither copied nor zeroed by the startup code, so the
+ * record survives the reset and crash_report() can print it from the terminal.
+ *
+ * The record carries a magic value and a checksum: after a power-on reset the RAM
+ * content is random and the record reads as empty.
+ *******************************************************************************************/
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define CRASH_STACK_WORDS 16U /*!< Words saved from the stack above the exception frame */
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Post-mortem record (lives in .noinit)
+ */
+typedef struct
+{
+    uint32_t magic;      /*!< CRASH_MAGIC when the record holds a fault         */
+    uint32_t count;      /*!< Faults recorded since the record was cleared      */
+    uint32_t exception;  /*!< Exception number (3 HardFault ... 6 UsageFault)   */
+    uint32_t exc_return; /*!< EXC_RETURN: stack and mode of the faulting code   */
+    uint32_t sp;         /*!< Address of the exception frame                    */
+    uint32_t r0;
+    uint32_t r1;
+    uint32_t r2;
+    uint32_t r3;
+    uint32_t r12;
+    uint32_t lr;         /*!< Return address of the faulting function           */
+    uint32_t pc;         /*!< Faulting instruction (or the next one if imprecise) */
+    uint32_t xpsr;
+    uint32_t cfsr;       /*!< Configurable fault status (MMFSR, BFSR, UFSR)     */
+    uint32_t hfsr;       /*!< HardFault status                                  */
+    uint32_t mmfar;      /*!< MemManage address (valid if CFSR.MMARVALID)       */
+    uint32_t bfar;       /*!< BusFault address (valid if CFSR.BFARVALID)        */
+    uint32_t ticks;      /*!< Uptime in ms when the fault hit                   */
+    uint32_t stack_words;                /*!< Valid words in stack[]            */
+    uint32_t stack[CRASH_STACK_WORDS];   /*!< Stack above the exception frame   */
+    uint32_t check;      /*!< Checksum over every word above                    */
+} Crash_Record_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Enable the MemManage, BusFault and UsageFault exceptions and divide-by-zero
+ *         trapping, so faults are reported with their own cause instead of escalating.
+ */
+void crash_init(void);
+
+/**
+ * @brief  Get the record of the last fault.
+ *
+ * @return Pointer to the record, or NULL if no fault is recorded
+ */
+const Crash_Record_t *crash_get_record(void);
+
+/**
+ * @brief  Print the recorded fault to the terminal ("NO CRASH RECORDED" if none).
+ */
+void crash_report(void);
+
+/**
+ * @brief  Forget the recorded fault.
+ */
+void crash_clear(void);
+
+/**
+ * @brief  Execute an undefined instruction to exercise the fault path (never returns).
+ */
+void crash_test(void);
+
+#endif /* CRASH_H_ */
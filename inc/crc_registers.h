@@ -0,0 +1,44 @@
+/*******************************************************************************************
+ * @file    crc_registers.h
+ * @author  ka5j
+ * @brief   STM32F446RE CRC Calculation Unit Memory-Mapped Register Definitions (Bare Metal)
+ * @version 1.0
+ * @date    2025-07-01
+ *
+ * @note    Only memory-mapped register definitions for the CRC unit (RM0390 chapter 10).
+ *          The unit computes CRC-32 (poly 0x04C11DB7) over 32-bit words written to DR,
+ *          most significant bit first; CR.RESET reloads 0xFFFFFFFF.
+ *******************************************************************************************/
+
+#ifndef CRC_REGISTERS_H_
+#define CRC_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h"
+
+/*******************************************************************************************
+ * CRC Base Address
+ *******************************************************************************************/
+#define CRC_BASE (AHB1PERIPH_BASE + 0x3000UL)
+
+/*******************************************************************************************
+ * CRC Register Definition
+ *******************************************************************************************/
+typedef struct
+{
+    volatile uint32_t DR;  /*!< Data register: write to feed, read the result */
+    volatile uint32_t IDR; /*!< Independent data register (8 bits, free use)  */
+    volatile uint32_t CR;  /*!< Control register                              */
+} CRC_TypeDef;
+
+/*******************************************************************************************
+ * CRC Register Bits
+ *******************************************************************************************/
+#define CRC_CR_RESET (1UL << 0) /*!< Reload DR with 0xFFFFFFFF */
+
+/*******************************************************************************************
+ * CRC Peripheral Definition
+ *******************************************************************************************/
+#define CRC ((CRC_TypeDef *)CRC_BASE)
+
+#endif /* CRC_REGISTERS_H_ */
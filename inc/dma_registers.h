@@ -0,0 +1,120 @@
+/*******************************************************************************************
+ * @file    dma_registers.h
+ * @author  ka5j
+ * @brief   STM32F446RE DMA1/DMA2 Device Memory-Mapped Register Definitions (Bare Metal)
+ * @version 1.1
+ * @date    2025-06-13
+ *
+ * @note    Only memory-mapped register definitions for the DMA controllers and their
+ *          8 streams each. This file assumes a 32-bit embedded platform and no CMSIS
+ *          dependency.
+ *******************************************************************************************/
+
+#ifndef DMA_REGISTERS_H_
+#define DMA_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h"
+
+/*******************************************************************************************
+ * DMA Base Addresses
+ *******************************************************************************************/
+#define DMA1_BASE (AHB1PERIPH_BASE + 0x6000UL)
+#define DMA2_BASE (AHB1PERIPH_BASE + 0x6400UL)
+
+#define DMA_STREAM_OFFSET(n) (0x10UL + 0x18UL * (n)) /*!< Stream n register block */
+
+/*******************************************************************************************
+ * DMA Register Definitions
+ *******************************************************************************************/
+typedef struct
+{
+    volatile uint32_t LISR;  /*!< Low interrupt status register (streams 0-3)   */
+    volatile uint32_t HISR;  /*!< High interrupt status register (streams 4-7)  */
+    volatile uint32_t LIFCR; /*!< Low interrupt flag clear register             */
+    volatile uint32_t HIFCR; /*!< High interrupt flag clear register            */
+} DMA_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CR;   /*!< Stream configuration register          */
+    volatile uint32_t NDTR; /*!< Stream number of data register         */
+    volatile uint32_t PAR;  /*!< Stream peripheral address register     */
+    volatile uint32_t M0AR; /*!< Stream memory 0 address register       */
+    volatile uint32_t M1AR; /*!< Stream memory 1 address register       */
+    volatile uint32_t FCR;  /*!< Stream FIFO control register           */
+} DMA_Stream_TypeDef;
+
+/*******************************************************************************************
+ * DMA Stream CR Bits
+ *******************************************************************************************/
+#define DMA_SxCR_EN (1UL << 0)           /*!< Stream enable                      */
+#define DMA_SxCR_DMEIE (1UL << 1)        /*!< Direct mode error interrupt enable */
+#define DMA_SxCR_TEIE (1UL << 2)         /*!< Transfer error interrupt enable    */
+#define DMA_SxCR_HTIE (1UL << 3)         /*!< Half transfer interrupt enable     */
+#define DMA_SxCR_TCIE (1UL << 4)         /*!< Transfer complete interrupt enable */
+#define DMA_SxCR_DIR_POS 6U              /*!< Direction field position           */
+#define DMA_SxCR_DIR_M2P (1UL << 6)      /*!< Memory-to-peripheral               */
+#define DMA_SxCR_DIR_M2M (2UL << 6)      /*!< Memory-to-memory (DMA2 only)       */
+#define DMA_SxCR_CIRC (1UL << 8)         /*!< Circular mode                      */
+#define DMA_SxCR_PINC (1UL << 9)         /*!< Peripheral increment               */
+#define DMA_SxCR_MINC (1UL << 10)        /*!< Memory increment                   */
+#define DMA_SxCR_PSIZE_POS 11U           /*!< Peripheral size field position     */
+#define DMA_SxCR_PSIZE_16 (1UL << 11)    /*!< Peripheral size: half-word         */
+#define DMA_SxCR_PSIZE_32 (2UL << 11)    /*!< Peripheral size: word              */
+#define DMA_SxCR_MSIZE_16 (1UL << 13)    /*!< Memory size: half-word             */
+#define DMA_SxCR_MSIZE_32 (2UL << 13)    /*!< Memory size: word                  */
+#define DMA_SxCR_MSIZE_POS 13U           /*!< Memory size field position         */
+#define DMA_SxCR_PL_POS 16U              /*!< Priority level field position      */
+#define DMA_SxCR_PL_HIGH (2UL << 16)     /*!< Priority level high                */
+#define DMA_SxCR_PL_VERY_HIGH (3UL << 16) /*!< Priority level very high          */
+#define DMA_SxCR_DBM (1UL << 18)         /*!< Double-buffer mode                 */
+#define DMA_SxCR_CT (1UL << 19)          /*!< Current target (0 = M0AR, 1 = M1AR) */
+#define DMA_SxCR_PBURST_POS 21U          /*!< Peripheral burst field position    */
+#define DMA_SxCR_MBURST_POS 23U          /*!< Memory burst field position        */
+#define DMA_SxCR_CHSEL(ch) ((uint32_t)(ch) << 25) /*!< Request channel 0-7       */
+
+/*******************************************************************************************
+ * DMA Stream FCR Bits
+ *******************************************************************************************/
+#define DMA_SxFCR_FTH_MASK (3UL << 0) /*!< FIFO threshold (1/4, 1/2, 3/4, full)  */
+#define DMA_SxFCR_DMDIS (1UL << 2)    /*!< Direct mode disable (FIFO in use)    */
+#define DMA_SxFCR_FEIE (1UL << 7)     /*!< FIFO error interrupt enable          */
+
+/*******************************************************************************************
+ * DMA Interrupt Flags (stream 0 position; shift by DMA_FLAG_SHIFT(n) for stream n)
+ *******************************************************************************************/
+#define DMA_FLAG_FEIF (1UL << 0)  /*!< FIFO error                 */
+#define DMA_FLAG_DMEIF (1UL << 2) /*!< Direct mode error          */
+#define DMA_FLAG_TEIF (1UL << 3)  /*!< Transfer error             */
+#define DMA_FLAG_HTIF (1UL << 4)  /*!< Half transfer              */
+#define DMA_FLAG_TCIF (1UL << 5)  /*!< Transfer complete          */
+#define DMA_FLAG_ALL 0x3DUL       /*!< Every flag of one stream   */
+
+#define DMA_FLAG_SHIFT(n) ((((n) & 1UL) * 6UL) + ((((n) >> 1) & 1UL) * 16UL)) /*!< In xISR */
+
+/*******************************************************************************************
+ * DMA Peripheral Definitions
+ *******************************************************************************************/
+#define DMA1 ((DMA_TypeDef *)DMA1_BASE)
+#define DMA2 ((DMA_TypeDef *)DMA2_BASE)
+
+#define DMA1_Stream0 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(0)))
+#define DMA1_Stream1 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(1)))
+#define DMA1_Stream2 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(2)))
+#define DMA1_Stream3 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(3)))
+#define DMA1_Stream4 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(4)))
+#define DMA1_Stream5 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(5)))
+#define DMA1_Stream6 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(6)))
+#define DMA1_Stream7 ((DMA_Stream_TypeDef *)(DMA1_BASE + DMA_STREAM_OFFSET(7)))
+
+#define DMA2_Stream0 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(0)))
+#define DMA2_Stream1 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(1)))
+#define DMA2_Stream2 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(2)))
+#define DMA2_Stream3 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(3)))
+#define DMA2_Stream4 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(4)))
+#define DMA2_Stream5 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(5)))
+#define DMA2_Stream6 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(6)))
+#define DMA2_Stream7 ((DMA_Stream_TypeDef *)(DMA2_BASE + DMA_STREAM_OFFSET(7)))
+
+#endif /* DMA_REGISTERS_H_ */
@@ -0,0 +1,70 @@
+/*******************************************************************************************
+ * @file    dsp_bench.h
+ * @author  ka5j
+ * @brief   On-target cycle benchmark of the Q15 DSP kernels against their scalar versions
+ * @version 1.0
+ * @date    2025-06-12
+ *
+ * @details
+ * Each kernel is run on DSP_BENCH_CHANNELS pseudo-random channels, packed and scalar, and
+ * timed with the DWT cycle counter. The best of DSP_BENCH_RUNS runs is kept so preemption
+ * by the effects task or an ISR does not skew the result. Outputs of both versions are
+ * compared to confirm bit-exactness on the target.
+ *******************************************************************************************/
+
+#ifndef DSP_BENCH_H_
+#define DSP_BENCH_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define DSP_BENCH_CHANNELS 256U /*!< Channels processed per kernel call */
+#define DSP_BENCH_RUNS 4U       /*!< Runs per kernel, the fastest is kept */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Benchmarked kernels
+ */
+typedef enum
+{
+    DSP_BENCH_SCALE = 0U,
+    DSP_BENCH_BLEND = 1U,
+    DSP_BENCH_ADD_SAT = 2U,
+    DSP_BENCH_GAMMA = 3U,
+    DSP_BENCH_DITHER = 4U,
+    DSP_BENCH_COUNT
+} Dsp_Bench_Kernel_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Result for one kernel
+ */
+typedef struct
+{
+    const char *name;        /*!< Kernel name                           */
+    uint32_t scalar_cycles;  /*!< Best scalar run, whole batch          */
+    uint32_t packed_cycles;  /*!< Best packed (DSP) run, whole batch    */
+    uint8_t match;           /*!< 1 if both outputs are identical       */
+} Dsp_Bench_Result_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Run every kernel benchmark (blocking, a few hundred microseconds).
+ *
+ * @param  results  Array of DSP_BENCH_COUNT entries, filled in kernel order
+ * @return 0 on success, -1 if the scratch arena cannot hold the channel buffers
+ */
+int dsp_bench_run(Dsp_Bench_Result_t *results);
+
+#endif /* DSP_BENCH_H_ */
@@ -0,0 +1,113 @@
+/*******************************************************************************************
+ * @file    dsp_q15.h
+ * @author  ka5j
+ * @brief   Q15 fixed-point kernels for batch brightness computation
+ * @version 1.0
+ * @date    2025-06-12
+ *
+ * @details
+ * Channel levels are signed Q15 halfwords (0 = off, 0x7FFF = full). The kernels load two
+ * channels per 32-bit word and use the Cortex-M4 DSP extension (QADD16, USAT16, SMLAD,
+ * SMUAD, SSAT) when __ARM_FEATURE_DSP is defined. Other builds (HOST_BUILD) emulate every
+ * instruction in C with the same saturation and rounding, so results are bit-exact.
+ *
+ * The *_scalar variants process one channel at a time in plain C. They are the reference
+ * for the packed kernels and the baseline of the DSP benchmark.
+ *
+ * All halfword buffers must be 4-byte aligned. Odd counts are allowed.
+ *******************************************************************************************/
+
+#ifndef DSP_Q15_H_
+#define DSP_Q15_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define DSP_Q15_MAX 0x7FFF         /*!< Full brightness                          */
+#define DSP_GAIN_Q12_ONE 0x1000    /*!< Unity gain for dsp_q15_scale() (Q4.12)   */
+#define DSP_ALPHA_Q14_ONE 0x4000U  /*!< Blend fully towards b (Q14)              */
+#define DSP_GAMMA_LUT_SIZE 257U    /*!< Gamma table entries (256 segments)       */
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  dst[i] = sat16((src[i] * gain) >> 12), gain in Q4.12 (up to ~8x).
+ *
+ * @param  dst   Output levels (may alias src)
+ * @param  src   Input levels
+ * @param  gain  Gain in Q4.12, DSP_GAIN_Q12_ONE = 1.0
+ * @param  n     Number of channels
+ */
+void dsp_q15_scale(int16_t *dst, const int16_t *src, int16_t gain, uint32_t n);
+
+/**
+ * @brief  dst[i] = (a[i] * (1 - alpha) + b[i] * alpha + 0.5) in Q14 weights.
+ *
+ * @param  dst    Output levels (may alias a or b)
+ * @param  a      Levels at alpha = 0
+ * @param  b      Levels at alpha = DSP_ALPHA_Q14_ONE
+ * @param  alpha  Blend factor 0 - DSP_ALPHA_Q14_ONE
+ * @param  n      Number of channels
+ */
+void dsp_q15_blend(int16_t *dst, const int16_t *a, const int16_t *b, uint16_t alpha, uint32_t n);
+
+/**
+ * @brief  dst[i] = sat16(a[i] + b[i]) (additive layer mixing).
+ *
+ * @param  dst  Output levels (may alias a or b)
+ * @param  a    First layer
+ * @param  b    Second layer
+ * @param  n    Number of channels
+ */
+void dsp_q15_add_sat(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t n);
+
+/**
+ * @brief  Gamma 2.2 correction by linear interpolation in a 257-entry table.
+ *
+ * @param  dst  Output levels (may alias src)
+ * @param  src  Linear levels, negative values are treated as 0
+ * @param  n    Number of channels
+ */
+void dsp_q15_gamma(int16_t *dst, const int16_t *src, uint32_t n);
+
+/**
+ * @brief  Ordered dither of Q15 levels down to 8-bit PWM/strip values.
+ *
+ * @param  dst    8-bit output values
+ * @param  src    Levels, clamped to 0 - DSP_Q15_MAX
+ * @param  n      Number of channels
+ * @param  frame  Frame counter, rotates the 4-step dither pattern over time
+ */
+void dsp_q15_dither_u8(uint8_t *dst, const int16_t *src, uint32_t n, uint32_t frame);
+
+/**
+ * @brief  Scalar reference of dsp_q15_scale().
+ */
+void dsp_q15_scale_scalar(int16_t *dst, const int16_t *src, int16_t gain, uint32_t n);
+
+/**
+ * @brief  Scalar reference of dsp_q15_blend().
+ */
+void dsp_q15_blend_scalar(int16_t *dst, const int16_t *a, const int16_t *b, uint16_t alpha,
+                          uint32_t n);
+
+/**
+ * @brief  Scalar reference of dsp_q15_add_sat().
+ */
+void dsp_q15_add_sat_scalar(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t n);
+
+/**
+ * @brief  Scalar reference of dsp_q15_gamma().
+ */
+void dsp_q15_gamma_scalar(int16_t *dst, const int16_t *src, uint32_t n);
+
+/**
+ * @brief  Scalar reference of dsp_q15_dither_u8().
+ */
+void dsp_q15_dither_u8_scalar(uint8_t *dst, const int16_t *src, uint32_t n, uint32_t frame);
+
+#endif /* DSP_Q15_H_ */
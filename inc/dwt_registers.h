@@ -0,0 +1,60 @@
+/*******************************************************************************************
+ * @file    dwt_registers.h
+ * @author  ka5j
+ * @brief   Cortex-M4 DWT and CoreDebug Memory-Mapped Register Definitions (Bare Metal)
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @note    Only memory-mapped register definitions for the Data Watchpoint and Trace unit
+ *          and the CoreDebug block (DEMCR). Assumes a 32-bit ARM Cortex-M4 platform with
+ *          no CMSIS dependency.
+ *******************************************************************************************/
+
+#ifndef DWT_REGISTERS_H_
+#define DWT_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h" // Must define CORTEX_M4_PERIPH_BASE
+
+/*******************************************************************************************
+ * DWT and CoreDebug Base Addresses (ARM-defined for Cortex-M4)
+ *******************************************************************************************/
+#define DWT_BASE (CORTEX_M4_PERIPH_BASE + 0x1000UL)
+#define COREDEBUG_BASE (CORTEX_M4_PERIPH_BASE + 0xEDF0UL)
+
+/*******************************************************************************************
+ * DWT Register Definition
+ *******************************************************************************************/
+typedef struct
+{
+    volatile uint32_t CTRL;     /*!< Control register                         */
+    volatile uint32_t CYCCNT;   /*!< Cycle count register                     */
+    volatile uint32_t CPICNT;   /*!< CPI count register                       */
+    volatile uint32_t EXCCNT;   /*!< Exception overhead count register        */
+    volatile uint32_t SLEEPCNT; /*!< Sleep count register                     */
+    volatile uint32_t LSUCNT;   /*!< LSU count register                       */
+    volatile uint32_t FOLDCNT;  /*!< Folded-instruction count register        */
+    const volatile uint32_t PCSR; /*!< Program counter sample register (read-only) */
+} DWT_TypeDef;
+
+/*******************************************************************************************
+ * CoreDebug Register Definition
+ *******************************************************************************************/
+typedef struct
+{
+    volatile uint32_t DHCSR; /*!< Debug halting control and status register */
+    volatile uint32_t DCRSR; /*!< Debug core register selector register     */
+    volatile uint32_t DCRDR; /*!< Debug core register data register         */
+    volatile uint32_t DEMCR; /*!< Debug exception and monitor control       */
+} CoreDebug_TypeDef;
+
+#define DWT ((DWT_TypeDef *)DWT_BASE)
+#define COREDEBUG ((CoreDebug_TypeDef *)COREDEBUG_BASE)
+
+/*******************************************************************************************
+ * Bit Definitions
+ *******************************************************************************************/
+#define DWT_CTRL_CYCCNTENA (1UL << 0)     /*!< Enable the cycle counter          */
+#define COREDEBUG_DEMCR_TRCENA (1UL << 24) /*!< Enable DWT and ITM blocks         */
+
+#endif /* DWT_REGISTERS_H_ */
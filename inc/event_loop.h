@@ -0,0 +1,157 @@
+/*******************************************************************************************
+ * @file    event_loop.h
+ * @author  ka5j
+ * @brief   Cooperative event loop with prioritized run-to-completion handlers
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @details
+ * ISRs post small fixed-size events into one of several lock-free queues (one per
+ * priority level). The main loop always dispatches the oldest event of the highest
+ * non-empty priority, runs its handler to completion, and sleeps when every queue is
+ * empty: with WFI, or under a kernel by blocking the consumer task through the hooks of
+ * event_loop_set_blocking(). Queue depth and handler execution time are recorded per
+ * event type.
+ *******************************************************************************************/
+
+#ifndef EVENT_LOOP_H_
+#define EVENT_LOOP_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define EVENT_QUEUE_SIZE 16U /*!< Slots per priority queue (must be a power of two) */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Event priority levels (lower value is dispatched first)
+ */
+typedef enum
+{
+    EVT_PRIO_HIGH = 0U,   /*!< Time-critical work (timers, effects) */
+    EVT_PRIO_NORMAL = 1U, /*!< Terminal commands                    */
+    EVT_PRIO_LOW = 2U,    /*!< Background work (TX done, telemetry) */
+    EVT_PRIO_COUNT
+} Event_Priority_t;
+
+/**
+ * @brief Event types posted by ISRs
+ */
+typedef enum
+{
+    EVT_TIMER_EXPIRED = 0U,  /*!< Periodic SysTick timer elapsed              */
+    EVT_RX_LINE_READY = 1U,  /*!< A complete command line has been received   */
+    EVT_TX_DONE = 2U,        /*!< USART transmit buffer drained completely    */
+    EVT_RX_FRAME_READY = 3U, /*!< A complete binary frame has been received   */
+    EVT_TYPE_COUNT
+} Event_Type_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Lightweight event record (one word)
+ */
+typedef struct
+{
+    uint8_t type;     /*!< Event_Type_t                      */
+    uint8_t reserved; /*!< Padding, keeps the record 4 bytes */
+    uint16_t arg;     /*!< Event-specific argument           */
+} Event_t;
+
+/**
+ * @brief Run-to-completion event handler
+ */
+typedef void (*Event_Handler_t)(const Event_t *evt);
+
+/**
+ * @brief Consumer blocking hook (see event_loop_set_blocking())
+ */
+typedef void (*Event_Hook_t)(void);
+
+/**
+ * @brief Per event type statistics
+ */
+typedef struct
+{
+    uint32_t posted;       /*!< Events accepted into a queue            */
+    uint32_t dropped;      /*!< Events rejected because a queue was full */
+    uint32_t dispatched;   /*!< Handler invocations                     */
+    uint32_t last_cycles;  /*!< Duration of the last handler run        */
+    uint32_t max_cycles;   /*!< Longest handler run observed            */
+    uint32_t total_cycles; /*!< Sum of handler durations (wraps)        */
+} Event_Stats_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Reset all queues, handlers and statistics.
+ */
+void event_loop_init(void);
+
+/**
+ * @brief  Register the handler and queue priority used for an event type.
+ *
+ * @param  type     Event type to bind
+ * @param  prio     Queue the events of this type are posted to
+ * @param  handler  Function executed (to completion) for every event of this type
+ */
+void event_loop_register(Event_Type_t type, Event_Priority_t prio, Event_Handler_t handler);
+
+/**
+ * @brief  Post an event. Safe to call from any ISR or from thread mode.
+ *
+ * @param  type  Event type (must have a registered handler)
+ * @param  arg   Event-specific argument
+ * @return 0 on success, -1 if no handler is registered or the queue is full
+ */
+int event_post(Event_Type_t type, uint16_t arg);
+
+/**
+ * @brief  Dispatch at most one event, highest priority first.
+ *
+ * @return 1 if a handler was run, 0 if all queues were empty
+ */
+int event_loop_dispatch_one(void);
+
+/**
+ * @brief  Dispatch events forever, sleeping whenever all queues are empty.
+ */
+void event_loop_run(void);
+
+/**
+ * @brief  Block the consumer instead of sleeping with WFI when the queues are empty.
+ *
+ * @param  wait  Called by event_loop_run() to block; must return at once if wake() was
+ *               called since it last returned (e.g. kernel_wait())
+ * @param  wake  Called by event_post() after every accepted event, from ISRs too
+ *               (e.g. kernel_notify() of the consumer task)
+ */
+void event_loop_set_blocking(Event_Hook_t wait, Event_Hook_t wake);
+
+/**
+ * @brief  Get the statistics recorded for an event type.
+ *
+ * @param  type  Event type
+ * @return Pointer to the statistics record
+ */
+const Event_Stats_t *event_loop_get_stats(Event_Type_t type);
+
+/**
+ * @brief  Get the current and maximum depth of a priority queue.
+ *
+ * @param  prio       Queue to inspect
+ * @param  max_depth  Optional output for the high-water mark (may be NULL)
+ * @return Number of events currently queued
+ */
+uint32_t event_loop_get_depth(Event_Priority_t prio, uint32_t *max_depth);
+
+#endif /* EVENT_LOOP_H_ */
@@ -0,0 +1,96 @@
+/*******************************************************************************************
+ * @file    fmt.h
+ * @author  ka5j
+ * @brief   Small printf-style formatter writing straight into a byte ring (no libc)
+ * @version 1.0
+ * @date    2025-07-02
+ *
+ * @details
+ * The formatter writes through a Fmt_Out_t cursor: a buffer, an index mask and a count of
+ * bytes that may be written before the owner is asked for more room. A power-of-two ring
+ * (the USART TX ring, mask = size - 1) and a plain buffer (mask = 0xFFFFFFFF, see
+ * fmt_snprint()) are written the same way, so bare_usart_write_fmt() formats directly into
+ * the TX ring without an intermediate line buffer. Nothing is allocated.
+ *
+ * Conversions: %d %i %u %x %X %c %s %% and %q, a signed fixed-point value printed with
+ * `precision` decimals (value / 10^precision: "%.2q" of 1234 is "12.34", of -5 "-0.05").
+ * Flags '-' (left-justify), '0' (zero padding), '+' (sign); width and precision as
+ * digits or '*'. Precision is the minimum digit count of %d/%u/%x and the maximum length
+ * of %s. Arguments are int-sized; 'l' reads a long (64-bit on the host) and keeps the low
+ * 32 bits. Unknown conversions are printed as they are.
+ *
+ * The entry points are checked like printf (FMT_PRINTF), so uint32_t arguments take the
+ * <inttypes.h> macros ("%" PRIu32): uint32_t is unsigned long on arm-none-eabi. %q is not
+ * a printf conversion; a call that uses it disables -Wformat and -Wformat-extra-args
+ * around itself.
+ *******************************************************************************************/
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define FMT_LINEAR 0xFFFFFFFFUL /*!< Fmt_Out_t mask of a plain (non-ring) buffer */
+
+/** Check calls like printf: format string argument index, first variadic index (0: va_list) */
+#define FMT_PRINTF(fmt_index, first_arg) __attribute__((format(printf, fmt_index, first_arg)))
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+typedef struct Fmt_Out Fmt_Out_t;
+
+/**
+ * @brief Called when the room runs out; returns the new room, 0 to discard the rest
+ */
+typedef uint32_t (*fmt_more_t)(Fmt_Out_t *out);
+
+/**
+ * @brief Output cursor
+ */
+struct Fmt_Out
+{
+    uint8_t *buf;          /*!< Storage, indexed with pos & mask                */
+    uint32_t mask;         /*!< Ring size - 1, or FMT_LINEAR                    */
+    uint32_t pos;          /*!< Next write index (unmasked)                     */
+    uint32_t room;         /*!< Bytes writable before more() is called          */
+    fmt_more_t more;       /*!< Room provider, NULL for a fixed buffer          */
+    void *context;         /*!< For more()                                      */
+    uint32_t count;        /*!< Characters produced, including discarded ones   */
+};
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Format into a cursor.
+ *
+ * @param  out  Cursor, advanced past the output
+ * @param  fmt  Format string
+ * @param  ap   Arguments
+ * @return uint32_t Characters produced by this call, including discarded ones
+ */
+uint32_t fmt_vprint(Fmt_Out_t *out, const char *fmt, va_list ap) FMT_PRINTF(2, 0);
+
+/**
+ * @brief  Format into a cursor (variadic form of fmt_vprint()).
+ */
+uint32_t fmt_print(Fmt_Out_t *out, const char *fmt, ...) FMT_PRINTF(2, 3);
+
+/**
+ * @brief  Format into a plain buffer, snprintf style.
+ *
+ * @param  buf   Output, always null-terminated when size > 0
+ * @param  size  Bytes of buf
+ * @param  fmt   Format string
+ * @return uint32_t Length the full output would have (truncated if >= size)
+ */
+uint32_t fmt_snprint(char *buf, uint32_t size, const char *fmt, ...) FMT_PRINTF(3, 4);
+
+#endif /* FMT_H_ */
@@ -0,0 +1,72 @@
+/*******************************************************************************************
+ * @file    image_check.h
+ * @author  ka5j
+ * @brief   Flash image integrity check at boot (hardware CRC, DMA fed)
+ * @version 1.0
+ * @date    2025-07-01
+ *
+ * @details
+ * The last word of the image (_image_crc in the linker script) holds the CRC of every
+ * word from FLASH_BASE up to it, computed the CRC unit's way (bare_crc_words()) and
+ * written by tools/patch_crc.py after linking. image_check_start() lets the DMA feed the
+ * image to the CRC unit while the rest of the system boots; the result is compared in
+ * the DMA ISR. An image loaded without the patch still holds 0xFFFFFFFF there and is
+ * reported as unpatched rather than corrupt.
+ *******************************************************************************************/
+
+#ifndef IMAGE_CHECK_H_
+#define IMAGE_CHECK_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Outcome of the image check
+ */
+typedef enum
+{
+    IMAGE_CHECK_IDLE = 0U,  /*!< Not started                          */
+    IMAGE_CHECK_RUNNING,    /*!< DMA still feeding the CRC unit       */
+    IMAGE_CHECK_OK,         /*!< Computed CRC matches the stored one  */
+    IMAGE_CHECK_MISMATCH,   /*!< Image corrupt                        */
+    IMAGE_CHECK_UNPATCHED,  /*!< No CRC stored (0xFFFFFFFF)           */
+    IMAGE_CHECK_ERROR       /*!< DMA transfer failed or not started   */
+} Image_Check_Status_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Image check result
+ */
+typedef struct
+{
+    volatile Image_Check_Status_t status; /*!< Outcome                                  */
+    uint32_t start;                       /*!< First byte checked (FLASH_BASE)          */
+    uint32_t bytes;                       /*!< Bytes checked (up to the CRC word)       */
+    uint32_t stored;                      /*!< CRC word in flash                        */
+    uint32_t computed;                    /*!< CRC of the image                         */
+    uint32_t cycles;                      /*!< Start to result, DWT cycles              */
+} Image_Check_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Start checking the image in the background (after bare_crc_init()).
+ */
+void image_check_start(void);
+
+/**
+ * @brief  Get the check result.
+ *
+ * @return Pointer to the result (status IMAGE_CHECK_RUNNING until the DMA is done)
+ */
+const Image_Check_t *image_check_get(void);
+
+#endif /* IMAGE_CHECK_H_ */
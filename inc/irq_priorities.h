@@ -0,0 +1,38 @@
+/*******************************************************************************************
+ * @file    irq_priorities.h
+ * @author  ka5j
+ * @brief   System-wide interrupt priority plan for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-09
+ *
+ * @details
+ * The STM32F446 implements 4 priority bits, used as 16 preemption levels (no sub-
+ * priorities). Lower numbers preempt higher ones. Critical sections raise BASEPRI to a
+ * ceiling, which masks only the interrupts at or below that ceiling: anything more urgent
+ * (LED DMA, PWM timers) keeps running with its normal latency. Level 0 can never be
+ * masked by BASEPRI.
+ *******************************************************************************************/
+
+#ifndef IRQ_PRIORITIES_H_
+#define IRQ_PRIORITIES_H_
+
+/*******************************************************************************************
+ *                                  Interrupt Priorities
+ *******************************************************************************************/
+#define IRQ_PRIO_DMA 0U      /*!< LED strip DMA streams, never masked           */
+#define IRQ_PRIO_PWM 1U      /*!< TIM2-TIM5 PWM / animation timers              */
+#define IRQ_PRIO_DMA_COPY 3U /*!< bare_dma_memcpy() completion                  */
+#define IRQ_PRIO_SYSTICK 4U  /*!< System tick, kernel time base                 */
+#define IRQ_PRIO_USART 6U    /*!< Terminal USARTs                               */
+#define IRQ_PRIO_SVCALL 15U  /*!< Kernel launch                                 */
+#define IRQ_PRIO_PENDSV 15U  /*!< Kernel context switch, always the lowest      */
+
+/*******************************************************************************************
+ *                               Critical Section Ceilings
+ *******************************************************************************************/
+#define CRIT_CEILING_KERNEL IRQ_PRIO_SYSTICK /*!< Kernel state shared with SysTick   */
+#define CRIT_CEILING_TERMINAL IRQ_PRIO_USART /*!< Terminal state shared with USARTs  */
+#define CRIT_CEILING_FB IRQ_PRIO_PWM         /*!< LED frame buffer commit (TIM2 ISR) */
+#define CRIT_CEILING_POOL IRQ_PRIO_SYSTICK   /*!< Memory pools and the scratch arena */
+
+#endif /* IRQ_PRIORITIES_H_ */
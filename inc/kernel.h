@@ -0,0 +1,172 @@
+/*******************************************************************************************
+ * @file    kernel.h
+ * @author  ka5j
+ * @brief   Minimal fixed-priority preemptive kernel for STM32F446RE (bare metal)
+ * @version 1.0
+ * @date    2025-06-04
+ *
+ * @details
+ * - Static task control blocks and stacks supplied by the application (no heap)
+ * - Fixed priorities, 0 is the most urgent; equal priorities are time sliced
+ * - Context switches in PendSV (lowest exception priority), first task launched by SVC
+ * - FPU registers s16-s31 are only saved for tasks that actually used the FPU
+ *   (EXC_RETURN bit 4), so integer-only tasks pay nothing for lazy stacking
+ * - Tasks block on a notification (kernel_wait()) that ISRs raise with kernel_notify()
+ * - Context switch cost is measured with the DWT cycle counter
+ * - Task stacks are painted at creation for high-water reporting, and the running
+ *   task's stack has an MPU guard below it (stack_check.h)
+ *******************************************************************************************/
+
+#ifndef KERNEL_H_
+#define KERNEL_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define KERNEL_MAX_TASKS 6U         /*!< Task slots, including the internal idle task */
+#define KERNEL_TIME_SLICE_TICKS 10U /*!< SysTick ticks before an equal-priority task runs */
+#define KERNEL_PRIO_IDLE 255U       /*!< Priority of the internal idle task */
+#define KERNEL_IDLE_STACK_WORDS 64U /*!< Idle task stack size in words */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Task states
+ */
+typedef enum
+{
+    KERNEL_TASK_READY = 0U,   /*!< Runnable                        */
+    KERNEL_TASK_DELAYED = 1U, /*!< Waiting for wake_tick           */
+    KERNEL_TASK_DORMANT = 2U, /*!< Returned from its entry function */
+    KERNEL_TASK_WAITING = 3U  /*!< Waiting for kernel_notify()      */
+} Kernel_TaskState_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Task entry function
+ */
+typedef void (*Kernel_TaskFn_t)(void *arg);
+
+/**
+ * @brief Task control block (allocated statically by the caller)
+ *
+ * @note  sp must stay the first member, PendSV_Handler relies on its offset.
+ */
+typedef struct
+{
+    uint32_t *sp;              /*!< Saved process stack pointer       */
+    uint32_t *stack_base;      /*!< Lowest usable address, guard below */
+    uint32_t stack_words;      /*!< Usable stack size in words        */
+    uint32_t wake_tick;        /*!< Tick at which a delay ends        */
+    uint8_t priority;          /*!< 0 = most urgent                   */
+    uint8_t state;             /*!< Kernel_TaskState_t                */
+    volatile uint8_t notified; /*!< kernel_notify() not yet consumed  */
+    const char *name;          /*!< Short name for diagnostics        */
+} Kernel_TCB_t;
+
+/**
+ * @brief Context switch statistics
+ *
+ * @note  last_switch_cycles / max_switch_cycles are written by PendSV_Handler and must
+ *        stay the first two members.
+ */
+typedef struct
+{
+    volatile uint32_t last_switch_cycles; /*!< PendSV entry to exit, last switch */
+    volatile uint32_t max_switch_cycles;  /*!< Worst PendSV entry to exit        */
+    volatile uint32_t switches;           /*!< Number of PendSV executions       */
+} Kernel_Stats_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Create a task. Must be called before kernel_start().
+ *
+ * @param  tcb          Caller-owned task control block
+ * @param  name         Short task name
+ * @param  fn           Entry function
+ * @param  arg          Argument passed to fn
+ * @param  stack        Caller-owned stack, aligned to STACK_GUARD_BYTES; its lowest
+ *                      STACK_GUARD_BYTES become the MPU guard
+ * @param  stack_words  Stack size in 32-bit words, guard included
+ * @param  priority     0 = most urgent, must be below KERNEL_PRIO_IDLE
+ * @return 0 on success, -1 if no slot is free or arguments are invalid
+ */
+int kernel_task_create(Kernel_TCB_t *tcb, const char *name, Kernel_TaskFn_t fn, void *arg,
+                       uint32_t *stack, uint32_t stack_words, uint8_t priority);
+
+/**
+ * @brief  Start scheduling. Never returns; the caller's (MSP) stack is left to ISRs.
+ */
+void kernel_start(void);
+
+/**
+ * @brief  Advance kernel time by one tick (call from SysTick_Handler).
+ *
+ * @details
+ * Wakes delayed tasks, rotates equal-priority tasks every KERNEL_TIME_SLICE_TICKS and
+ * pends PendSV when a different task should run. Does nothing before kernel_start().
+ */
+void kernel_tick(void);
+
+/**
+ * @brief  Block the calling task for a number of ticks.
+ *
+ * @param  ticks  Ticks to sleep (0 behaves like kernel_yield())
+ */
+void kernel_delay(uint32_t ticks);
+
+/**
+ * @brief  Give the CPU to another ready task of the same priority.
+ */
+void kernel_yield(void);
+
+/**
+ * @brief  Block the calling task until it is notified.
+ *
+ * @details
+ * A notification raised while the task was running is kept: the next kernel_wait()
+ * consumes it and returns at once, so a wake-up between the caller's last check and
+ * the wait is never lost. Several notifications before a wait count as one.
+ */
+void kernel_wait(void);
+
+/**
+ * @brief  Notify a task, readying it if it waits in kernel_wait(). Safe from ISRs at or
+ *         below CRIT_CEILING_KERNEL and from thread code.
+ *
+ * @param  tcb  Task to notify
+ */
+void kernel_notify(Kernel_TCB_t *tcb);
+
+/**
+ * @brief  Get the currently running task.
+ *
+ * @return Pointer to the running task's TCB (NULL before kernel_start())
+ */
+const Kernel_TCB_t *kernel_current_task(void);
+
+/**
+ * @brief  Get the context switch statistics.
+ *
+ * @return Pointer to the statistics record
+ */
+const Kernel_Stats_t *kernel_get_stats(void);
+
+/**
+ * @brief  Get a task by creation order (for diagnostics).
+ * @param  index  0 for the first task created; the idle task is created by kernel_start()
+ * @return Pointer to the task's TCB, NULL past the last task
+ */
+const Kernel_TCB_t *kernel_get_task(uint32_t index);
+
+#endif /* KERNEL_H_ */
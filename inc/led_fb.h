@@ -0,0 +1,120 @@
+/*******************************************************************************************
+ * @file    led_fb.h
+ * @author  ka5j
+ * @brief   LED frame buffer with dirty tracking and incremental commit
+ * @version 1.0
+ * @date    2025-06-15
+ *
+ * @details
+ * Every LED output writes its new state here instead of to the hardware. A commit then
+ * pushes only what changed since the previous commit:
+ * - GPIO outputs: one BSRR write per port, covering every changed pin of that port
+ * - PWM outputs: one CCR write per changed channel
+ * - LED strips: one DMA transfer covering pixels 0 up to the last dirty pixel. Pixels
+ *   past the dirty range are not resent; the strip keeps showing them.
+ * A shadow copy of the last hardware value also skips writes when a level changed in the
+ * buffer but maps to the same register value (e.g. a GPIO LED moving from 60 % to 70 %).
+ *
+ * Strip pixels live in the strip drivers' back buffers. Callers draw with the driver
+ * API and declare the touched range with fb_strip_mark().
+ *******************************************************************************************/
+
+#ifndef LED_FB_H_
+#define LED_FB_H_
+
+#include <stdint.h>
+
+#include "led_output.h"
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief LED strips behind the frame buffer
+ */
+typedef enum
+{
+    FB_STRIP_WS2812 = 0U, /*!< TIM3 + DMA1 strip (ws2812.h)  */
+    FB_STRIP_APA102 = 1U, /*!< SPI1 + DMA2 strip (apa102.h)  */
+    FB_STRIP_COUNT
+} Fb_Strip_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Commit counters
+ */
+typedef struct
+{
+    uint32_t commits;           /*!< Commits that found something dirty           */
+    uint32_t clean_commits;     /*!< Commits with nothing to push                 */
+    uint32_t registers;         /*!< BSRR/CCR writes and DMA starts, total        */
+    uint32_t registers_skipped; /*!< Dirty outputs whose register value was equal */
+    uint32_t bytes;             /*!< Strip bytes sent, total                      */
+    uint32_t last_registers;    /*!< Register writes of the last non-clean commit */
+    uint32_t last_bytes;        /*!< Strip bytes of the last non-clean commit     */
+} Fb_Stats_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Set the level of a discrete output (any context).
+ *
+ * @param  out    Output id
+ * @param  level  Brightness in Q16, 0 to LED_OUTPUT_Q16_ONE
+ */
+void fb_set_level(LED_Output_t out, uint32_t level);
+
+/**
+ * @brief  Get the buffered level of a discrete output.
+ *
+ * @param  out  Output id
+ * @return Brightness in Q16 (0 for an invalid id)
+ */
+uint32_t fb_get_level(LED_Output_t out);
+
+/**
+ * @brief  Declare strip pixels changed through the strip driver (thread context).
+ *
+ * @param  strip  Strip
+ * @param  first  First changed pixel
+ * @param  count  Number of changed pixels
+ */
+void fb_strip_mark(Fb_Strip_t strip, uint32_t first, uint32_t count);
+
+/**
+ * @brief  Push changed discrete outputs to BSRR/CCR (any context).
+ *
+ * @note   Runs under CRIT_CEILING_FB for a few microseconds, so committers in tasks
+ *         and in the animation ISR never interleave.
+ */
+void fb_commit_outputs(void);
+
+/**
+ * @brief  Push changed discrete outputs and strip ranges (thread context).
+ *
+ * @details
+ * Strip ranges belong to one task: the task that marks them must be the one committing
+ * them. A strip whose previous DMA transfer is still running stays dirty and is sent on
+ * a later commit.
+ */
+void fb_commit(void);
+
+/**
+ * @brief  Get the commit counters.
+ *
+ * @return Pointer to the statistics record
+ */
+const Fb_Stats_t *fb_get_stats(void);
+
+/**
+ * @brief  Reset the commit counters.
+ */
+void fb_reset_stats(void);
+
+#endif /* LED_FB_H_ */
@@ -0,0 +1,122 @@
+/*******************************************************************************************
+ * @file    led_fx.h
+ * @author  ka5j
+ * @brief   Concurrent LED effect scripts built on stackless coroutines
+ * @version 1.0
+ * @date    2025-06-06
+ *
+ * @details
+ * Every running effect is a 10-byte instance holding its coroutine resume point, wake-up
+ * time and script variables. fx_run() is called once per SysTick tick from the effects
+ * task; instances whose timer has not expired and that are not waiting on a signalled
+ * event are skipped with two compares, so large instance counts stay cheap. The price of
+ * the 16-bit wake-up time is the period limit: a wait is compared as a signed 16-bit tick
+ * difference, so periods are capped at FX_PERIOD_MAX.
+ *******************************************************************************************/
+
+#ifndef LED_FX_H_
+#define LED_FX_H_
+
+#include <stdint.h>
+
+#include "coroutine.h"
+#include "led_output.h"
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define FX_MAX_INSTANCES 1024U /*!< Concurrent effect instances (10 bytes each) */
+#define FX_PERIOD_MAX 32767U    /*!< Longest period, a wait must fit int16_t ticks  */
+
+#define FX_EVT_COMMAND (1U << 0) /*!< A terminal command was processed */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Effect scripts
+ */
+typedef enum
+{
+    FX_NONE = 0U,    /*!< Free instance slot                          */
+    FX_BLINK = 1U,   /*!< 50 % duty square wave, period in ms          */
+    FX_BREATHE = 2U, /*!< Linear 0 -> 100 -> 0 % ramp, period in ms     */
+    FX_FLASH = 3U,   /*!< Full brightness for period ms on each FX_EVT_COMMAND */
+    FX_TYPE_COUNT
+} Fx_Type_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Effect instance (10 bytes)
+ */
+typedef struct
+{
+    Coro_LC_t lc;     /*!< Coroutine resume point                      */
+    uint16_t wake;    /*!< Tick (mod 2^16) a timed wait ends           */
+    uint16_t period;  /*!< Effect period in ms                         */
+    uint8_t type;     /*!< Fx_Type_t, FX_NONE marks a free slot        */
+    uint8_t output;   /*!< LED_Output_t driven by this instance        */
+    uint8_t level;    /*!< Script variable (current brightness)        */
+    uint8_t wait_evt; /*!< Event mask waited for, 0 for a timed wait   */
+} Fx_Instance_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Set up the effect instance pool (before the first fx_start()).
+ */
+void fx_init(void);
+
+/**
+ * @brief  Start an effect on an output.
+ *
+ * @param  type    Effect script
+ * @param  output  Output driven by the effect
+ * @param  period  Effect period in ms (1 to FX_PERIOD_MAX)
+ * @return Instance index, or -1 if the period is out of range or no slot is free
+ */
+int fx_start(Fx_Type_t type, LED_Output_t output, uint16_t period);
+
+/**
+ * @brief  Stop every effect driving an output (the output keeps its last level).
+ *
+ * @param  output  Output to release
+ * @return Number of instances stopped
+ */
+uint32_t fx_stop_output(LED_Output_t output);
+
+/**
+ * @brief  Signal events to every instance waiting for them (any context).
+ *
+ * @param  mask  FX_EVT_* bits, delivered on the next fx_run() pass
+ */
+void fx_signal(uint8_t mask);
+
+/**
+ * @brief  Step all due effect instances.
+ *
+ * @param  now  Current SysTick tick count (ms)
+ */
+void fx_run(uint32_t now);
+
+/**
+ * @brief  Count the running effect instances.
+ *
+ * @return Number of instances in use
+ */
+uint32_t fx_active_count(void);
+
+/**
+ * @brief  Get the pool high-water mark.
+ *
+ * @return One past the highest instance block ever allocated
+ */
+uint32_t fx_high_water(void);
+
+#endif /* LED_FX_H_ */
@@ -0,0 +1,86 @@
+/*******************************************************************************************
+ * @file    led_output.h
+ * @author  ka5j
+ * @brief   Logical LED outputs shared by the command terminal and effect engines
+ * @version 1.0
+ * @date    2025-06-06
+ *
+ * @details
+ * Maps small output ids to the hardware that drives them, so effect code does not care
+ * whether an LED is a plain GPIO pin (on/off) or a TIM2–TIM5 PWM channel (0–100 %).
+ * Levels are stored in the LED frame buffer (led_fb.h); the hardware is only written
+ * when the frame buffer is committed, and only for outputs whose level changed.
+ *******************************************************************************************/
+
+#ifndef LED_OUTPUT_H_
+#define LED_OUTPUT_H_
+
+#include <stdint.h>
+
+#include "gpio_registers.h"   // GPIO register structure definitions
+#include "tim2_5_registers.h" // TIM2-TIM5 register definitions
+#include "bare_gpio.h"        // GPIO_Pins_t
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define LED_OUTPUT_Q16_ONE 0x10000UL /*!< Full brightness for led_output_set_q16() */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Logical LED outputs
+ */
+typedef enum
+{
+    LED_OUT_LED1 = 0U, /*!< PC5, GPIO on/off       */
+    LED_OUT_LED2 = 1U, /*!< PB6, TIM4 CH1 PWM      */
+    LED_OUT_COUNT
+} LED_Output_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Hardware behind one logical output
+ */
+typedef struct
+{
+    GPIO_TypeDef *port;  /*!< GPIO port for on/off outputs (NULL for PWM) */
+    GPIO_Pins_t pin;     /*!< GPIO pin                                    */
+    TIM2_5_TypeDef *tim; /*!< PWM timer, channel 1 (NULL for GPIO)       */
+} LED_OutputMap_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Set the brightness of an output.
+ *
+ * @param  out      Output id
+ * @param  percent  Brightness 0–100; GPIO outputs switch on at 50 % and above
+ */
+void led_output_set(LED_Output_t out, uint8_t percent);
+
+/**
+ * @brief  Set the brightness of an output with 16-bit resolution (no division).
+ *
+ * @param  out    Output id
+ * @param  level  Brightness in Q16, 0 to LED_OUTPUT_Q16_ONE; GPIO outputs switch on at
+ *                half scale. PWM timers must have ARR below 0xFFFF.
+ */
+void led_output_set_q16(LED_Output_t out, uint32_t level);
+
+/**
+ * @brief  Get the hardware behind an output (used by the frame buffer commit).
+ *
+ * @param  out  Output id (must be below LED_OUT_COUNT)
+ * @return Pointer to the output's hardware mapping
+ */
+const LED_OutputMap_t *led_output_map(LED_Output_t out);
+
+#endif /* LED_OUTPUT_H_ */
@@ -0,0 +1,130 @@
+/*******************************************************************************************
+ * @file    led_proto.h
+ * @author  ka5j
+ * @brief   Binary LED control protocol (COBS frames, CRC-32, acknowledged)
+ * @version 1.0
+ * @date    2025-06-30
+ *
+ * @details
+ * Machine clients share the terminal USART with the text commands. A frame is
+ *
+ *   0x00  COBS( seq | op ... | crc32 )  0x00
+ *
+ * The payload is a sequence number, any number of operations (LED_PROTO_OP_*) and the
+ * CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF, no reflection, no final XOR) of
+ * everything before it, little-endian (bare_crc_compute()). Multi-byte arguments are
+ * little-endian.
+ *
+ * Every zero ends the frame gathered since the previous zero and an empty frame is
+ * ignored: the leading zero switches the receiver from text to frame mode, the closing
+ * zero runs the frame and switches back. Text is gathered as well, up to each line end,
+ * so a frame whose leading zero was lost still runs and a lost delimiter costs at most
+ * one frame. The price is that text typed without its Enter just before a frame is
+ * discarded and answered with a BAD_CRC ack, and that a frame whose leading zero was
+ * lost is echoed like text.
+ *
+ * Every frame is answered with an ack frame in the same format: seq | status | ops done
+ * | crc32. Operations run in order until one fails; those before it stay applied. A frame
+ * repeating the sequence number of the last successful one is acknowledged again without
+ * running (the host lost the ack and retransmitted). tools/led_proto.py is the host side.
+ *******************************************************************************************/
+
+#ifndef LED_PROTO_H_
+#define LED_PROTO_H_
+
+#include <stdint.h>
+
+#include "bare_usart.h" // Ack destination
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define LED_PROTO_FRAME_MAX 192U /*!< Largest COBS-encoded frame without the delimiters */
+#define LED_PROTO_CRC_SIZE 4U    /*!< CRC-32 trailer                                  */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Operation codes (arguments follow the code)
+ */
+typedef enum
+{
+    LED_PROTO_OP_PING = 0x01U,       /*!< No arguments                                  */
+    LED_PROTO_OP_LED1 = 0x02U,       /*!< state: 0 off, 1 on, 2 toggle                  */
+    LED_PROTO_OP_LED2_PWM = 0x03U,   /*!< duty 0-100 %                                  */
+    LED_PROTO_OP_STRIP_FILL = 0x04U, /*!< r, g, b                                       */
+    LED_PROTO_OP_STRIP_SET = 0x05U,  /*!< index (u16), r, g, b                          */
+    LED_PROTO_OP_STRIP_RUN = 0x06U,  /*!< first (u16), count (u8), count x (r, g, b)    */
+    LED_PROTO_OP_APA_FILL = 0x07U,   /*!< r, g, b, brightness 0-31                      */
+    LED_PROTO_OP_APA_SET = 0x08U     /*!< index (u16), r, g, b, brightness 0-31         */
+} LED_Proto_Op_t;
+
+/**
+ * @brief Ack status
+ */
+typedef enum
+{
+    LED_PROTO_OK = 0U,        /*!< Every operation ran                                */
+    LED_PROTO_BAD_CRC = 1U,   /*!< COBS or CRC check failed, nothing ran              */
+    LED_PROTO_BAD_OP = 2U,    /*!< Unknown operation or arguments cut short           */
+    LED_PROTO_BAD_ARG = 3U,   /*!< Argument out of range                              */
+    LED_PROTO_OVERFLOW = 4U   /*!< Frame longer than LED_PROTO_FRAME_MAX, nothing ran */
+} LED_Proto_Status_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Protocol state of one terminal
+ */
+typedef struct
+{
+    uint8_t last_seq;   /*!< Sequence number of the last successful frame */
+    uint8_t last_done;  /*!< Its operation count, for the repeated ack     */
+    uint8_t has_last;   /*!< 1 once a frame has succeeded                 */
+    uint32_t frames;    /*!< Frames received                              */
+    uint32_t ops;       /*!< Operations run                               */
+    uint32_t errors;    /*!< Frames acknowledged with an error status     */
+} LED_Proto_Channel_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  COBS-encode a buffer.
+ *
+ * @param  src  Data
+ * @param  len  Bytes of data
+ * @param  dst  Output, at least len + len / 254 + 1 bytes; contains no zero
+ * @return uint32_t Encoded length
+ */
+uint32_t led_proto_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+/**
+ * @brief  COBS-decode a frame in place.
+ *
+ * @param  buf  Encoded frame without delimiters
+ * @param  len  Encoded length
+ * @return int32_t Decoded length, -1 if the frame is malformed
+ */
+int32_t led_proto_cobs_decode(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief  Decode, check and run one received frame, then send its ack.
+ *
+ * The frame buffer is decoded in place. Changes are committed (fb_commit()) before the
+ * ack is sent.
+ *
+ * @param  ch     Protocol state of the terminal
+ * @param  frame  COBS-encoded frame without delimiters
+ * @param  len    Encoded length, above LED_PROTO_FRAME_MAX if bytes were lost
+ * @param  reply  USART the ack is written to
+ */
+void led_proto_process(LED_Proto_Channel_t *ch, uint8_t *frame, uint32_t len,
+                       Bare_USART_t *reply);
+
+#endif /* LED_PROTO_H_ */
@@ -30,28 +30,89 @@
 #include "tim2_5_registers.h"      // TIM2-TIM5 register definitions
 #include "bare_systick.h"          // SysTick driver (bare-metal)
 #include "bare_gpio.h"             // GPIO driver (bare-metal)
-#include "bare_usart.h"            // USART2 driver (bare-metal)
+#include "bare_usart.h"            // USART driver (bare-metal)
 #include "bare_tim2_5.h"           // TIM2-TIM5 (bare-metal)
+#include "event_loop.h"            // Event loop (ISR -> handler events)
+#include "led_fx.h"                // Coroutine LED effects
+#include "anim.h"                  // Keyframe animations
 
 /*******************************************************************************************
  *                                       Macros
  *******************************************************************************************/
 #define CMD_BUFFER_SIZE 64 /*!< Maximum number of characters allowed in UART command buffer */
+#define CMD_LINE_BUFFERS 2 /*!< Lines the ISR can fill while the previous one is processed */
+#define TERMINAL_SESSIONS 2    /*!< Command terminals: USART2 (ST-LINK) and USART1 (PA9/PA10) */
+#define TERMINAL_BAUD 115200UL /*!< Baud rate of every terminal                               */
+#define TERMINAL_FRAME_BUFFERS 2 /*!< Binary frames the ISR can fill while one is processed */
+#define TERMINAL_BAUD_CONFIRM_MS 5000U /*!< Enter must confirm BAUD or lock BAUD AUTO within this */
+#define TERMINAL_ECHO_HOLD_MS 20U /*!< Echo waits this long for the rest of a line (text mode) */
+#define TERMINAL_NOTIFY_MIN_MS 100U  /*!< Shortest gap between two pushes of one subscription  */
+#define TERMINAL_NOTIFY_MAX_MS 60000U /*!< Longest SUBSCRIBE period                             */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Status code that ends every reply in compact mode ("MODE COMPACT")
+ */
+typedef enum
+{
+    REPLY_OK = 0U,      /*!< Command executed                          */
+    REPLY_UNKNOWN = 1U, /*!< Command not recognized                    */
+    REPLY_INVALID = 2U, /*!< Argument missing or out of range          */
+    REPLY_FAILED = 3U   /*!< Valid, but not possible now (no resource) */
+} Reply_Status_t;
 
 /*******************************************************************************************
  *                                   Function Prototypes
  *******************************************************************************************/
 
 /**
- * @brief  Initialize USART2 terminal interface.
+ * @brief  Initialize the USART terminal interfaces.
  *
  * @details
- * Configures USART2 (PA2 TX / PA3 RX) for 115200 baud communication.
- * Sends terminal header, performs optional delay or input sync,
- * and prepares the device for interactive command entry.
+ * Opens USART2 (PA2 TX / PA3 RX) and USART1 (PA9 TX / PA10 RX) at TERMINAL_BAUD.
+ * Sends the terminal header on each and leaves USART2 as the console, so boot
+ * messages go to the ST-LINK virtual COM port.
  */
 void usart_terminal_init(void);
 
+/**
+ * @brief  Register the terminal event handlers and switch the terminal USARTs to interrupts.
+ *
+ * @details
+ * Must be called after event_loop_init(). From then on received characters are
+ * echoed and assembled into lines by each terminal's USART ISR, and each completed line
+ * is posted as EVT_RX_LINE_READY to be parsed by process_cmd() in the event loop, with
+ * the console switched to the terminal that sent it.
+ */
+void terminal_start(void);
+
+/**
+ * @brief  Terminal receive callback (USART ISR context).
+ *
+ * @param  context  Terminal session
+ * @param  c        Received character
+ *
+ * @details
+ * Echoes the character (text mode only) and stores it in the active line buffer. The echo
+ * is held back until the line's reply or a TERMINAL_ECHO_HOLD_MS pause, so a line sent in
+ * one burst is answered with a single transmission. CR or LF completes
+ * the line and posts EVT_RX_LINE_READY; characters arriving while every line buffer
+ * is still waiting to be processed are dropped. A zero byte starts a binary frame
+ * (led_proto.h), collected without echo up to the next zero and posted as
+ * EVT_RX_FRAME_READY.
+ */
+void terminal_rx_char(void *context, char c);
+
+/**
+ * @brief  Terminal transmit complete callback (USART ISR context), posts EVT_TX_DONE.
+ *
+ * @param  context  Terminal session
+ */
+void terminal_tx_done(void *context);
+
 /**
  * @brief  Initialize user LED on PC5 as GPIO output.
  *
@@ -106,6 +167,48 @@ void led2_process_cmd(const char *cmd);
  */
 void led3_process_cmd(const char *cmd);
 
+/**
+ * @brief  Process "ANIM ..." commands (start, stop and query animations).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void anim_process_cmd(const char *cmd);
+
+/**
+ * @brief  Process "STRIP ..." commands (WS2812 strip length, fill and status).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void strip_process_cmd(const char *cmd);
+
+/**
+ * @brief  Process "APA ..." commands (APA102 strip length, fill and status).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void apa_process_cmd(const char *cmd);
+
+/**
+ * @brief  Process "FB ..." commands (LED frame buffer counters).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void fb_process_cmd(const char *cmd);
+
+/**
+ * @brief  Process "TRACE ..." commands (dump, start, stop and clear the event trace).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void trace_process_cmd(const char *cmd);
+
+/**
+ * @brief  Process "CRASH ..." commands (report, clear and test the crash record).
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ */
+void crash_process_cmd(const char *cmd);
+
 /**
  * @brief  Process and execute received UART command.
  *
@@ -128,4 +231,133 @@ void process_cmd(const char *cmd);
  */
 void check_led1_state(GPIO_TypeDef *GPIOx, GPIO_Pins_t pin);
 
+/**
+ * @brief  Replace the effect running on an output with a new one.
+ *
+ * @param type    Effect script to start
+ * @param out     Output driven by the effect
+ * @param arg     Null-terminated period argument in ms (1-FX_PERIOD_MAX)
+ * @details
+ * Parses the period, stops any effect already driving the output and starts the new
+ * one. Prints the outcome to the terminal.
+ */
+void start_effect_cmd(Fx_Type_t type, LED_Output_t out, const char *arg);
+
+/**
+ * @brief  Parse an output name ("LED1" or "LED2") at the start of an argument.
+ *
+ * @param arg     Argument text
+ * @param out     Set to the matching output
+ * @return 0 on success, -1 if the name is not an output
+ */
+int parse_output(const char *arg, LED_Output_t *out);
+
+/**
+ * @brief  Stop every effect and animation driving an output.
+ *
+ * @param out     Output handed over to a new owner
+ */
+void release_output(LED_Output_t out);
+
+/**
+ * @brief  Benchmark the Q15 DSP kernels ("DSP BENCH") and print cycles per channel.
+ */
+void dsp_bench_cmd(void);
+
+/**
+ * @brief  Print stack and static pool high-water marks ("MEM").
+ */
+void mem_cmd(void);
+
+/**
+ * @brief  Print posted, dropped and handler cycle counts per event type ("EVENTS").
+ */
+void events_cmd(void);
+
+/**
+ * @brief  Print boot time, context switch cost, CPU load and per-interrupt shares over
+ *         1 s and 10 s ("PERF").
+ */
+void perf_cmd(void);
+
+/**
+ * @brief  Print the memory pool and scratch arena counters ("POOL").
+ */
+void pool_cmd(void);
+
+/**
+ * @brief  Print one line per command terminal ("TERM").
+ */
+void term_cmd(void);
+
+/**
+ * @brief  Print the flash image CRC check ("IMAGE").
+ */
+void image_cmd(void);
+
+/**
+ * @brief  Show or switch the response mode of the issuing terminal ("MODE").
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ *
+ * @details
+ * "MODE TEXT" (default): characters are echoed, replies are verbose and end with the
+ * prompt. "MODE COMPACT", for machine clients: no echo and no prompt; acknowledgements
+ * and error texts are left out and every reply ends with "\n<code>\r", a Reply_Status_t.
+ * Commands that report data still send it before the code.
+ */
+void mode_cmd(const char *cmd);
+
+/**
+ * @brief  Send an acknowledgement line that carries no data (omitted in compact mode).
+ *
+ * @param  text  Reply line
+ */
+void reply_ack(const char *text);
+
+/**
+ * @brief  Report a failed command: the text in text mode, the status code in compact mode.
+ *
+ * @param  status  Code for the compact reply
+ * @param  text    Reply line (in compact mode the rest of the reply is discarded too)
+ */
+void reply_error(Reply_Status_t status, const char *text);
+
+/**
+ * @brief  Show or change the baud rate of the issuing terminal ("BAUD").
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ *
+ * @details
+ * "BAUD" prints the rate. "BAUD <rate>" switches once the reply has been sent; an empty
+ * line (Enter) at the new rate within TERMINAL_BAUD_CONFIRM_MS keeps it, otherwise the
+ * old rate returns. "BAUD AUTO" hunts for the rate the host sends Enter at, stepping
+ * through the standard rates of bare_usart_autobaud(); if no Enter locks a rate within
+ * TERMINAL_BAUD_CONFIRM_MS, the old rate returns the same way.
+ */
+void baud_cmd(const char *cmd);
+
+/**
+ * @brief  Subscribe the issuing terminal to state pushes ("SUBSCRIBE", "UNSUBSCRIBE").
+ *
+ * @param  cmd  Null-terminated string received from terminal.
+ *
+ * @details
+ * "SUBSCRIBE <LED1|LED2|COUNTERS|ALL>" pushes a topic when it changes, at most once per
+ * TERMINAL_NOTIFY_MIN_MS (the latest value is sent when the hold-off ends).
+ * "SUBSCRIBE <topic> <ms>" pushes it every <ms> instead (TERMINAL_NOTIFY_MIN_MS to
+ * TERMINAL_NOTIFY_MAX_MS). The current state is pushed right after the reply. Pushes
+ * start with '@': "@LED1 ON", "@LED2 <duty>%", "@COUNTERS CMDS <n> FRAMES <n> NAKS <n>"
+ * (summed over every terminal); in text mode each is followed by the prompt. "SUBSCRIBE"
+ * lists the subscriptions, "UNSUBSCRIBE [topic|ALL]" ends them (all without a topic).
+ */
+void subscribe_cmd(const char *cmd);
+
+/**
+ * @brief  Print a value given in hundredths with two decimals.
+ *
+ * @param centi   Value x 100
+ */
+void send_centi(uint32_t centi);
+
 #endif /* MAIN_FUNCTIONS_H_ */
@@ -0,0 +1,187 @@
+/*******************************************************************************************
+ * @file    mem_pool.h
+ * @author  ka5j
+ * @brief   Fixed-block pools and a bump arena replacing the heap (bare metal)
+ * @version 1.0
+ * @date    2025-06-25
+ *
+ * @details
+ * Runtime objects come from statically sized pools instead of malloc: no fragmentation,
+ * and allocation and release are O(1) with a bounded critical section. A pool's free
+ * blocks are kept as a stack of block indices next to the blocks, so the allocator never
+ * writes into a block and any block size or alignment works. Blocks are handed out
+ * uninitialized, lowest index first on a fresh pool.
+ *
+ * Pool storage is placed in the .pools section and the scratch arena in .arena, both
+ * NOLOAD regions of the linker script (not zeroed at boot). The scratch arena holds
+ * command-lifetime buffers: it is a bump allocator that process_cmd() resets after every
+ * command.
+ *
+ * Every failed allocation is counted; the POOL command prints the counters of each pool
+ * and of the arena.
+ *******************************************************************************************/
+
+#ifndef MEM_POOL_H_
+#define MEM_POOL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define MEM_MAX_POOLS 8U             /*!< Pools listed by the diagnostics           */
+#define MEM_ARENA_ALIGN 8U           /*!< Alignment of every arena allocation       */
+#define MEM_SCRATCH_HOST_BYTES 4096U /*!< Scratch arena size on HOST_BUILD (no .ld) */
+
+/**
+ * @brief  Define a pool of `count` blocks of `type` with its storage in .pools.
+ *
+ * @note   Expands to static definitions; pass the pool to mem_pool_init() before use.
+ */
+#define MEM_POOL_DEFINE(var, label, type, count)                                        \
+    static type var##_blocks[(count)] __attribute__((section(".pools")));               \
+    static uint16_t var##_free[(count)] __attribute__((section(".pools")));             \
+    static Mem_Pool_t var = {(label), (uint8_t *)var##_blocks, var##_free, sizeof(type), \
+                             (count), 0, 0, 0, 0}
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Fixed-block pool
+ */
+typedef struct
+{
+    const char *name;      /*!< Label printed by the diagnostics               */
+    uint8_t *blocks;       /*!< capacity blocks of block_size bytes            */
+    uint16_t *free_stack;  /*!< Indices of free blocks, top at free_count - 1  */
+    uint16_t block_size;   /*!< Bytes per block                                */
+    uint16_t capacity;     /*!< Number of blocks                               */
+    uint16_t free_count;   /*!< Blocks available                               */
+    uint16_t high_water;   /*!< Most blocks in use at once                     */
+    uint32_t allocs;       /*!< Successful allocations                         */
+    uint32_t exhausted;    /*!< Allocations refused because the pool was empty */
+} Mem_Pool_t;
+
+/**
+ * @brief Bump arena
+ */
+typedef struct
+{
+    const char *name;    /*!< Label printed by the diagnostics        */
+    uint8_t *base;       /*!< First byte (MEM_ARENA_ALIGN aligned)    */
+    uint32_t size;       /*!< Bytes                                   */
+    uint32_t used;       /*!< Bytes handed out since the last reset   */
+    uint32_t high_water; /*!< Most bytes in use at once               */
+    uint32_t allocs;     /*!< Successful allocations                  */
+    uint32_t exhausted;  /*!< Allocations refused for lack of space   */
+} Mem_Arena_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Set up the scratch arena over the .arena region of the linker script.
+ */
+void mem_init(void);
+
+/**
+ * @brief  Mark every block of a pool free and list the pool in the diagnostics.
+ *
+ * @param  pool  Pool defined with MEM_POOL_DEFINE()
+ */
+void mem_pool_init(Mem_Pool_t *pool);
+
+/**
+ * @brief  Take a block (thread or ISR context up to CRIT_CEILING_POOL).
+ *
+ * @param  pool  Pool
+ * @return Uninitialized block, or NULL if the pool is exhausted
+ */
+void *mem_pool_alloc(Mem_Pool_t *pool);
+
+/**
+ * @brief  Return a block to its pool. Pointers that are not a block of the pool are ignored.
+ *
+ * @param  pool   Pool
+ * @param  block  Block from mem_pool_alloc()
+ */
+void mem_pool_free(Mem_Pool_t *pool, void *block);
+
+/**
+ * @brief  Get the number of blocks in use.
+ *
+ * @param  pool  Pool
+ * @return Blocks allocated and not yet freed
+ */
+uint32_t mem_pool_in_use(const Mem_Pool_t *pool);
+
+/**
+ * @brief  Get a listed pool for the diagnostics.
+ *
+ * @param  index  0 to the number of initialized pools - 1
+ * @return Pool, or NULL past the last one
+ */
+const Mem_Pool_t *mem_pool_get(uint32_t index);
+
+/**
+ * @brief  Get the address of a block from its index.
+ *
+ * @param  pool   Pool
+ * @param  index  Block index (< capacity)
+ * @return Block address
+ */
+static inline void *mem_pool_block(const Mem_Pool_t *pool, uint32_t index)
+{
+    return pool->blocks + index * pool->block_size;
+}
+
+/**
+ * @brief  Get the index of a block.
+ *
+ * @param  pool   Pool
+ * @param  block  Block of the pool
+ * @return Block index
+ */
+static inline uint32_t mem_pool_index(const Mem_Pool_t *pool, const void *block)
+{
+    return (uint32_t)((const uint8_t *)block - pool->blocks) / pool->block_size;
+}
+
+/**
+ * @brief  Carve an arena out of a buffer.
+ *
+ * @param  arena  Arena to set up
+ * @param  name   Label printed by the diagnostics
+ * @param  base   Buffer (MEM_ARENA_ALIGN aligned)
+ * @param  size   Buffer size in bytes
+ */
+void mem_arena_init(Mem_Arena_t *arena, const char *name, void *base, uint32_t size);
+
+/**
+ * @brief  Allocate from an arena (thread or ISR context up to CRIT_CEILING_POOL).
+ *
+ * @param  arena  Arena
+ * @param  size   Bytes (rounded up to MEM_ARENA_ALIGN)
+ * @return Uninitialized memory, or NULL if the arena is full
+ */
+void *mem_arena_alloc(Mem_Arena_t *arena, uint32_t size);
+
+/**
+ * @brief  Release everything allocated from an arena.
+ *
+ * @param  arena  Arena
+ */
+void mem_arena_reset(Mem_Arena_t *arena);
+
+/**
+ * @brief  Get the scratch arena (command-lifetime buffers).
+ *
+ * @return Scratch arena
+ */
+Mem_Arena_t *mem_scratch(void);
+
+#endif /* MEM_POOL_H_ */
@@ -0,0 +1,52 @@
+/*******************************************************************************************
+ * @file    mpu_registers.h
+ * @author  ka5j
+ * @brief   Cortex-M4 Memory Protection Unit Register Definitions (Bare Metal)
+ * @version 1.0
+ * @date    2025-06-18
+ *
+ * @note    ARMv7-M MPU with 8 regions. This file assumes a 32-bit ARM Cortex-M4 platform
+ *          with no CMSIS dependency.
+ *******************************************************************************************/
+
+#ifndef MPU_REGISTERS_H_
+#define MPU_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h" // Must define CORTEX_M4_PERIPH_BASE
+
+/*******************************************************************************************
+ * MPU Base Address (ARM-defined for Cortex-M4)
+ *******************************************************************************************/
+#define MPU_BASE (CORTEX_M4_PERIPH_BASE + 0xED90UL)
+
+/*******************************************************************************************
+ * MPU Register Structure
+ *******************************************************************************************/
+typedef struct
+{
+    const volatile uint32_t TYPE; /*!< Number of regions (0xD90)        */
+    volatile uint32_t CTRL;       /*!< Enable and default map control   */
+    volatile uint32_t RNR;        /*!< Region number                    */
+    volatile uint32_t RBAR;       /*!< Region base address              */
+    volatile uint32_t RASR;       /*!< Region attributes and size       */
+} MPU_TypeDef;
+
+#define MPU ((MPU_TypeDef *)MPU_BASE)
+
+/*******************************************************************************************
+ * Bit Definitions
+ *******************************************************************************************/
+#define MPU_CTRL_ENABLE (1UL << 0)     /*!< MPU enabled                                   */
+#define MPU_CTRL_PRIVDEFENA (1UL << 2) /*!< Default memory map for privileged accesses     */
+
+#define MPU_RBAR_VALID (1UL << 4)      /*!< Use the REGION field instead of RNR           */
+#define MPU_RBAR_REGION(n) ((uint32_t)(n) & 0xFUL)
+
+#define MPU_RASR_ENABLE (1UL << 0)                          /*!< Region enabled          */
+#define MPU_RASR_SIZE(log2) ((((uint32_t)(log2) - 1UL) & 0x1FUL) << 1) /*!< 2^log2 bytes */
+#define MPU_RASR_AP_NONE (0UL << 24)   /*!< No access, privileged or not                 */
+#define MPU_RASR_AP_FULL (3UL << 24)   /*!< Read/write for everybody                     */
+#define MPU_RASR_XN (1UL << 28)        /*!< Execute never                                */
+
+#endif /* MPU_REGISTERS_H_ */
@@ -0,0 +1,134 @@
+/*******************************************************************************************
+ * @file    perf.h
+ * @author  ka5j
+ * @brief   CPU load accounting: idle time and per-interrupt cycles over 1 s / 10 s windows
+ * @version 1.0
+ * @date    2025-06-19
+ *
+ * @details
+ * Two kinds of free-running cycle counters, each written by one context only:
+ * - idle: the kernel idle task adds the cycles it spends in WFI
+ * - per interrupt: every instrumented ISR adds its entry-to-exit cycles. The time is
+ *   inclusive: a higher-priority ISR that preempts it is counted in both.
+ * Every 1000 SysTick ticks perf_tick() stores the counter deltas of the last second in
+ * a ring of PERF_HISTORY_SECONDS one-second windows; longer windows are sums of them.
+ *
+ * Cycles come from bare_dwt_get_cycles(), i.e. the virtual clock on HOST_BUILD.
+ *
+ * Reset_Handler starts the DWT cycle counter first thing and stores its value in
+ * perf_boot_cycles right before calling main(): the cost of painting the stack, copying
+ * .ramfunc and .data, and zeroing .bss and .dma_bss.
+ *******************************************************************************************/
+
+#ifndef PERF_H_
+#define PERF_H_
+
+#include <stdint.h>
+
+#include "bare_dwt.h" // Cycle counter
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define PERF_WINDOW_TICKS 1000U   /*!< SysTick ticks per one-second window */
+#define PERF_HISTORY_SECONDS 10U  /*!< Longest window                      */
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Instrumented interrupts
+ */
+typedef enum
+{
+    PERF_SRC_SYSTICK = 0U, /*!< System tick, kernel, heartbeat */
+    PERF_SRC_TIM2,         /*!< Animation tick                 */
+    PERF_SRC_USART2,       /*!< Terminal (ST-LINK VCP)         */
+    PERF_SRC_USART1,       /*!< Second terminal                */
+    PERF_SRC_DMA1_S2,      /*!< WS2812 refill                  */
+    PERF_SRC_DMA2_S3,      /*!< APA102 SPI transfer done       */
+    PERF_SRC_COUNT
+} Perf_Source_t;
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Cycle totals of a window
+ */
+typedef struct
+{
+    uint32_t seconds;                /*!< Complete seconds summed (0 right after boot) */
+    uint32_t elapsed;                /*!< Cycles in the window                         */
+    uint32_t idle;                   /*!< Cycles spent in the idle task's WFI          */
+    uint32_t isr[PERF_SRC_COUNT];    /*!< Cycles spent in each interrupt               */
+} Perf_Window_t;
+
+/*******************************************************************************************
+ *                    Counters (written by the inline ISR hooks)
+ *******************************************************************************************/
+extern volatile uint32_t perf_isr_cycles[PERF_SRC_COUNT];
+
+/*******************************************************************************************
+ *                   Boot Time (written by Reset_Handler before main())
+ *******************************************************************************************/
+extern uint32_t perf_boot_cycles; /*!< Cycles from reset to main(), 0 on HOST_BUILD */
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Mark the start of an ISR.
+ *
+ * @return Timestamp to hand to perf_isr_exit()
+ */
+static inline uint32_t perf_isr_enter(void)
+{
+    return bare_dwt_get_cycles();
+}
+
+/**
+ * @brief  Account the cycles of an ISR (call last in the handler).
+ *
+ * @param  src    Interrupt
+ * @param  start  Value returned by perf_isr_enter()
+ */
+static inline void perf_isr_exit(Perf_Source_t src, uint32_t start)
+{
+    perf_isr_cycles[src] += bare_dwt_get_cycles() - start;
+}
+
+/**
+ * @brief  Account cycles spent idle (idle task only).
+ *
+ * @param  cycles  Cycles spent sleeping
+ */
+void perf_idle_add(uint32_t cycles);
+
+/**
+ * @brief  Close a one-second window every PERF_WINDOW_TICKS ticks (SysTick context).
+ *
+ * @param  ticks  Current SysTick tick count
+ */
+void perf_tick(uint32_t ticks);
+
+/**
+ * @brief  Sum the most recent complete one-second windows.
+ *
+ * @param  seconds  Window length, 1 to PERF_HISTORY_SECONDS
+ * @param  out      Totals (out->seconds may be less than requested after boot)
+ */
+void perf_get_window(uint32_t seconds, Perf_Window_t *out);
+
+/**
+ * @brief  Get the short name of an interrupt.
+ *
+ * @param  src  Interrupt
+ * @return Upper-case name
+ */
+const char *perf_source_name(Perf_Source_t src);
+
+#endif /* PERF_H_ */
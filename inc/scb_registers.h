@@ -0,0 +1,79 @@
+/*******************************************************************************************
+ * @file    scb_registers.h
+ * @author  ka5j
+ * @brief   Cortex-M4 System Control Block Register Definitions (Bare Metal)
+ * @version 1.0
+ * @date    2025-06-04
+ *
+ * @note    This file defines memory-mapped register access for the SCB (system exception
+ *          control, fault status, coprocessor access). Assumes 32-bit ARM Cortex-M4
+ *          platform with no CMSIS dependency.
+ *******************************************************************************************/
+
+#ifndef SCB_REGISTERS_H_
+#define SCB_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h" // Must define CORTEX_M4_PERIPH_BASE
+
+/*******************************************************************************************
+ * SCB Base Address (ARM-defined for Cortex-M4)
+ *******************************************************************************************/
+#define SCB_BASE (CORTEX_M4_PERIPH_BASE + 0xED00UL)
+
+/*******************************************************************************************
+ * SCB Register Structure
+ *******************************************************************************************/
+typedef struct
+{
+    const volatile uint32_t CPUID; /*!< CPUID base register (0xD00)                    */
+    volatile uint32_t ICSR;        /*!< Interrupt control and state register           */
+    volatile uint32_t VTOR;        /*!< Vector table offset register                   */
+    volatile uint32_t AIRCR;       /*!< Application interrupt and reset control        */
+    volatile uint32_t SCR;         /*!< System control register                        */
+    volatile uint32_t CCR;         /*!< Configuration and control register             */
+    volatile uint8_t SHPR[12];     /*!< System handler priorities (exceptions 4 - 15)  */
+    volatile uint32_t SHCSR;       /*!< System handler control and state register      */
+    volatile uint32_t CFSR;        /*!< Configurable fault status register             */
+    volatile uint32_t HFSR;        /*!< HardFault status register                      */
+    volatile uint32_t DFSR;        /*!< Debug fault status register                    */
+    volatile uint32_t MMFAR;       /*!< MemManage fault address register               */
+    volatile uint32_t BFAR;        /*!< BusFault address register                      */
+    volatile uint32_t AFSR;        /*!< Auxiliary fault status register               */
+    const volatile uint32_t PFR[2];  /*!< Processor feature registers                  */
+    const volatile uint32_t DFR;     /*!< Debug feature register                       */
+    const volatile uint32_t ADR;     /*!< Auxiliary feature register                   */
+    const volatile uint32_t MMFR[4]; /*!< Memory model feature registers               */
+    const volatile uint32_t ISAR[5]; /*!< Instruction set attribute registers          */
+    uint32_t RESERVED0[5];
+    volatile uint32_t CPACR;       /*!< Coprocessor access control register (0xD88)    */
+} SCB_TypeDef;
+
+#define SCB ((SCB_TypeDef *)SCB_BASE)
+
+/*******************************************************************************************
+ * Bit Definitions
+ *******************************************************************************************/
+#define SCB_ICSR_PENDSVSET (1UL << 28)  /*!< Set PendSV pending                      */
+#define SCB_AIRCR_VECTKEY (0x05FAUL << 16) /*!< Key required for AIRCR writes        */
+#define SCB_AIRCR_SYSRESETREQ (1UL << 2) /*!< Request a system reset                 */
+#define SCB_AIRCR_PRIGROUP_MASK (7UL << 8) /*!< Priority grouping field             */
+#define SCB_CCR_DIV_0_TRP (1UL << 4)    /*!< UsageFault on integer divide by zero    */
+#define SCB_SHCSR_MEMFAULTENA (1UL << 16) /*!< Enable MemManage fault               */
+#define SCB_SHCSR_BUSFAULTENA (1UL << 17) /*!< Enable BusFault                      */
+#define SCB_SHCSR_USGFAULTENA (1UL << 18) /*!< Enable UsageFault                    */
+#define SCB_CFSR_MMARVALID (1UL << 7)   /*!< MMFAR holds the faulting address        */
+#define SCB_CFSR_BFARVALID (1UL << 15)  /*!< BFAR holds the faulting address         */
+
+/*******************************************************************************************
+ * System Handler Priority Indexes (SHPR[exception number - 4])
+ *******************************************************************************************/
+#define SCB_SHPR_MEMMANAGE 0U
+#define SCB_SHPR_BUSFAULT 1U
+#define SCB_SHPR_USAGEFAULT 2U
+#define SCB_SHPR_SVCALL 7U
+#define SCB_SHPR_DEBUGMON 8U
+#define SCB_SHPR_PENDSV 10U
+#define SCB_SHPR_SYSTICK 11U
+
+#endif /* SCB_REGISTERS_H_ */
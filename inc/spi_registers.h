@@ -0,0 +1,50 @@
+/*******************************************************************************************
+ * @file    spi_registers.h
+ * @author  ka5j
+ * @brief   STM32F446RE SPI Device Memory-Mapped Register Definitions (Bare Metal)
+ * @version 1.0
+ * @date    2025-06-14
+ *
+ * @note    Only memory-mapped register definitions for SPI peripherals.
+ *          This file assumes a 32-bit embedded platform and no CMSIS dependency.
+ *******************************************************************************************/
+
+#ifndef SPI_REGISTERS_H_
+#define SPI_REGISTERS_H_
+
+#include <stdint.h>
+#include "stm32f446re_addresses.h"
+
+/*******************************************************************************************
+ * SPI Base Addresses
+ *******************************************************************************************/
+#define SPI1_BASE (APB2PERIPH_BASE + 0x3000UL)
+#define SPI2_BASE (APB1PERIPH_BASE + 0x3800UL)
+#define SPI3_BASE (APB1PERIPH_BASE + 0x3C00UL)
+#define SPI4_BASE (APB2PERIPH_BASE + 0x3400UL)
+
+/*******************************************************************************************
+ * SPI Register Definition
+ *******************************************************************************************/
+typedef struct
+{
+    volatile uint32_t CR1;     /*!< Control register 1                   */
+    volatile uint32_t CR2;     /*!< Control register 2                   */
+    volatile uint32_t SR;      /*!< Status register                      */
+    volatile uint32_t DR;      /*!< Data register                        */
+    volatile uint32_t CRCPR;   /*!< CRC polynomial register              */
+    volatile uint32_t RXCRCR;  /*!< RX CRC register                      */
+    volatile uint32_t TXCRCR;  /*!< TX CRC register                      */
+    volatile uint32_t I2SCFGR; /*!< I2S configuration register           */
+    volatile uint32_t I2SPR;   /*!< I2S prescaler register               */
+} SPI_TypeDef;
+
+/*******************************************************************************************
+ * SPI Peripheral Definitions
+ *******************************************************************************************/
+#define SPI1 ((SPI_TypeDef *)SPI1_BASE)
+#define SPI2 ((SPI_TypeDef *)SPI2_BASE)
+#define SPI3 ((SPI_TypeDef *)SPI3_BASE)
+#define SPI4 ((SPI_TypeDef *)SPI4_BASE)
+
+#endif /* SPI_REGISTERS_H_ */
@@ -0,0 +1,92 @@
+/*******************************************************************************************
+ * @file    stack_check.h
+ * @author  ka5j
+ * @brief   Stack painting, high-water marks and MPU guards below the main and task stacks
+ * @version 1.0
+ * @date    2025-06-18
+ *
+ * @details
+ * Reset_Handler paints the main stack (MSP, used by main() and every ISR) with
+ * STACK_PAINT_WORD before anything runs on it; the kernel paints each task stack when
+ * the task is created. The high-water mark of a stack is the distance from its top to
+ * the lowest word that no longer holds the paint.
+ *
+ * MPU region STACK_GUARD_REGION covers the STACK_GUARD_BYTES just below the main stack
+ * (_sguard in the linker script) with no access. An overflow then raises a MemManage
+ * fault on the first access, which is captured in the crash record, instead of silently
+ * overwriting .bss.
+ *
+ * Task stacks get the same guard from region STACK_TASK_GUARD_REGION. The kernel keeps
+ * the lowest STACK_GUARD_BYTES of every task stack as its guard and PendSV moves the
+ * region to the incoming task on each switch: a task can only overflow while it runs,
+ * so arming the running task's guard is enough. The guard lies below the TCB's
+ * stack_base, outside the painted range that the high-water scan reads.
+ *******************************************************************************************/
+
+#ifndef STACK_CHECK_H_
+#define STACK_CHECK_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define STACK_PAINT_WORD 0xA5A5A5A5UL /*!< Must match the paint in Reset_Handler       */
+#define STACK_GUARD_BYTES 32U         /*!< Must match _Stack_Guard_Size (linker script) */
+#define STACK_GUARD_REGION 0U         /*!< MPU region used for the main stack guard     */
+#define STACK_TASK_GUARD_REGION 1U    /*!< MPU region used for the running task's guard */
+#define STACK_GUARD_WORDS (STACK_GUARD_BYTES / 4U) /*!< Guard size in words         */
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Enable the MPU with the no-access guard region below the main stack.
+ *
+ * @note   Every other address keeps the default memory map (PRIVDEFENA).
+ */
+void stack_check_init(void);
+
+/**
+ * @brief  Move the task guard region below a task stack (PendSV context).
+ *
+ * @param  base  Lowest usable address of the task stack; the STACK_GUARD_BYTES below it
+ *               must be reserved for the guard and aligned to STACK_GUARD_BYTES
+ *
+ * @note   The caller's exception return makes the new region take effect.
+ */
+void stack_check_guard_task(const uint32_t *base);
+
+/**
+ * @brief  Paint a stack (used by the kernel for task stacks).
+ *
+ * @param  base   Lowest address of the stack
+ * @param  words  Stack size in words
+ */
+void stack_check_paint(uint32_t *base, uint32_t words);
+
+/**
+ * @brief  Get the deepest use of a painted stack.
+ *
+ * @param  base   Lowest address of the stack
+ * @param  words  Stack size in words
+ * @return Bytes used at the high-water mark
+ */
+uint32_t stack_check_high_water(const uint32_t *base, uint32_t words);
+
+/**
+ * @brief  Get the size of the main stack.
+ *
+ * @return Main stack size in bytes (_Min_Stack_Size)
+ */
+uint32_t stack_check_main_size(void);
+
+/**
+ * @brief  Get the deepest use of the main stack.
+ *
+ * @return Bytes used at the high-water mark
+ */
+uint32_t stack_check_main_high_water(void);
+
+#endif /* STACK_CHECK_H_ */
@@ -2,10 +2,11 @@
  * @file    stm32f446re_addresses.h
  * @author  ka5j
  * @brief   STM32F446RE Device Memory-Mapped Addresses (Bare Metal)
- * @version 1.1
+ * @version 1.2
  * @date    2025-05-01
  *
- * @note    Only memory-mapped register addresses for core and peripheral modules.
+ * @note    Only memory-mapped register addresses for core and peripheral modules, and
+ *          the attributes placing code and data in the RAM regions of the linker script.
  *          This file assumes a 32-bit embedded platform and no CMSIS dependency.
  *******************************************************************************************/
 
@@ -19,6 +20,24 @@
  *******************************************************************************************/
 #define CORTEX_M4_PERIPH_BASE     (0xE0000000UL)
 
+ /*******************************************************************************************
+ * Memory Base Addresses
+ *******************************************************************************************/
+#define FLASH_BASE                (0x08000000UL)
+#define SRAM1_BASE                (0x20000000UL) /*!< 112 KB */
+#define SRAM2_BASE                (0x2001C000UL) /*!< 16 KB  */
+
+ /*******************************************************************************************
+ * Linker Script Placement (STM32F446RETX_FLASH.ld)
+ *******************************************************************************************/
+#ifdef HOST_BUILD
+#define RAMFUNC
+#define DMA_BSS
+#else
+#define RAMFUNC __attribute__((section(".ramfunc"), noinline)) /*!< Runs from SRAM1          */
+#define DMA_BSS __attribute__((section(".dma_bss")))           /*!< Zeroed, in SRAM2 for DMA */
+#endif
+
  /*******************************************************************************************
  * Bus Peripheral Base Addresses
  *******************************************************************************************/
@@ -0,0 +1,151 @@
+/*******************************************************************************************
+ * @file    trace.h
+ * @author  ka5j
+ * @brief   RAM-resident binary event trace (lock-free, ISR safe)
+ * @version 1.0
+ * @date    2025-06-16
+ *
+ * @details
+ * Every event is two words: the DWT cycle count and a packed (id << 24 | data) word.
+ * Writers claim a slot with one atomic increment (LDREX/STREX) of the head index, then
+ * store both words, so ISRs of any priority and thread code can record without masking
+ * interrupts. The ring holds the last TRACE_DEPTH events and overwrites the oldest.
+ *
+ * A writer preempted between claiming and filling its slot leaves the slot stale until it
+ * resumes. trace_dump() stops recording first and runs in thread context, after every
+ * preempting ISR has finished, so the dumped ring is always consistent.
+ *
+ * Dump format (hex text, so the terminal stays usable; tools/trace_decode.py decodes it):
+ *   TRACE BEGIN <count> <cpu_hz>
+ *   <cycles:8 hex><word:8 hex> ... (4 events per line, oldest first)
+ *   TRACE END <dropped>
+ *******************************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#include "dwt_registers.h" // DWT cycle counter
+#include "bare_dwt.h"       // Virtual cycle counter (HOST_BUILD)
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define TRACE_DEPTH 256U /*!< Events in the ring (power of two, 8 bytes each) */
+
+#ifdef HOST_BUILD
+#define TRACE_CYCLES() bare_dwt_get_cycles()
+#else
+#define TRACE_CYCLES() (DWT->CYCCNT) /*!< Inline read, no call */
+#endif
+
+/*******************************************************************************************
+ *                                     Enumerations
+ *******************************************************************************************/
+
+/**
+ * @brief Event ids (top byte of the event word)
+ */
+typedef enum
+{
+    TRACE_EVT_ISR_ENTER = 1U, /*!< data: source << 16                         */
+    TRACE_EVT_ISR_EXIT = 2U,  /*!< data: source << 16 | source-specific value */
+    TRACE_EVT_CMD_START = 3U, /*!< data: first 3 characters of the command    */
+    TRACE_EVT_CMD_END = 4U,   /*!< data: 0                                    */
+    TRACE_EVT_QUEUE = 5U,     /*!< data: queue << 16 | depth                  */
+} Trace_Event_t;
+
+/**
+ * @brief Interrupt sources
+ */
+typedef enum
+{
+    TRACE_SRC_SYSTICK = 0U, /*!< SysTick, exit value: tick count (low 16 bits) */
+    TRACE_SRC_TIM2 = 1U,    /*!< Animation tick                                */
+    TRACE_SRC_USART2 = 2U,  /*!< Terminal, exit value: bytes in the TX ring    */
+    TRACE_SRC_USART1 = 3U,  /*!< Second terminal, exit value as USART2         */
+} Trace_Source_t;
+
+/**
+ * @brief Queues reported by TRACE_EVT_QUEUE
+ */
+typedef enum
+{
+    TRACE_QUEUE_EVT_HIGH = 0U,   /*!< Event loop, high priority   */
+    TRACE_QUEUE_EVT_NORMAL = 1U, /*!< Event loop, normal priority */
+    TRACE_QUEUE_EVT_LOW = 2U,    /*!< Event loop, low priority    */
+} Trace_Queue_t;
+
+/*******************************************************************************************
+ *                          Ring State (written by the inline recorders)
+ *******************************************************************************************/
+extern uint32_t trace_ring[TRACE_DEPTH][2];
+extern volatile uint32_t trace_head;
+extern volatile uint8_t trace_enabled;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Record one event (any context, about 15 cycles).
+ *
+ * @param  id    Event id
+ * @param  data  Event data, 24 bits
+ */
+static inline void trace_event(Trace_Event_t id, uint32_t data)
+{
+    if (!trace_enabled)
+    {
+        return;
+    }
+
+    uint32_t slot = __atomic_fetch_add(&trace_head, 1U, __ATOMIC_RELAXED) & (TRACE_DEPTH - 1U);
+    trace_ring[slot][0] = TRACE_CYCLES();
+    trace_ring[slot][1] = ((uint32_t)id << 24) | (data & 0x00FFFFFFUL);
+}
+
+/**
+ * @brief  Record an ISR entry.
+ *
+ * @param  src  Interrupt source
+ */
+static inline void trace_isr_enter(Trace_Source_t src)
+{
+    trace_event(TRACE_EVT_ISR_ENTER, (uint32_t)src << 16);
+}
+
+/**
+ * @brief  Record an ISR exit.
+ *
+ * @param  src    Interrupt source
+ * @param  value  Source-specific value (16 bits)
+ */
+static inline void trace_isr_exit(Trace_Source_t src, uint32_t value)
+{
+    trace_event(TRACE_EVT_ISR_EXIT, ((uint32_t)src << 16) | (value & 0xFFFFU));
+}
+
+/**
+ * @brief  Start or stop recording.
+ *
+ * @param  enable  1 to record, 0 to freeze the ring
+ */
+void trace_enable(uint8_t enable);
+
+/**
+ * @brief  Discard every recorded event.
+ */
+void trace_clear(void);
+
+/**
+ * @brief  Stream the ring to the terminal, oldest event first (thread context).
+ *
+ * @details
+ * Recording is stopped during the dump (otherwise the USART ISR would trace its own
+ * output) and restored afterwards.
+ */
+void trace_dump(void);
+
+#endif /* TRACE_H_ */
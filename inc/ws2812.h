@@ -0,0 +1,138 @@
+/*******************************************************************************************
+ * @file    ws2812.h
+ * @author  ka5j
+ * @brief   WS2812/SK6812 addressable LED strip driver (TIM3 PWM + DMA1, bare metal)
+ * @version 1.1
+ * @date    2025-06-13
+ *
+ * @details
+ * The strip data line is TIM3 CH1 on PA6 (AF2). TIM3 runs at 16 MHz with a 20-tick
+ * (1.25 us, 800 kHz) period; every update event DMA1 Stream 2 (channel 5, TIM3_UP) loads
+ * the next bit's high time into CCR1.
+ *
+ * Pixels are stored as 3 bytes in wire order (G, R, B) in two frames: ws2812_set_pixel()
+ * writes the back frame while the front frame is shifted out. Only a small circular DMA
+ * buffer of two halves (WS2812_HALF_PIXELS pixels each) holds encoded bit slots; the
+ * half-transfer and transfer-complete interrupts encode the next pixels into the half
+ * that has just been sent. The line is held low for >= 280 us after the last pixel.
+ *
+ * At WS2812_MAX_PIXELS a frame takes about 9.5 ms, i.e. over 100 frames per second.
+ *******************************************************************************************/
+
+#ifndef WS2812_H_
+#define WS2812_H_
+
+#include <stdint.h>
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define WS2812_MAX_PIXELS 300U /*!< Longest supported strip (2 x 3 bytes per pixel) */
+#define WS2812_HALF_PIXELS 8U  /*!< Pixels encoded per DMA half-buffer refill      */
+
+#define WS2812_TIM_CLK_HZ 16000000UL /*!< TIM3 counter clock (APB1 x1, PSC 0) */
+#define WS2812_PERIOD_TICKS 20U      /*!< One bit, 1.25 us                    */
+#define WS2812_T0H_TICKS 6U          /*!< High time of a 0 bit, 375 ns        */
+#define WS2812_T1H_TICKS 11U         /*!< High time of a 1 bit, 687.5 ns      */
+
+/*******************************************************************************************
+ *                                       Types
+ *******************************************************************************************/
+
+/**
+ * @brief Driver statistics
+ */
+typedef struct
+{
+    uint32_t frames;          /*!< Frames completely sent            */
+    uint32_t dma_errors;      /*!< Transfer errors (frame aborted)   */
+    uint32_t isr_last_cycles; /*!< DWT cycles of the last refill ISR */
+    uint32_t isr_max_cycles;  /*!< Worst refill ISR                  */
+} WS2812_Stats_t;
+
+/*******************************************************************************************
+ *                                   Function Prototypes
+ *******************************************************************************************/
+
+/**
+ * @brief  Configure PA6, TIM3 CH1 PWM and DMA1 Stream 2. The line idles low.
+ */
+void ws2812_init(void);
+
+/**
+ * @brief  Set the number of pixels sent per frame.
+ *
+ * @param  count  Pixels on the strip (clamped to WS2812_MAX_PIXELS)
+ */
+void ws2812_set_length(uint32_t count);
+
+/**
+ * @brief  Get the number of pixels sent per frame.
+ *
+ * @return Strip length
+ */
+uint32_t ws2812_get_length(void);
+
+/**
+ * @brief  Set one pixel in the back frame.
+ *
+ * @param  index  Pixel index (ignored if out of range)
+ * @param  r      Red 0-255
+ * @param  g      Green 0-255
+ * @param  b      Blue 0-255
+ */
+void ws2812_set_pixel(uint32_t index, uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief  Set every pixel of the back frame to one color.
+ */
+void ws2812_fill(uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief  Send the back frame to the strip.
+ *
+ * @details
+ * Swaps the frames and starts the DMA. The new back frame is a copy of the frame being
+ * sent, so callers can keep making incremental changes.
+ *
+ * @return 0 on success, -1 if the previous frame is still being sent
+ */
+int ws2812_show(void);
+
+/**
+ * @brief  Send only the first pixels of the back frame.
+ *
+ * @details
+ * Pixels are shifted through the strip, so an update of pixels [lo, hi) must clock out
+ * pixels 0 to hi - 1; the strip keeps showing the pixels after them. Frames are swapped
+ * and copied as in ws2812_show().
+ *
+ * @param  count  Pixels to send (clamped to the strip length)
+ * @return Bytes sent (0 for an empty range), -1 if the previous frame is still being sent
+ */
+int ws2812_show_range(uint32_t count);
+
+/**
+ * @brief  Check whether a frame is being sent.
+ *
+ * @return 1 while the DMA is active, 0 otherwise
+ */
+uint8_t ws2812_busy(void);
+
+/**
+ * @brief  Get the driver statistics.
+ *
+ * @return Pointer to the statistics record
+ */
+const WS2812_Stats_t *ws2812_get_stats(void);
+
+/**
+ * @brief  Encode bytes into PWM bit slots, MSB first (4 word stores per byte).
+ *
+ * @param  slots  Output, 8 CCR values per byte, 4-byte aligned
+ * @param  data   Bytes in wire order
+ * @param  count  Number of bytes
+ */
+void ws2812_encode(uint16_t *slots, const uint8_t *data, uint32_t count);
+
+#endif /* WS2812_H_ */
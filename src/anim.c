@@ -0,0 +1,338 @@
+/*******************************************************************************************
+ * @file    anim.c
+ * @author  ka5j
+ * @brief   Keyframe animation engine with incremental fixed-point evaluation
+ * @version 1.0
+ * @date    2025-06-11
+ *
+ * @details
+ * Levels are held in Q8.24 (ANIM_Q24_ONE = 100 %), which leaves room for a per-tick delta
+ * even on the longest segment (65535 ms) without losing resolution. All divisions happen in
+ * anim_start(); the TIM2 ISR only adds, counts down and, at a segment boundary, reloads the
+ * exact start level of the next segment so rounding errors never accumulate.
+ *
+ * Channels are written by the terminal task and read by the TIM2 ISR, which preempts it.
+ * A channel is taken offline by clearing its active byte, rebuilt, then published again
+ * with a release store, so no lock is needed.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "anim.h"
+#include "led_output.h"
+#include "led_fb.h"           // Incremental output commit
+#include "tim2_5_registers.h" // TIM2 register definitions
+#include "bare_tim2_5.h"      // TIM2-TIM5 (bare-metal)
+#include "bare_dwt.h"         // Per-tick cycle cost
+#include "trace.h"            // Event trace
+#include "perf.h"             // CPU load accounting
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define ANIM_Q24_ONE (1UL << 24)               /*!< 100 % in the Q8.24 accumulator      */
+#define ANIM_MAX_SEGMENTS (ANIM_MAX_KEYFRAMES - 1U)
+#define ANIM_MIN_PERIOD_MS 20U                 /*!< Shortest preset period              */
+#define TIM_SR_UIF (1U << 0)                   /*!< TIMx update interrupt flag          */
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief One compiled linear segment
+ */
+typedef struct
+{
+    int32_t start;  /*!< Level at the first tick, Q8.24 */
+    int32_t delta;  /*!< Added every tick, Q8.24        */
+    uint32_t steps; /*!< Segment length in ticks (ms)   */
+} Anim_Segment_t;
+
+/**
+ * @brief Animation state of one output
+ */
+typedef struct
+{
+    Anim_Segment_t seg[ANIM_MAX_SEGMENTS]; /*!< Compiled delta table          */
+    int32_t acc;                           /*!< Current level, Q8.24          */
+    int32_t delta;                         /*!< Delta of the current segment  */
+    uint32_t remaining;                    /*!< Ticks left in the segment     */
+    uint8_t index;                         /*!< Current segment               */
+    uint8_t count;                         /*!< Compiled segments             */
+    uint8_t curve;                         /*!< Anim_Curve_t, for status only */
+    volatile uint8_t active;               /*!< Published to the ISR          */
+} Anim_Channel_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Anim_Channel_t anim_channels[LED_OUT_COUNT];
+static Anim_Stats_t anim_stats;
+
+static const char *const anim_curve_names[ANIM_CURVE_COUNT] = {
+    [ANIM_CURVE_CUSTOM] = "CUSTOM",
+    [ANIM_CURVE_BREATHE] = "BREATHE",
+    [ANIM_CURVE_STROBE] = "STROBE",
+    [ANIM_CURVE_HEARTBEAT] = "HEARTBEAT",
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Convert a keyframe level (permille) to Q8.24.
+ * @param  level: 0 - ANIM_LEVEL_MAX
+ * @retval Level in Q8.24
+ */
+static int32_t anim_level_to_q24(uint16_t level)
+{
+    // 2^24 / 1000 = 2^21 / 125, and 1000 * 2^21 still fits in 32 bits
+    return (int32_t)(((uint32_t)level << 21) / 125U);
+}
+
+/**
+ * @brief  Enter a segment (skipping zero-length ones, which are level jumps).
+ * @param  ch: channel
+ * @param  index: segment to enter
+ */
+static void anim_load_segment(Anim_Channel_t *ch, uint8_t index)
+{
+    // anim_start() guarantees at least one segment with steps > 0
+    while (ch->seg[index].steps == 0U)
+    {
+        index = (uint8_t)((index + 1U < ch->count) ? index + 1U : 0U);
+    }
+
+    ch->index = index;
+    ch->acc = ch->seg[index].start;
+    ch->delta = ch->seg[index].delta;
+    ch->remaining = ch->seg[index].steps;
+}
+
+/**
+ * @brief  Advance every active channel by one tick (TIM2 ISR context).
+ */
+static void anim_tick(void)
+{
+    uint32_t start = bare_dwt_get_cycles();
+    uint32_t active = 0;
+
+    for (uint32_t i = 0; i < LED_OUT_COUNT; i++)
+    {
+        Anim_Channel_t *ch = &anim_channels[i];
+        if (!__atomic_load_n(&ch->active, __ATOMIC_ACQUIRE))
+        {
+            continue;
+        }
+        active++;
+
+        led_output_set_q16((LED_Output_t)i, (uint32_t)ch->acc >> 8);
+
+        // One add per tick; the segment boundary reloads an exact start level
+        ch->acc += ch->delta;
+        if (--ch->remaining == 0U)
+        {
+            anim_load_segment(ch, (uint8_t)((ch->index + 1U < ch->count) ? ch->index + 1U : 0U));
+        }
+    }
+
+    if (active != 0U)
+    {
+        fb_commit_outputs(); // Only levels that changed reach BSRR/CCR
+    }
+
+    uint32_t cycles = bare_dwt_get_cycles() - start;
+    anim_stats.last_cycles = cycles;
+    anim_stats.active_channels = active;
+    anim_stats.cycles_per_channel = (active != 0U) ? cycles / active : 0U;
+    if (active != 0U && cycles > anim_stats.max_cycles)
+    {
+        anim_stats.max_cycles = cycles;
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Start the TIM2 animation time base.
+ *
+ * @note   TIM2 is reserved for the animation engine; its default 1 MHz / 1000 setting from
+ *         bare_tim2_5_start() gives the 1 ms tick.
+ */
+void anim_init(void)
+{
+    bare_tim2_5_start(TIM2);
+}
+
+/**
+ * @brief  Compile keyframes into a delta table and start animating an output.
+ * @param  out: output to drive
+ * @param  curve: curve id recorded for status
+ * @param  keys: keyframes (first at t = 0, non-decreasing times)
+ * @param  count: number of keyframes
+ * @retval 0 on success, -1 if the keyframes are invalid
+ */
+int anim_start(LED_Output_t out, Anim_Curve_t curve, const Anim_Keyframe_t *keys, uint32_t count)
+{
+    if (out >= LED_OUT_COUNT || keys == NULL || count < 2U || count > ANIM_MAX_KEYFRAMES ||
+        keys[0].time_ms != 0U || keys[count - 1U].time_ms == 0U)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (keys[i].level > ANIM_LEVEL_MAX || (i > 0U && keys[i].time_ms < keys[i - 1U].time_ms))
+        {
+            return -1;
+        }
+    }
+
+    Anim_Channel_t *ch = &anim_channels[out];
+    ch->active = 0; // The ISR skips the channel while it is rebuilt
+
+    for (uint32_t i = 0; i + 1U < count; i++)
+    {
+        Anim_Segment_t *seg = &ch->seg[i];
+        int32_t from = anim_level_to_q24(keys[i].level);
+        int32_t to = anim_level_to_q24(keys[i + 1U].level);
+
+        seg->start = from;
+        seg->steps = (uint32_t)keys[i + 1U].time_ms - keys[i].time_ms;
+        seg->delta = (seg->steps != 0U) ? (to - from) / (int32_t)seg->steps : 0;
+    }
+
+    ch->count = (uint8_t)(count - 1U);
+    ch->curve = (uint8_t)curve;
+    anim_load_segment(ch, 0);
+
+    __atomic_store_n(&ch->active, 1U, __ATOMIC_RELEASE); // Publish last
+    return 0;
+}
+
+/**
+ * @brief  Start a built-in curve.
+ * @param  out: output to drive
+ * @param  curve: built-in curve
+ * @param  period_ms: loop period
+ * @retval 0 on success, -1 on invalid arguments
+ */
+int anim_start_preset(LED_Output_t out, Anim_Curve_t curve, uint16_t period_ms)
+{
+    Anim_Keyframe_t keys[ANIM_MAX_KEYFRAMES];
+    uint32_t p = period_ms;
+    uint32_t count;
+
+    if (period_ms < ANIM_MIN_PERIOD_MS)
+    {
+        return -1;
+    }
+
+    switch (curve)
+    {
+    case ANIM_CURVE_BREATHE:
+        keys[0] = (Anim_Keyframe_t){0, 0};
+        keys[1] = (Anim_Keyframe_t){(uint16_t)(p / 2U), ANIM_LEVEL_MAX};
+        keys[2] = (Anim_Keyframe_t){(uint16_t)p, 0};
+        count = 3;
+        break;
+
+    case ANIM_CURVE_STROBE:
+        keys[0] = (Anim_Keyframe_t){0, ANIM_LEVEL_MAX};
+        keys[1] = (Anim_Keyframe_t){(uint16_t)(p / 20U), ANIM_LEVEL_MAX};
+        keys[2] = (Anim_Keyframe_t){(uint16_t)(p / 20U), 0};
+        keys[3] = (Anim_Keyframe_t){(uint16_t)p, 0};
+        count = 4;
+        break;
+
+    case ANIM_CURVE_HEARTBEAT:
+        keys[0] = (Anim_Keyframe_t){0, 0};
+        keys[1] = (Anim_Keyframe_t){(uint16_t)(p / 10U), ANIM_LEVEL_MAX};
+        keys[2] = (Anim_Keyframe_t){(uint16_t)(p / 5U), 100};
+        keys[3] = (Anim_Keyframe_t){(uint16_t)(p * 3U / 10U), 800};
+        keys[4] = (Anim_Keyframe_t){(uint16_t)(p * 9U / 20U), 0};
+        keys[5] = (Anim_Keyframe_t){(uint16_t)p, 0};
+        count = 6;
+        break;
+
+    default:
+        return -1;
+    }
+
+    return anim_start(out, curve, keys, count);
+}
+
+/**
+ * @brief  Stop animating an output.
+ * @param  out: output to release
+ */
+void anim_stop(LED_Output_t out)
+{
+    if (out < LED_OUT_COUNT)
+    {
+        __atomic_store_n(&anim_channels[out].active, 0U, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief  Read the state of a channel.
+ * @param  out: output
+ * @param  info: filled with the channel state
+ */
+void anim_get_info(LED_Output_t out, Anim_ChannelInfo_t *info)
+{
+    if (out >= LED_OUT_COUNT || info == NULL)
+    {
+        return;
+    }
+
+    const Anim_Channel_t *ch = &anim_channels[out];
+    uint32_t q16 = (uint32_t)ch->acc >> 8; // Single word read, consistent on its own
+
+    info->active = ch->active;
+    info->curve = ch->curve;
+    info->segment = ch->index;
+    info->segments = ch->count;
+    info->level = (uint16_t)((q16 * ANIM_LEVEL_MAX) >> 16);
+}
+
+/**
+ * @brief  Get the per-tick cost statistics.
+ * @retval Pointer to the statistics record
+ */
+const Anim_Stats_t *anim_get_stats(void)
+{
+    return &anim_stats;
+}
+
+/**
+ * @brief  Get the printable name of a curve.
+ * @param  curve: curve id
+ * @retval Upper-case curve name
+ */
+const char *anim_curve_name(Anim_Curve_t curve)
+{
+    return (curve < ANIM_CURVE_COUNT) ? anim_curve_names[curve] : "?";
+}
+
+/*******************************************************************************************
+ *                                  Interrupt Handlers
+ *******************************************************************************************/
+
+/**
+ * @brief  TIM2 update interrupt: one animation tick (1 ms).
+ */
+RAMFUNC void TIM2_IRQHandler(void)
+{
+    uint32_t start = perf_isr_enter();
+    trace_isr_enter(TRACE_SRC_TIM2);
+    TIM2->SR = ~TIM_SR_UIF; // rc_w0: clear only the update flag
+    anim_tick();
+    trace_isr_exit(TRACE_SRC_TIM2, 0U);
+    perf_isr_exit(PERF_SRC_TIM2, start);
+}
@@ -0,0 +1,208 @@
+/*******************************************************************************************
+ * @file    apa102.c
+ * @author  ka5j
+ * @brief   APA102/SK9822 clocked LED strip driver (SPI1 + DMA, bare metal)
+ * @version 1.1
+ * @date    2025-06-14
+ *
+ * @details
+ * Buffer layout: 4-byte start frame of zeros, then one 4-byte LED frame per pixel. The end
+ * frame is a separate zero block sent by a second DMA transfer chained from the first
+ * one's completion. It is 4 bytes (the SK9822 latch) plus one byte per 16 pixels sent, to
+ * supply the extra clock edges the data needs to reach the last pixel. Keeping it out of
+ * the pixel buffer lets a frame end after any pixel without overwriting the pixels behind
+ * it. Zeros are used instead of 0xFF so a strip longer than sent never sees a stray white
+ * LED frame.
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "apa102.h"
+#include "bare_spi.h" // SPI1 + DMA (bare-metal)
+#include "bare_dwt.h" // Frame transfer time
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define APA_START_WORDS 1U
+#define APA_END_WORDS(n) (1U + ((n) + 63U) / 64U) /*!< 4 bytes + n/16 bytes, in words */
+#define APA_BUF_WORDS (APA_START_WORDS + APA102_MAX_PIXELS)
+#define APA_LED_HEADER 0xE0U
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static uint32_t apa_buf[2][APA_BUF_WORDS] DMA_BSS; // DMA buffers, pixels encoded in place
+static uint32_t apa_end_frame[APA_END_WORDS(APA102_MAX_PIXELS)] DMA_BSS; // Always zero
+static uint16_t apa_end_bytes;                                   // End frame of this frame
+static uint8_t apa_back;
+static uint32_t apa_length = APA102_MAX_PIXELS;
+static uint32_t apa_start_cycles;
+static APA102_Stats_t apa_stats;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  End of a frame transfer (DMA ISR context).
+ */
+static void apa_done(void)
+{
+    apa_stats.frame_cycles = bare_dwt_get_cycles() - apa_start_cycles;
+    apa_stats.frames++;
+}
+
+/**
+ * @brief  Pixels sent, clock out the end frame (DMA ISR context).
+ *
+ * @note   The SPI driver clears its busy flag before calling back, so the end frame is
+ *         started before any thread can see the bus idle.
+ */
+static void apa_pixels_done(void)
+{
+    if (bare_spi_send_dma((const uint8_t *)apa_end_frame, apa_end_bytes, apa_done) != 0)
+    {
+        apa_done();
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Initialize SPI1 at 8 MHz and clear both frame buffers.
+ */
+void apa102_init(void)
+{
+    bare_spi_init(SPI_BAUD_DIV2);
+
+    for (uint32_t f = 0; f < 2U; f++)
+    {
+        apa_buf[f][0] = 0U; // Start frame stays zero from here on
+        for (uint32_t i = 0; i < APA102_MAX_PIXELS; i++)
+        {
+            apa_buf[f][APA_START_WORDS + i] = APA_LED_HEADER; // Off, brightness 0
+        }
+    }
+}
+
+/**
+ * @brief  Set the number of pixels sent per frame.
+ * @param  count: pixels on the strip
+ */
+void apa102_set_length(uint32_t count)
+{
+    if (count < 1U)
+    {
+        count = 1U;
+    }
+    if (count > APA102_MAX_PIXELS)
+    {
+        count = APA102_MAX_PIXELS;
+    }
+    apa_length = count;
+}
+
+/**
+ * @brief  Get the number of pixels sent per frame.
+ * @retval Strip length
+ */
+uint32_t apa102_get_length(void)
+{
+    return apa_length;
+}
+
+/**
+ * @brief  Set one pixel in the back buffer.
+ */
+void apa102_set_pixel(uint32_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t brightness)
+{
+    if (index >= APA102_MAX_PIXELS)
+    {
+        return;
+    }
+
+    if (brightness > APA102_BRIGHTNESS_MAX)
+    {
+        brightness = APA102_BRIGHTNESS_MAX;
+    }
+
+    // Little-endian word = wire bytes 0xE0 | brightness, B, G, R
+    apa_buf[apa_back][APA_START_WORDS + index] = (APA_LED_HEADER | brightness) |
+                                                 ((uint32_t)b << 8) |
+                                                 ((uint32_t)g << 16) |
+                                                 ((uint32_t)r << 24);
+}
+
+/**
+ * @brief  Set every pixel of the back buffer to one color.
+ */
+void apa102_fill(uint8_t r, uint8_t g, uint8_t b, uint8_t brightness)
+{
+    for (uint32_t i = 0; i < APA102_MAX_PIXELS; i++)
+    {
+        apa102_set_pixel(i, r, g, b, brightness);
+    }
+}
+
+/**
+ * @brief  Send the back buffer and switch to the other buffer.
+ * @retval 0 on success, -1 if the previous frame is still being sent
+ */
+int apa102_show(void)
+{
+    return (apa102_show_range(apa_length) < 0) ? -1 : 0;
+}
+
+/**
+ * @brief  Send the first pixels of the back buffer and switch to the other buffer.
+ * @param  count: pixels to send (clamped to the strip length)
+ * @retval Bytes sent, -1 if the previous frame is still being sent
+ */
+int apa102_show_range(uint32_t count)
+{
+    if (count > apa_length)
+    {
+        count = apa_length;
+    }
+    if (count == 0U)
+    {
+        return 0;
+    }
+
+    if (bare_spi_busy())
+    {
+        return -1;
+    }
+
+    uint8_t front = apa_back;
+    uint32_t *buf = apa_buf[front];
+    uint32_t words = APA_START_WORDS + count;
+
+    apa_end_bytes = (uint16_t)(APA_END_WORDS(count) * 4U);
+    apa_start_cycles = bare_dwt_get_cycles();
+    apa_stats.bytes = words * 4U + apa_end_bytes;
+    if (bare_spi_send_dma((const uint8_t *)buf, (uint16_t)(words * 4U), apa_pixels_done) != 0)
+    {
+        return -1;
+    }
+
+    // New back buffer starts from the frame on the wire (read-only use of the front)
+    apa_back ^= 1U;
+    for (uint32_t i = 0; i < APA102_MAX_PIXELS; i++)
+    {
+        apa_buf[apa_back][APA_START_WORDS + i] = buf[APA_START_WORDS + i];
+    }
+    return (int)apa_stats.bytes;
+}
+
+/**
+ * @brief  Get the driver statistics.
+ * @retval Pointer to the statistics record
+ */
+const APA102_Stats_t *apa102_get_stats(void)
+{
+    return &apa_stats;
+}
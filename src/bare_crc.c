@@ -0,0 +1,252 @@
+/*******************************************************************************************
+ * @file    bare_crc.c
+ * @author  ka5j
+ * @brief   Bare-metal CRC-32 driver implementation for STM32F446RE
+ * @version 1.0
+ * @date    2025-07-01
+ *
+ * @note    The DMA feed is a memory-to-memory transfer with a fixed destination: the words
+ *          are read through the FIFO and written to CRC->DR, which takes one word per AHB
+ *          cycle, so a whole flash image costs the CPU one interrupt per 65535 words.
+ *******************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bare_crc.h"
+#include "stm32f446re_addresses.h"
+#include "rcc_registers.h"
+#include "crc_registers.h"
+#include "bare_dma.h"
+
+/*******************************************************************************************
+ *                                Configuration Constants
+ *******************************************************************************************/
+#define RCC_AHB1ENR_CRCEN (1U << 12) /*!< CRC unit clock enable */
+#define CRC_DMA_PRIORITY 0U          /*!< Lowest: peripheral streams and copies go first */
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+
+/* CRC-32/MPEG-2 remainders of every 4-bit value, MSB first (64 bytes instead of 1 KB) */
+static const uint32_t crc_nibble[16] = {
+    0x00000000UL, 0x04C11DB7UL, 0x09823B6EUL, 0x0D4326D9UL,
+    0x130476DCUL, 0x17C56B6BUL, 0x1A864DB2UL, 0x1E475005UL,
+    0x2608EDB8UL, 0x22C9F00FUL, 0x2F8AD6D6UL, 0x2B4BCB61UL,
+    0x350C9B64UL, 0x31CD86D3UL, 0x3C8EA00AUL, 0x384FBDBDUL,
+};
+
+#ifndef HOST_BUILD
+static const uint32_t *crc_dma_next;  // Next word to hand to the stream
+static uint32_t crc_dma_left;         // Words not yet handed to the stream
+static bare_crc_callback_t crc_dma_done_cb;
+#endif
+static volatile uint8_t crc_dma_busy; // The DMA owns the unit
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Software CRC of words, each most significant byte first.
+ */
+static uint32_t crc_sw_words(uint32_t crc, const uint32_t *words, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t bytes[4] = {(uint8_t)(words[i] >> 24), (uint8_t)(words[i] >> 16),
+                            (uint8_t)(words[i] >> 8), (uint8_t)words[i]};
+        crc = bare_crc_sw_update(crc, bytes, 4U);
+    }
+    return crc;
+}
+
+#ifndef HOST_BUILD
+/**
+ * @brief  Hand the next chunk of words to the stream.
+ */
+static void crc_dma_next_chunk(void)
+{
+    uint32_t items = (crc_dma_left > BARE_DMA_MAX_ITEMS) ? BARE_DMA_MAX_ITEMS : crc_dma_left;
+    const uint32_t *src = crc_dma_next;
+    crc_dma_next += items;
+    crc_dma_left -= items;
+
+    bare_dma_start(BARE_CRC_DMA_STREAM, (uint32_t)(uintptr_t)src, (const void *)&CRC->DR, NULL,
+                   (uint16_t)items);
+}
+
+/**
+ * @brief  Feed stream event: chain the next chunk or report the result.
+ */
+static void crc_dma_event(uint32_t events)
+{
+    if (!(events & BARE_DMA_EVT_ERROR) && crc_dma_left != 0U)
+    {
+        crc_dma_next_chunk();
+        return;
+    }
+
+    uint32_t crc = CRC->DR;
+    crc_dma_busy = 0;
+    if (crc_dma_done_cb != NULL)
+    {
+        crc_dma_done_cb(crc, (events & BARE_DMA_EVT_ERROR) ? 0U : 1U);
+    }
+}
+#endif /* HOST_BUILD */
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Enable the CRC unit and claim its feed stream.
+ */
+void bare_crc_init(void)
+{
+#ifndef HOST_BUILD
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+
+    static const Bare_DMA_Config_t cfg = {
+        .channel = 0U,
+        .dir = BARE_DMA_M2M,
+        .mode = BARE_DMA_NORMAL,
+        .psize = BARE_DMA_WORD,
+        .msize = BARE_DMA_WORD,
+        .pinc = 1U, // Source walks the buffer
+        .minc = 0U, // Destination stays on CRC->DR
+        .priority = CRC_DMA_PRIORITY,
+        .fifo = BARE_DMA_FIFO_HALF,
+        .pburst = BARE_DMA_BURST_SINGLE,
+        .mburst = BARE_DMA_BURST_SINGLE,
+        .events = BARE_DMA_EVT_DONE | BARE_DMA_EVT_ERROR,
+    };
+    (void)bare_dma_claim(BARE_CRC_DMA_STREAM, &cfg, crc_dma_event);
+#endif
+}
+
+/**
+ * @brief  CRC-32/MPEG-2 of a byte buffer.
+ * @param  data: data
+ * @param  len: bytes
+ * @retval CRC
+ */
+uint32_t bare_crc_compute(const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+#ifdef HOST_BUILD
+    return bare_crc_sw_update(BARE_CRC_INIT, p, len);
+#else
+    if (crc_dma_busy)
+    {
+        return bare_crc_sw_update(BARE_CRC_INIT, p, len); // Unit held by the DMA
+    }
+
+    CRC->CR = CRC_CR_RESET;
+    uint32_t words = len / 4U;
+    if (((uintptr_t)p & 3U) == 0U)
+    {
+        const uint32_t *w = (const uint32_t *)(const void *)p;
+        for (uint32_t i = 0; i < words; i++)
+        {
+            CRC->DR = __builtin_bswap32(w[i]); // REV: first byte in memory goes first
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < words; i++)
+        {
+            const uint8_t *b = &p[4U * i];
+            CRC->DR = ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) |
+                      (uint32_t)b[3];
+        }
+    }
+    return bare_crc_sw_update(CRC->DR, &p[4U * words], len & 3U);
+#endif
+}
+
+/**
+ * @brief  CRC of words in the unit's order.
+ * @param  words: word-aligned data
+ * @param  count: words
+ * @retval CRC
+ */
+uint32_t bare_crc_words(const uint32_t *words, uint32_t count)
+{
+#ifdef HOST_BUILD
+    return crc_sw_words(BARE_CRC_INIT, words, count);
+#else
+    if (crc_dma_busy)
+    {
+        return crc_sw_words(BARE_CRC_INIT, words, count);
+    }
+
+    CRC->CR = CRC_CR_RESET;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        CRC->DR = words[i];
+    }
+    return CRC->DR;
+#endif
+}
+
+/**
+ * @brief  CRC of words in the unit's order, fed by DMA.
+ * @param  words: word-aligned data
+ * @param  count: words
+ * @param  done_cb: result callback (ISR context, may be NULL)
+ * @retval 0 on success, -1 if busy or count is 0
+ */
+int bare_crc_words_dma(const uint32_t *words, uint32_t count, bare_crc_callback_t done_cb)
+{
+    if (crc_dma_busy || count == 0U)
+    {
+        return -1;
+    }
+
+#ifdef HOST_BUILD
+    uint32_t crc = crc_sw_words(BARE_CRC_INIT, words, count);
+    if (done_cb != NULL)
+    {
+        done_cb(crc, 1U);
+    }
+#else
+    crc_dma_busy = 1;
+    crc_dma_next = words;
+    crc_dma_left = count;
+    crc_dma_done_cb = done_cb;
+    CRC->CR = CRC_CR_RESET;
+    crc_dma_next_chunk();
+#endif
+    return 0;
+}
+
+/**
+ * @brief  Check whether the DMA feeds the unit.
+ * @retval 1 while busy
+ */
+uint8_t bare_crc_busy(void)
+{
+    return crc_dma_busy;
+}
+
+/**
+ * @brief  Continue a CRC-32/MPEG-2 in software, two 4-bit table steps per byte.
+ * @param  crc: CRC so far
+ * @param  data: data
+ * @param  len: bytes
+ * @retval Updated CRC
+ */
+uint32_t bare_crc_sw_update(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= (uint32_t)data[i] << 24;
+        crc = (crc << 4) ^ crc_nibble[crc >> 28];
+        crc = (crc << 4) ^ crc_nibble[crc >> 28];
+    }
+    return crc;
+}
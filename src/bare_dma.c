@@ -0,0 +1,515 @@
+/*******************************************************************************************
+ * @file    bare_dma.c
+ * @author  ka5j
+ * @brief   Bare-metal DMA1/DMA2 stream driver implementation for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-27
+ *
+ * @note    The stream configuration is turned into CR/FCR values once, at claim time;
+ *          starting a transfer only writes the addresses, NDTR, FCR and CR. Every stream
+ *          ISR is the same dispatcher: read and clear the stream's flags in LISR/HISR,
+ *          call the owner. Streams that have a PERF source are accounted there.
+ *******************************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bare_dma.h"
+#include "stm32f446re_addresses.h"
+#include "dma_registers.h"
+#include "rcc_registers.h"
+#include "bare_nvic.h" // NVIC enable
+#include "perf.h"      // CPU load accounting
+
+/*******************************************************************************************
+ *                                Configuration Constants
+ *******************************************************************************************/
+#define RCC_AHB1ENR_DMA1EN (1U << 21)
+#define RCC_AHB1ENR_DMA2EN (1U << 22)
+
+#define DMA_STREAMS_PER_CTRL 8U
+#define DMA_COPY_PRIORITY 1U /*!< Below the peripheral streams (they cannot wait) */
+
+/*******************************************************************************************
+ *                                   Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief State of one stream
+ */
+typedef struct
+{
+    uint32_t cr;                  /*!< Configured CR, EN clear                 */
+    uint32_t fcr;                 /*!< Configured FCR                          */
+    bare_dma_callback_t callback; /*!< Owner, called from the ISR              */
+    uint8_t claimed;              /*!< 1 once bare_dma_claim() succeeded       */
+} Dma_Stream_State_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Dma_Stream_State_t dma_streams[BARE_DMA_STREAM_COUNT];
+
+static const IRQn_t dma_irqn[BARE_DMA_STREAM_COUNT] = {
+    DMA1_STREAM0_IRQn, DMA1_STREAM1_IRQn, DMA1_STREAM2_IRQn, DMA1_STREAM3_IRQn,
+    DMA1_STREAM4_IRQn, DMA1_STREAM5_IRQn, DMA1_STREAM6_IRQn, DMA1_STREAM7_IRQn,
+    DMA2_STREAM0_IRQn, DMA2_STREAM1_IRQn, DMA2_STREAM2_IRQn, DMA2_STREAM3_IRQn,
+    DMA2_STREAM4_IRQn, DMA2_STREAM5_IRQn, DMA2_STREAM6_IRQn, DMA2_STREAM7_IRQn,
+};
+
+// PERF_SRC_COUNT: not accounted
+static const uint8_t dma_perf_src[BARE_DMA_STREAM_COUNT] = {
+    PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_DMA1_S2, PERF_SRC_COUNT,
+    PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_COUNT,
+    PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_DMA2_S3,
+    PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_COUNT, PERF_SRC_COUNT,
+};
+
+static uint8_t *copy_dst;                  // Next destination byte
+static const uint8_t *copy_src;            // Next source byte
+static uint32_t copy_left;                 // Bytes not yet handed to the stream
+static uint32_t copy_unit;                 // Bytes per item (1 or 4)
+static uint8_t copy_burst;                 // INCR4 bursts: items in multiples of 4
+static bare_dma_callback_t copy_done_cb;
+static volatile uint8_t copy_busy;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Get the controller of a stream.
+ */
+static inline DMA_TypeDef *dma_ctrl(Bare_DMA_Stream_t stream)
+{
+    return ((uint32_t)stream < DMA_STREAMS_PER_CTRL) ? DMA1 : DMA2;
+}
+
+/**
+ * @brief  Get the register block of a stream.
+ */
+static inline DMA_Stream_TypeDef *dma_regs(Bare_DMA_Stream_t stream)
+{
+    uint32_t base = ((uint32_t)stream < DMA_STREAMS_PER_CTRL) ? DMA1_BASE : DMA2_BASE;
+    uint32_t n = (uint32_t)stream % DMA_STREAMS_PER_CTRL;
+    return (DMA_Stream_TypeDef *)(base + DMA_STREAM_OFFSET(n));
+}
+
+/**
+ * @brief  Clear every flag of a stream.
+ */
+static void dma_clear_flags(Bare_DMA_Stream_t stream)
+{
+    uint32_t n = (uint32_t)stream % DMA_STREAMS_PER_CTRL;
+    DMA_TypeDef *dma = dma_ctrl(stream);
+
+    if (n < 4U)
+    {
+        dma->LIFCR = DMA_FLAG_ALL << DMA_FLAG_SHIFT(n);
+    }
+    else
+    {
+        dma->HIFCR = DMA_FLAG_ALL << DMA_FLAG_SHIFT(n);
+    }
+}
+
+/**
+ * @brief  Turn a configuration into CR and FCR values.
+ * @param  stream: stream the configuration is for
+ * @param  cfg: configuration
+ * @param  state: receives cr and fcr
+ * @retval 0 on success, -1 if the combination is not supported by the hardware
+ */
+static int dma_encode(Bare_DMA_Stream_t stream, const Bare_DMA_Config_t *cfg,
+                      Dma_Stream_State_t *state)
+{
+    if (cfg->dir == BARE_DMA_M2M &&
+        ((uint32_t)stream < DMA_STREAMS_PER_CTRL || cfg->fifo == BARE_DMA_FIFO_DIRECT ||
+         cfg->mode != BARE_DMA_NORMAL))
+    {
+        return -1; // DMA2 only, through the FIFO, no circular / double-buffer
+    }
+
+    uint32_t cr = DMA_SxCR_CHSEL(cfg->channel & 7U) |
+                  ((uint32_t)(cfg->priority & 3U) << DMA_SxCR_PL_POS) |
+                  ((uint32_t)cfg->msize << DMA_SxCR_MSIZE_POS) |
+                  ((uint32_t)cfg->psize << DMA_SxCR_PSIZE_POS) |
+                  ((uint32_t)cfg->dir << DMA_SxCR_DIR_POS);
+
+    if (cfg->pinc)
+    {
+        cr |= DMA_SxCR_PINC;
+    }
+    if (cfg->minc)
+    {
+        cr |= DMA_SxCR_MINC;
+    }
+    if (cfg->mode == BARE_DMA_CIRCULAR)
+    {
+        cr |= DMA_SxCR_CIRC;
+    }
+    else if (cfg->mode == BARE_DMA_DOUBLE_BUFFER)
+    {
+        cr |= DMA_SxCR_DBM; // Implies circular
+    }
+
+    if (cfg->events & BARE_DMA_EVT_HALF)
+    {
+        cr |= DMA_SxCR_HTIE;
+    }
+    if (cfg->events & BARE_DMA_EVT_DONE)
+    {
+        cr |= DMA_SxCR_TCIE;
+    }
+    if (cfg->events & BARE_DMA_EVT_ERROR)
+    {
+        cr |= DMA_SxCR_TEIE | ((cfg->fifo == BARE_DMA_FIFO_DIRECT) ? DMA_SxCR_DMEIE : 0U);
+    }
+
+    state->fcr = 0U; // Direct mode
+    if (cfg->fifo != BARE_DMA_FIFO_DIRECT)
+    {
+        cr |= ((uint32_t)cfg->pburst << DMA_SxCR_PBURST_POS) |
+              ((uint32_t)cfg->mburst << DMA_SxCR_MBURST_POS);
+        state->fcr = DMA_SxFCR_DMDIS | (((uint32_t)cfg->fifo - 1U) & DMA_SxFCR_FTH_MASK);
+    }
+
+    state->cr = cr;
+    return 0;
+}
+
+/**
+ * @brief  Hand the next chunk of a memory-to-memory copy to the stream.
+ */
+static void dma_copy_next(void)
+{
+    uint32_t items = copy_left / copy_unit;
+    if (items > BARE_DMA_MAX_ITEMS)
+    {
+        items = BARE_DMA_MAX_ITEMS;
+    }
+    if (copy_burst)
+    {
+        items &= ~3U; // NDTR must be a whole number of bursts
+    }
+    uint32_t bytes = items * copy_unit;
+
+    const uint8_t *src = copy_src;
+    uint8_t *dst = copy_dst;
+    copy_src += bytes;
+    copy_dst += bytes;
+    copy_left -= bytes;
+
+    bare_dma_start(BARE_DMA_COPY_STREAM, (uint32_t)(uintptr_t)src, dst, NULL, (uint16_t)items);
+}
+
+/**
+ * @brief  Copy stream event: chain the next chunk or report the end of the copy.
+ * @param  events: raised events
+ */
+static void dma_copy_event(uint32_t events)
+{
+    if (!(events & BARE_DMA_EVT_ERROR) && copy_left != 0U)
+    {
+        dma_copy_next();
+        return;
+    }
+
+    copy_busy = 0;
+    if (copy_done_cb != NULL)
+    {
+        copy_done_cb(events);
+    }
+}
+
+/**
+ * @brief  Common stream ISR: clear the stream's flags and call its owner.
+ * @param  stream: stream that interrupted
+ */
+RAMFUNC static void dma_irq(Bare_DMA_Stream_t stream)
+{
+    uint32_t start = perf_isr_enter();
+    uint32_t n = (uint32_t)stream % DMA_STREAMS_PER_CTRL;
+    uint32_t shift = DMA_FLAG_SHIFT(n);
+    DMA_TypeDef *dma = dma_ctrl(stream);
+    uint32_t flags;
+
+    if (n < 4U)
+    {
+        flags = (dma->LISR >> shift) & DMA_FLAG_ALL;
+        dma->LIFCR = flags << shift;
+    }
+    else
+    {
+        flags = (dma->HISR >> shift) & DMA_FLAG_ALL;
+        dma->HIFCR = flags << shift;
+    }
+
+    bare_dma_callback_t callback = dma_streams[stream].callback;
+    if (callback != NULL)
+    {
+        callback(flags);
+    }
+
+    if (dma_perf_src[stream] < PERF_SRC_COUNT)
+    {
+        perf_isr_exit((Perf_Source_t)dma_perf_src[stream], start);
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Claim and configure a stream.
+ * @param  stream: stream
+ * @param  cfg: configuration
+ * @param  callback: event callback (ISR context, may be NULL)
+ * @retval 0 on success, -1 if taken or not supported
+ */
+int bare_dma_claim(Bare_DMA_Stream_t stream, const Bare_DMA_Config_t *cfg,
+                   bare_dma_callback_t callback)
+{
+    if ((uint32_t)stream >= BARE_DMA_STREAM_COUNT || dma_streams[stream].claimed)
+    {
+        return -1;
+    }
+
+    Dma_Stream_State_t state;
+    if (dma_encode(stream, cfg, &state) != 0)
+    {
+        return -1;
+    }
+
+    RCC->AHB1ENR |= ((uint32_t)stream < DMA_STREAMS_PER_CTRL) ? RCC_AHB1ENR_DMA1EN
+                                                               : RCC_AHB1ENR_DMA2EN;
+
+    state.callback = callback;
+    state.claimed = 1U;
+    dma_streams[stream] = state;
+
+    bare_dma_stop(stream);
+    dma_regs(stream)->FCR = state.fcr;
+    dma_clear_flags(stream);
+
+    if (cfg->events != 0U)
+    {
+        bare_nvic_enable_irq(dma_irqn[stream]);
+    }
+    return 0;
+}
+
+/**
+ * @brief  Stop a stream and give it back.
+ * @param  stream: stream
+ */
+void bare_dma_release(Bare_DMA_Stream_t stream)
+{
+    if ((uint32_t)stream >= BARE_DMA_STREAM_COUNT)
+    {
+        return;
+    }
+
+    bare_dma_stop(stream);
+    bare_nvic_disable_irq(dma_irqn[stream]);
+    dma_streams[stream].callback = NULL;
+    dma_streams[stream].claimed = 0U;
+}
+
+/**
+ * @brief  Start a transfer on a claimed stream.
+ * @param  stream: stream
+ * @param  periph: peripheral register or copy source address
+ * @param  mem0: memory buffer
+ * @param  mem1: second buffer (double-buffer mode)
+ * @param  items: items per transfer
+ * @retval 0 on success, -1 if not claimed or items is 0
+ */
+int bare_dma_start(Bare_DMA_Stream_t stream, uint32_t periph, const void *mem0,
+                   const void *mem1, uint16_t items)
+{
+    if ((uint32_t)stream >= BARE_DMA_STREAM_COUNT || !dma_streams[stream].claimed ||
+        items == 0U)
+    {
+        return -1;
+    }
+
+    const Dma_Stream_State_t *state = &dma_streams[stream];
+    DMA_Stream_TypeDef *regs = dma_regs(stream);
+
+    while (regs->CR & DMA_SxCR_EN)
+    {
+        // The stream finishes its current item after EN is cleared
+    }
+    dma_clear_flags(stream);
+
+    regs->PAR = periph;
+    regs->M0AR = (uint32_t)(uintptr_t)mem0;
+    if (state->cr & DMA_SxCR_DBM)
+    {
+        regs->M1AR = (uint32_t)(uintptr_t)mem1;
+    }
+    regs->NDTR = items;
+    regs->FCR = state->fcr;
+    regs->CR = state->cr;
+    regs->CR = state->cr | DMA_SxCR_EN;
+    return 0;
+}
+
+/**
+ * @brief  Disable a stream and wait until it has stopped.
+ * @param  stream: stream
+ */
+void bare_dma_stop(Bare_DMA_Stream_t stream)
+{
+    DMA_Stream_TypeDef *regs = dma_regs(stream);
+
+    regs->CR &= ~DMA_SxCR_EN;
+    while (regs->CR & DMA_SxCR_EN)
+    {
+        // At most one item (one burst) left
+    }
+}
+
+/**
+ * @brief  Check whether a stream is enabled.
+ * @param  stream: stream
+ * @retval 1 while the stream runs
+ */
+uint8_t bare_dma_busy(Bare_DMA_Stream_t stream)
+{
+    return (dma_regs(stream)->CR & DMA_SxCR_EN) ? 1U : 0U;
+}
+
+/**
+ * @brief  Get the number of items left (NDTR).
+ * @param  stream: stream
+ * @retval Items left
+ */
+uint16_t bare_dma_remaining(Bare_DMA_Stream_t stream)
+{
+    return (uint16_t)dma_regs(stream)->NDTR;
+}
+
+/**
+ * @brief  Get the buffer a double-buffer stream is working on.
+ * @param  stream: stream
+ * @retval 0 for mem0, 1 for mem1
+ */
+uint8_t bare_dma_current_target(Bare_DMA_Stream_t stream)
+{
+    return (dma_regs(stream)->CR & DMA_SxCR_CT) ? 1U : 0U;
+}
+
+/**
+ * @brief  Point the idle buffer of a double-buffer stream elsewhere.
+ * @param  stream: stream
+ * @param  target: 0 for mem0, 1 for mem1
+ * @param  mem: new buffer
+ */
+void bare_dma_set_buffer(Bare_DMA_Stream_t stream, uint8_t target, const void *mem)
+{
+    DMA_Stream_TypeDef *regs = dma_regs(stream);
+
+    if (target)
+    {
+        regs->M1AR = (uint32_t)(uintptr_t)mem;
+    }
+    else
+    {
+        regs->M0AR = (uint32_t)(uintptr_t)mem;
+    }
+}
+
+/**
+ * @brief  Copy memory to memory with DMA2.
+ * @param  dst: destination
+ * @param  src: source
+ * @param  bytes: bytes to copy
+ * @param  done_cb: end-of-copy callback (ISR context, may be NULL)
+ * @retval 0 on success, -1 if busy or bytes is 0
+ */
+int bare_dma_memcpy(void *dst, const void *src, uint32_t bytes, bare_dma_callback_t done_cb)
+{
+    if (copy_busy || bytes == 0U)
+    {
+        return -1;
+    }
+
+    uintptr_t bits = (uintptr_t)dst | (uintptr_t)src | bytes;
+    uint8_t aligned = ((bits & 3U) == 0U);
+    uint8_t burst = ((bits & 15U) == 0U); // 16-byte bursts never cross a 1 KB boundary
+    Bare_DMA_Config_t cfg = {
+        .channel = 0U,
+        .dir = BARE_DMA_M2M,
+        .mode = BARE_DMA_NORMAL,
+        .psize = aligned ? BARE_DMA_WORD : BARE_DMA_BYTE,
+        .msize = aligned ? BARE_DMA_WORD : BARE_DMA_BYTE,
+        .pinc = 1U,
+        .minc = 1U,
+        .priority = DMA_COPY_PRIORITY,
+        .fifo = BARE_DMA_FIFO_FULL,
+        .pburst = burst ? BARE_DMA_BURST_INCR4 : BARE_DMA_BURST_SINGLE,
+        .mburst = burst ? BARE_DMA_BURST_INCR4 : BARE_DMA_BURST_SINGLE,
+        .events = BARE_DMA_EVT_DONE | BARE_DMA_EVT_ERROR,
+    };
+
+    Dma_Stream_State_t *state = &dma_streams[BARE_DMA_COPY_STREAM];
+    if (!state->claimed)
+    {
+        if (bare_dma_claim(BARE_DMA_COPY_STREAM, &cfg, dma_copy_event) != 0)
+        {
+            return -1;
+        }
+    }
+    else if (dma_encode(BARE_DMA_COPY_STREAM, &cfg, state) != 0)
+    {
+        return -1;
+    }
+
+    copy_busy = 1;
+    copy_dst = (uint8_t *)dst;
+    copy_src = (const uint8_t *)src;
+    copy_left = bytes;
+    copy_unit = aligned ? 4U : 1U;
+    copy_burst = burst;
+    copy_done_cb = done_cb;
+    dma_copy_next();
+    return 0;
+}
+
+/**
+ * @brief  Check whether a bare_dma_memcpy() copy is running.
+ * @retval 1 while copying
+ */
+uint8_t bare_dma_copy_busy(void)
+{
+    return copy_busy;
+}
+
+/*******************************************************************************************
+ *                                  Interrupt Handlers
+ *******************************************************************************************/
+#define DMA_IRQ_HANDLER(handler, stream) \
+    RAMFUNC void handler(void)           \
+    {                                    \
+        dma_irq(stream);                 \
+    }
+
+DMA_IRQ_HANDLER(DMA1_Stream0_IRQHandler, BARE_DMA1_STREAM0)
+DMA_IRQ_HANDLER(DMA1_Stream1_IRQHandler, BARE_DMA1_STREAM1)
+DMA_IRQ_HANDLER(DMA1_Stream2_IRQHandler, BARE_DMA1_STREAM2)
+DMA_IRQ_HANDLER(DMA1_Stream3_IRQHandler, BARE_DMA1_STREAM3)
+DMA_IRQ_HANDLER(DMA1_Stream4_IRQHandler, BARE_DMA1_STREAM4)
+DMA_IRQ_HANDLER(DMA1_Stream5_IRQHandler, BARE_DMA1_STREAM5)
+DMA_IRQ_HANDLER(DMA1_Stream6_IRQHandler, BARE_DMA1_STREAM6)
+DMA_IRQ_HANDLER(DMA1_Stream7_IRQHandler, BARE_DMA1_STREAM7)
+DMA_IRQ_HANDLER(DMA2_Stream0_IRQHandler, BARE_DMA2_STREAM0)
+DMA_IRQ_HANDLER(DMA2_Stream1_IRQHandler, BARE_DMA2_STREAM1)
+DMA_IRQ_HANDLER(DMA2_Stream2_IRQHandler, BARE_DMA2_STREAM2)
+DMA_IRQ_HANDLER(DMA2_Stream3_IRQHandler, BARE_DMA2_STREAM3)
+DMA_IRQ_HANDLER(DMA2_Stream4_IRQHandler, BARE_DMA2_STREAM4)
+DMA_IRQ_HANDLER(DMA2_Stream5_IRQHandler, BARE_DMA2_STREAM5)
+DMA_IRQ_HANDLER(DMA2_Stream6_IRQHandler, BARE_DMA2_STREAM6)
+DMA_IRQ_HANDLER(DMA2_Stream7_IRQHandler, BARE_DMA2_STREAM7)
@@ -0,0 +1,76 @@
+/*******************************************************************************************
+ * @file    bare_dwt.c
+ * @author  ka5j
+ * @brief   Bare-metal DWT cycle counter implementation for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @note    The cycle counter is part of the Cortex-M4 DWT unit and must be unlocked by
+ *          setting TRCENA in CoreDebug->DEMCR before it counts.
+ *******************************************************************************************/
+
+#include "stm32f446re_addresses.h"
+#include "dwt_registers.h"
+#include "bare_dwt.h"
+
+#ifdef HOST_BUILD
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static uint32_t dwt_virtual_cycles; // Host builds: time only moves when the test says so
+#endif
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+#ifdef HOST_BUILD
+
+/**
+ * @brief  Reset the virtual cycle counter.
+ */
+void bare_dwt_init(void)
+{
+    dwt_virtual_cycles = 0;
+}
+
+/**
+ * @brief  Read the virtual cycle counter.
+ * @retval Virtual cycles since bare_dwt_init()
+ */
+uint32_t bare_dwt_get_cycles(void)
+{
+    return dwt_virtual_cycles;
+}
+
+/**
+ * @brief  Advance the virtual cycle counter.
+ * @param  cycles: cycles to add
+ */
+void bare_dwt_host_advance(uint32_t cycles)
+{
+    dwt_virtual_cycles += cycles;
+}
+
+#else
+
+/**
+ * @brief  Enable the trace block and start the DWT cycle counter from zero.
+ */
+void bare_dwt_init(void)
+{
+    COREDEBUG->DEMCR |= COREDEBUG_DEMCR_TRCENA; // Power up DWT/ITM
+    DWT->CYCCNT = 0;                            // Restart count
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;            // Enable cycle counter
+}
+
+/**
+ * @brief  Read the current value of the free-running cycle counter.
+ * @retval Cycle count since bare_dwt_init()
+ */
+uint32_t bare_dwt_get_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+#endif /* HOST_BUILD */
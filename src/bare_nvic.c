@@ -0,0 +1,115 @@
+/*******************************************************************************************
+ * @file    bare_nvic.c
+ * @author  ka5j
+ * @brief   Bare-metal NVIC priority / enable driver implementation for STM32F446RE
+ * @version 1.0
+ * @date    2025-06-09
+ *
+ * @note    Device interrupts are configured through NVIC->IP / ISER / ICER, system
+ *          exceptions through SCB->SHPR.
+ *******************************************************************************************/
+
+#include "stm32f446re_addresses.h"
+#include "nvic_registers.h"
+#include "scb_registers.h"
+#include "bare_nvic.h"
+
+/*******************************************************************************************
+ *                                Configuration Constants
+ *******************************************************************************************/
+#define AIRCR_PRIGROUP_POS 8U                     /*!< PRIGROUP field position  */
+#define AIRCR_PRIGROUP_MASK (0x7UL << AIRCR_PRIGROUP_POS)
+#define AIRCR_VECTKEY_MASK (0xFFFFUL << 16)
+#define NVIC_PRIO_SHIFT (8U - NVIC_PRIO_BITS)     /*!< Implemented bits are the top bits */
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Select the priority grouping (AIRCR PRIGROUP).
+ * @param  group: priority grouping
+ */
+void bare_nvic_set_priority_grouping(NVIC_Grouping_t group)
+{
+    uint32_t aircr = SCB->AIRCR;
+    aircr &= ~(AIRCR_VECTKEY_MASK | AIRCR_PRIGROUP_MASK);
+    aircr |= SCB_AIRCR_VECTKEY | ((uint32_t)group << AIRCR_PRIGROUP_POS); // Key required
+    SCB->AIRCR = aircr;
+}
+
+/**
+ * @brief  Combine a preemption level and a sub-priority for the current grouping.
+ * @param  preempt: preemption level
+ * @param  sub: sub-priority
+ * @retval Logical priority 0-15
+ */
+uint8_t bare_nvic_encode_priority(uint8_t preempt, uint8_t sub)
+{
+    uint32_t group = (SCB->AIRCR & AIRCR_PRIGROUP_MASK) >> AIRCR_PRIGROUP_POS;
+    uint32_t sub_bits = (group > 3U) ? (group - 3U) : 0U; // PRIGROUP 3 = all bits preempt
+    uint32_t preempt_bits = NVIC_PRIO_BITS - sub_bits;
+
+    preempt &= (uint8_t)((1U << preempt_bits) - 1U);
+    sub &= (uint8_t)((1U << sub_bits) - 1U);
+    return (uint8_t)((preempt << sub_bits) | sub);
+}
+
+/**
+ * @brief  Set the priority of an interrupt or system exception.
+ * @param  irqn: interrupt number
+ * @param  priority: logical priority 0-15
+ */
+void bare_nvic_set_priority(IRQn_t irqn, uint8_t priority)
+{
+    uint8_t value = (uint8_t)(priority << NVIC_PRIO_SHIFT);
+
+    if (irqn < 0)
+    {
+        SCB->SHPR[((uint32_t)irqn & 0xFU) - 4U] = value; // Exception number - 4
+    }
+    else
+    {
+        NVIC->IP[irqn] = value;
+    }
+}
+
+/**
+ * @brief  Read back the priority of an interrupt or system exception.
+ * @param  irqn: interrupt number
+ * @retval Logical priority 0-15
+ */
+uint8_t bare_nvic_get_priority(IRQn_t irqn)
+{
+    if (irqn < 0)
+    {
+        return (uint8_t)(SCB->SHPR[((uint32_t)irqn & 0xFU) - 4U] >> NVIC_PRIO_SHIFT);
+    }
+    return (uint8_t)(NVIC->IP[irqn] >> NVIC_PRIO_SHIFT);
+}
+
+/**
+ * @brief  Enable a device interrupt in the NVIC.
+ * @param  irqn: interrupt number
+ */
+void bare_nvic_enable_irq(IRQn_t irqn)
+{
+    if (irqn >= 0)
+    {
+        NVIC->ISER[(uint32_t)irqn / 32U] = (1UL << ((uint32_t)irqn % 32U)); // Write-1-to-set
+    }
+}
+
+/**
+ * @brief  Disable a device interrupt in the NVIC.
+ * @param  irqn: interrupt number
+ */
+void bare_nvic_disable_irq(IRQn_t irqn)
+{
+    if (irqn >= 0)
+    {
+        NVIC->ICER[(uint32_t)irqn / 32U] = (1UL << ((uint32_t)irqn % 32U)); // Write-1-to-clear
+        bare_core_dsb();
+        bare_core_isb();
+    }
+}
@@ -0,0 +1,189 @@
+/*******************************************************************************************
+ * @file    bare_spi.c
+ * @author  ka5j
+ * @brief   Bare-metal SPI1 transmit driver implementation for STM32F446RE
+ * @version 1.1
+ * @date    2025-06-14
+ *
+ * @note    SPI1 master on PA5 (SCK) / PA7 (MOSI), AF5. DMA2 Stream 3 channel 3 (SPI1_TX),
+ *          claimed from bare_dma, feeds DR; the transfer is reported complete only once BSY
+ *          clears, so the caller may immediately reuse the buffer or change the clock.
+ *******************************************************************************************/
+
+#include "bare_spi.h"
+#include "stm32f446re_addresses.h"
+#include "gpio_registers.h"
+#include "bare_gpio.h"
+#include "rcc_registers.h"
+#include "spi_registers.h"
+#include "bare_dma.h" // DMA stream driver
+#include <stddef.h>
+
+/*******************************************************************************************
+ *                                Configuration Constants
+ *******************************************************************************************/
+#define SPI_CR1_MSTR (1U << 2)      /*!< Master selection              */
+#define SPI_CR1_BR_POS 3U           /*!< Baud rate control position    */
+#define SPI_CR1_BR_MASK (7U << 3)   /*!< Baud rate control mask        */
+#define SPI_CR1_SPE (1U << 6)       /*!< SPI enable                    */
+#define SPI_CR1_SSI (1U << 8)       /*!< Internal slave select         */
+#define SPI_CR1_SSM (1U << 9)       /*!< Software slave management     */
+#define SPI_CR1_BIDIOE (1U << 14)   /*!< Output enable in bidi mode    */
+#define SPI_CR1_BIDIMODE (1U << 15) /*!< One-line bidirectional mode   */
+#define SPI_CR2_TXDMAEN (1U << 1)   /*!< TX buffer DMA enable          */
+#define SPI_SR_TXE (1U << 1)        /*!< Transmit buffer empty         */
+#define SPI_SR_BSY (1U << 7)        /*!< Busy flag                     */
+
+#define SPI_DMA_STREAM BARE_DMA2_STREAM3
+#define SPI_DMA_CHANNEL 3U /*!< DMA2 Stream 3 channel 3 = SPI1_TX */
+#define RCC_APB2ENR_SPI1EN (1U << 12)
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static volatile uint8_t dma_busy;
+static bare_spi_done_callback_t done_callback;
+
+/**
+ * @brief SPI1_TX stream: bytes to DR, direct mode
+ */
+static const Bare_DMA_Config_t spi_dma_cfg = {
+    .channel = SPI_DMA_CHANNEL,
+    .dir = BARE_DMA_M2P,
+    .mode = BARE_DMA_NORMAL,
+    .psize = BARE_DMA_BYTE,
+    .msize = BARE_DMA_BYTE,
+    .pinc = 0U,
+    .minc = 1U,
+    .priority = 2U,
+    .fifo = BARE_DMA_FIFO_DIRECT,
+    .pburst = BARE_DMA_BURST_SINGLE,
+    .mburst = BARE_DMA_BURST_SINGLE,
+    .events = BARE_DMA_EVT_DONE | BARE_DMA_EVT_ERROR,
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Wait until the last byte has been shifted out.
+ */
+static void bare_spi_wait_idle(void)
+{
+    while (!(SPI1->SR & SPI_SR_TXE))
+        ; // Wait for the last byte to reach the shift register
+    while (SPI1->SR & SPI_SR_BSY)
+        ; // Wait for the shift register to empty
+}
+
+/**
+ * @brief  DMA2 Stream 3 event (SPI1_TX): all bytes handed to SPI1.
+ * @param  events: raised events
+ *
+ * @note   Completion waits for BSY to clear (at most two byte times), so the callback
+ *         sees a fully idle bus.
+ */
+RAMFUNC static void bare_spi_dma_event(uint32_t events)
+{
+    if (events & (BARE_DMA_EVT_DONE | BARE_DMA_EVT_ERROR))
+    {
+        SPI1->CR2 &= ~SPI_CR2_TXDMAEN;
+        bare_dma_stop(SPI_DMA_STREAM);
+        bare_spi_wait_idle();
+
+        dma_busy = 0;
+        if (done_callback != NULL)
+        {
+            done_callback();
+        }
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Initialize SPI1 as transmit-only master, mode 0, 8-bit MSB first.
+ * @param  div: SCK divider
+ */
+void bare_spi_init(SPI_BaudDiv_t div)
+{
+    /* 1. Enable clocks for GPIOA and SPI1 */
+    bare_gpio_enable_clock(GPIOA);
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN;
+
+    /* 2. Configure PA5 (SCK) and PA7 (MOSI) to alternate function mode (AF5 = SPI1) */
+    bare_gpio_AF(GPIOA, GPIO_PIN5, AF5);
+    bare_gpio_AF(GPIOA, GPIO_PIN7, AF5);
+
+    /* 3. Master, one-line transmit, software NSS held high, CPOL = CPHA = 0 */
+    SPI1->CR1 = 0;
+    SPI1->CR1 = SPI_CR1_BIDIMODE | SPI_CR1_BIDIOE | SPI_CR1_SSM | SPI_CR1_SSI |
+                SPI_CR1_MSTR | (((uint32_t)div << SPI_CR1_BR_POS) & SPI_CR1_BR_MASK);
+    SPI1->CR2 = 0;
+
+    /* 4. Enable SPI1 */
+    SPI1->CR1 |= SPI_CR1_SPE;
+
+    /* 5. TX DMA stream (clock and interrupt enabled by bare_dma) */
+    bare_dma_claim(SPI_DMA_STREAM, &spi_dma_cfg, bare_spi_dma_event);
+}
+
+/**
+ * @brief  Change the SCK divider.
+ * @param  div: SCK divider
+ */
+void bare_spi_set_baud(SPI_BaudDiv_t div)
+{
+    while (dma_busy)
+        ; // Let the running DMA transfer finish
+    bare_spi_wait_idle();
+
+    SPI1->CR1 &= ~SPI_CR1_SPE;
+    SPI1->CR1 = (SPI1->CR1 & ~SPI_CR1_BR_MASK) | (((uint32_t)div << SPI_CR1_BR_POS) & SPI_CR1_BR_MASK);
+    SPI1->CR1 |= SPI_CR1_SPE;
+}
+
+/**
+ * @brief  Transmit a single byte via SPI1 (polling).
+ * @param  data: byte to transmit
+ */
+void bare_spi_send_byte(uint8_t data)
+{
+    while (!(SPI1->SR & SPI_SR_TXE))
+        ; // Wait for TXE (transmit buffer empty)
+    *(volatile uint8_t *)&SPI1->DR = data; // 8-bit access, one frame
+}
+
+/**
+ * @brief  Start a DMA transfer from memory to SPI1.
+ * @param  data: bytes to transmit
+ * @param  len: number of bytes
+ * @param  done_cb: end-of-transfer callback (ISR context, may be NULL)
+ * @retval 0 on success, -1 if busy or len is 0
+ */
+int bare_spi_send_dma(const uint8_t *data, uint16_t len, bare_spi_done_callback_t done_cb)
+{
+    if (dma_busy || len == 0U)
+    {
+        return -1;
+    }
+
+    dma_busy = 1;
+    done_callback = done_cb;
+
+    bare_dma_start(SPI_DMA_STREAM, (uint32_t)(uintptr_t)&SPI1->DR, data, NULL, len);
+    SPI1->CR2 |= SPI_CR2_TXDMAEN; // TXE is already set: the first request fires now
+    return 0;
+}
+
+/**
+ * @brief  Check whether a DMA transfer is running.
+ * @retval 1 while busy
+ */
+uint8_t bare_spi_busy(void)
+{
+    return dma_busy;
+}
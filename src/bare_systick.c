@@ -14,6 +14,11 @@
 #include "systick_registers.h"
 #include "bare_systick.h"
 
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static volatile uint32_t systick_ticks; // Incremented from SysTick_Handler
+
 /*******************************************************************************************
  * @brief  Initialize the SysTick timer
  *
@@ -53,3 +58,23 @@ void SysTick_Set_TIMER(uint32_t reload)
     SYSTICK->RVR = reload; // Set reload value
     SYSTICK->CVR = 0;      // Reset current value
 }
+
+/*******************************************************************************************
+ * @brief  Advance the system tick counter
+ *
+ * Called from SysTick_Handler. Only the ISR writes the counter, so no locking is needed.
+ *******************************************************************************************/
+void SysTick_Inc_Tick(void)
+{
+    systick_ticks++;
+}
+
+/*******************************************************************************************
+ * @brief  Read the system tick counter
+ *
+ * @return Number of SysTick interrupts since the timer was started
+ *******************************************************************************************/
+uint32_t SysTick_Get_Ticks(void)
+{
+    return systick_ticks;
+}
@@ -159,9 +159,22 @@ void bare_tim2_5_stop(TIM2_5_TypeDef *TIMx)
  * @param TIMx Pointer to timer peripheral (e.g., TIM2, TIM3, etc.)
  */
 void bare_tim2_5_PWM(TIM2_5_TypeDef *TIMx)
+{
+    bare_tim2_5_PWM_init(TIMx, TIM2_5_1KHZ_PRESCALER, TIM2_5_1SEC_ARR);
+}
+
+/**
+ * @brief Set TIM2–TIM5 timer to PWM mode in channel 1 with a custom period
+ *
+ * @param TIMx Pointer to timer peripheral (e.g., TIM2, TIM3, etc.)
+ * @param psc Prescaler value
+ * @param arr Auto-reload value
+ */
+void bare_tim2_5_PWM_init(TIM2_5_TypeDef *TIMx, uint32_t psc, uint32_t arr)
 {
     bare_tim2_5_enable_clock(TIMx);
-    bare_tim2_5_set(TIMx);      // Set prescaler and ARR
+    TIMx->PSC = psc;            // Set prescaler
+    TIMx->ARR = arr;            // Set PWM period
     TIMx->CCMR1 &= ~(0x7 << 4); // Clear OC1M
     TIMx->CCMR1 |= (0x6 << 4);  // OC1M = 110 (PMW mode 1)
     TIMx->CCMR1 |= (1 << 3);    // preload enable
@@ -186,3 +199,14 @@ void bare_pwm_set_duty(TIM2_5_TypeDef *TIMx, uint8_t percent)
     }
     TIMx->CCR1 = (TIMx->ARR * percent) / 100;
 }
+
+/**
+ * @brief Set the raw channel 1 compare value of TIM2–TIM5 timer in PWM mode
+ *
+ * @param TIMx Pointer to timer peripheral (e.g., TIM2, TIM3, etc.)
+ * @param compare CCR1 value, no division on the write path
+ */
+void bare_pwm_set_compare(TIM2_5_TypeDef *TIMx, uint32_t compare)
+{
+    TIMx->CCR1 = compare;
+}
@@ -1,12 +1,16 @@
 /*******************************************************************************************
  * @file    bare_usart.c
  * @author  ka5j
- * @brief   Bare-metal USART2 driver implementation for STM32F446RE
- * @version 1.0
+ * @brief   Bare-metal USART driver implementation for STM32F446RE
+ * @version 1.3
  * @date    2025-05-14
  *
- * @note    Provides basic UART transmit and receive functionality using polling.
- *          Uses USART2 (PA2 TX / PA3 RX) at 115200 baud, 8N1. No interrupts used.
+ * @note    Provides basic UART transmit and receive functionality on USART1-USART6, 8N1.
+ *          Polling is used until bare_usart_enable_interrupts() switches an instance's RX
+ *          and TX to its ISR. Every ISR runs the same handler on the handle registered
+ *          for its instance at bare_usart_open(). The baud rate divider is computed at run
+ *          time (OVER8 above PCLK / 16), and an instance can hunt for the host's rate.
+ *          Formatted output is written in place into the TX ring (fmt.c).
  *******************************************************************************************/
 
 #include "bare_usart.h"
@@ -14,74 +18,638 @@
 #include "gpio_registers.h"
 #include "bare_gpio.h"
 #include "rcc_registers.h"
-#include "usart_registers.h" // Must define USART2 base address and register map
+#include "usart_registers.h" // Must define USART1-USART6 base addresses and register map
+#include "nvic_registers.h"
+#include "bare_nvic.h"     // NVIC enable, BASEPRI critical sections
+#include "irq_priorities.h" // CRIT_CEILING_TERMINAL
+#include "trace.h"          // Event trace
+#include "perf.h"           // CPU load accounting
+#include "bare_systick.h"   // Auto-baud step hold-off
+#include "fmt.h"            // Formatted output
+#include <stddef.h>
 
 /*******************************************************************************************
  *                                Configuration Constants
  *******************************************************************************************/
-#define PCLK1_FREQ 16000000UL                                   /*!< APB1 peripheral clock frequency (Hz) */
-#define USART_BAUD 115200UL                                     /*!< Desired USART baud rate */
-#define USARTDIV ((PCLK1_FREQ + (USART_BAUD / 2)) / USART_BAUD) /*!< Rounded divisor */
+#define USART_INSTANCES 6U         /*!< USART1, USART2, USART3, UART4, UART5, USART6 */
+#define USART_NO_TRACE 0xFFU       /*!< Instance not recorded in the event trace     */
+#define USART_AUTOBAUD_HOLDOFF_MS 20U /*!< Garbage after a rate step belongs to the same burst */
+
+#define USART_SR_FE (1U << 1)      /*!< Framing error                */
+#define USART_SR_NE (1U << 2)      /*!< Noise detected               */
+#define USART_SR_RXNE (1U << 5)    /*!< Read data register not empty */
+#define USART_SR_TC (1U << 6)      /*!< Transmission complete        */
+#define USART_SR_TXE (1U << 7)     /*!< Transmit data register empty */
+#define USART_CR1_RE (1U << 2)     /*!< Receiver enable              */
+#define USART_CR1_TE (1U << 3)     /*!< Transmitter enable           */
+#define USART_CR1_RXNEIE (1U << 5) /*!< RXNE interrupt enable        */
+#define USART_CR1_TCIE (1U << 6)   /*!< TC interrupt enable          */
+#define USART_CR1_TXEIE (1U << 7)  /*!< TXE interrupt enable         */
+#define USART_CR1_UE (1U << 13)    /*!< USART enable                 */
+#define USART_CR1_OVER8 (1U << 15) /*!< Oversampling by 8            */
 
 /*******************************************************************************************
- *                               Public API Functions
+ *                                   Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Fixed resources of one USART instance
+ */
+typedef struct
+{
+    USART_TypeDef *regs; /*!< Registers                                     */
+    uint8_t apb2;        /*!< 1: clock enable in APB2ENR, 0: in APB1ENR     */
+    uint8_t rcc_bit;     /*!< Clock enable bit                              */
+    IRQn_t irqn;         /*!< NVIC interrupt                                */
+    uint8_t perf_src;    /*!< PERF source, PERF_SRC_COUNT if not accounted  */
+    uint8_t trace_src;   /*!< Trace source, USART_NO_TRACE if not recorded  */
+} Usart_Hw_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
  *******************************************************************************************/
+static const Usart_Hw_t usart_hw[USART_INSTANCES] = {
+    {USART1, 1U, 4U, USART1_IRQn, PERF_SRC_USART1, TRACE_SRC_USART1},
+    {USART2, 0U, 17U, USART2_IRQn, PERF_SRC_USART2, TRACE_SRC_USART2},
+    {USART3, 0U, 18U, USART3_IRQn, PERF_SRC_COUNT, USART_NO_TRACE},
+    {USART4, 0U, 19U, UART4_IRQn, PERF_SRC_COUNT, USART_NO_TRACE},
+    {USART5, 0U, 20U, UART5_IRQn, PERF_SRC_COUNT, USART_NO_TRACE},
+    {USART6, 1U, 5U, USART6_IRQn, PERF_SRC_COUNT, USART_NO_TRACE},
+};
+
+/* Rates tried by the auto-baud hunt, in order (entries out of tolerance are skipped) */
+static const uint32_t usart_autobaud_rates[] = {9600U,   19200U,  38400U,  57600U,   115200U,
+                                                230400U, 460800U, 921600U, 1000000U, 2000000U};
+#define USART_AUTOBAUD_RATES (sizeof(usart_autobaud_rates) / sizeof(usart_autobaud_rates[0]))
+
+static Bare_USART_t *usart_open[USART_INSTANCES]; // Handle served by each ISR
+static Bare_USART_t *console;                     // Target of bare_usart_send_*()
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Send the oldest queued byte by polling TXE.
+ *
+ * @note   Called with the terminal critical section held (or from the USART ISR itself,
+ *         e.g. when echoing from the RX callback), so the ISR cannot pop the same byte.
+ */
+static void bare_usart_drain_one(Bare_USART_t *usart)
+{
+    while (!(usart->regs->SR & USART_SR_TXE))
+        ; // Wait for TXE (transmit buffer empty)
+    usart->regs->DR = usart->tx_buffer[usart->tx_tail];
+    usart->tx_tail = (usart->tx_tail + 1U) & usart->tx_mask;
+}
+
+/**
+ * @brief  Make queued bytes up to head visible to the ISR and start sending (unless held).
+ *
+ * @note   Called with the terminal critical section held, like bare_usart_drain_one().
+ */
+static void usart_tx_publish(Bare_USART_t *usart, uint16_t head)
+{
+    usart->tx_head = head;
+
+    uint16_t depth = (head - usart->tx_tail) & usart->tx_mask;
+    if (depth > usart->tx_high_water)
+    {
+        usart->tx_high_water = depth;
+    }
+    if (usart->irq_mode && usart->tx_hold == 0U)
+    {
+        usart->regs->CR1 |= USART_CR1_TXEIE;
+    }
+}
+
+/**
+ * @brief  Formatter room provider: publish what is written and poll one byte out.
+ * @retval Free bytes in the ring (at least 1)
+ */
+static uint32_t usart_fmt_more(Fmt_Out_t *out)
+{
+    Bare_USART_t *usart = (Bare_USART_t *)out->context;
+
+    usart_tx_publish(usart, (uint16_t)(out->pos & usart->tx_mask));
+    bare_usart_drain_one(usart); // Ring full: make room by polling
+    return (uint16_t)(usart->tx_tail - usart->tx_head - 1U) & usart->tx_mask;
+}
+
+/**
+ * @brief  Compute the BRR value for a baud rate.
+ *
+ * @details
+ * Both oversampling modes give baud = PCLK / d, where d = round(PCLK / baud) is the divider
+ * in 1/16 (OVER16) or 1/8 (OVER8) steps. OVER16 covers d >= 16 with BRR = d; OVER8 reaches
+ * d = 8..15, with the fraction in BRR[2:0] and BRR[3] kept clear.
+ *
+ * @param  baud: requested rate
+ * @param  brr: BRR value (may be NULL)
+ * @param  over8: 1 if CR1.OVER8 must be set (may be NULL)
+ * @retval Actual rate, 0 if out of range or more than BARE_USART_BAUD_TOLERANCE off
+ */
+static uint32_t usart_divider(uint32_t baud, uint32_t *brr, uint8_t *over8)
+{
+    if (baud == 0U)
+    {
+        return 0U;
+    }
+    uint32_t d = (USART_PCLK_FREQ + (baud / 2U)) / baud;
+    if (d < 8U || d > 0xFFFFU)
+    {
+        return 0U;
+    }
+
+    uint32_t actual = USART_PCLK_FREQ / d;
+    uint32_t error = (actual > baud) ? actual - baud : baud - actual;
+    if (error * 1000U > baud * BARE_USART_BAUD_TOLERANCE)
+    {
+        return 0U;
+    }
+
+    if (brr != NULL)
+    {
+        *brr = (d >= 16U) ? d : (((d & ~7U) << 1) | (d & 7U));
+    }
+    if (over8 != NULL)
+    {
+        *over8 = (d < 16U) ? 1U : 0U;
+    }
+    return actual;
+}
+
+/**
+ * @brief  Program the divider and oversampling of a USART (briefly disabled).
+ * @retval 0 on success, -1 if the rate cannot be met
+ */
+static int usart_apply_baud(USART_TypeDef *regs, uint32_t baud)
+{
+    uint32_t brr;
+    uint8_t over8;
+    if (usart_divider(baud, &brr, &over8) == 0U)
+    {
+        return -1;
+    }
+
+    regs->CR1 &= ~USART_CR1_UE; // OVER8 and BRR only change while disabled
+    if (over8)
+    {
+        regs->CR1 |= USART_CR1_OVER8;
+    }
+    else
+    {
+        regs->CR1 &= ~USART_CR1_OVER8;
+    }
+    regs->BRR = brr;
+    regs->CR1 |= USART_CR1_UE;
+    return 0;
+}
 
 /**
- * @brief  Initialize USART2 peripheral for 115200 baud, 8N1 configuration.
+ * @brief  Auto-baud: check a received character, step to the next rate if garbled.
+ *
+ * @note   Characters of the same burst (the rest of a garbled frame, CR LF) arrive within
+ *         USART_AUTOBAUD_HOLDOFF_MS of the step and are dropped without stepping again.
+ * @retval 1 once locked (the character is BARE_USART_AUTOBAUD_CHAR), 0 while hunting
+ */
+RAMFUNC static uint8_t usart_autobaud_check(Bare_USART_t *usart, uint32_t sr, char c)
+{
+    if (c == BARE_USART_AUTOBAUD_CHAR && !(sr & (USART_SR_FE | USART_SR_NE)))
+    {
+        usart->autobaud = 0; // Locked at usart->baud
+        return 1U;
+    }
+
+    uint32_t now = SysTick_Get_Ticks();
+    if (now - usart->autobaud_tick < USART_AUTOBAUD_HOLDOFF_MS)
+    {
+        return 0U;
+    }
+    usart->autobaud_tick = now;
+
+    uint32_t entry = usart->autobaud; // Table index of the next rate
+    for (uint32_t tries = 0; tries < USART_AUTOBAUD_RATES; tries++)
+    {
+        entry %= USART_AUTOBAUD_RATES;
+        if (usart_apply_baud(usart->regs, usart_autobaud_rates[entry]) == 0)
+        {
+            usart->baud = usart_autobaud_rates[entry];
+            usart->autobaud = (uint8_t)(entry + 1U);
+            break;
+        }
+        entry++;
+    }
+    return 0U;
+}
+
+/**
+ * @brief  Common USART interrupt handler
+ *
+ * @details
+ * - RXNE: hands the received character to the RX callback (or the auto-baud hunt)
+ * - TXE:  sends the next byte of the TX ring, switches to TC once the ring is empty
+ * - TC:   reports the end of the transmission through the TX done callback
+ * Entry and exit (with the bytes left in the TX ring) are recorded in the event trace.
  *
- * @note   Uses GPIOA pins PA2 (TX) and PA3 (RX) in Alternate Function 7 (AF7).
- *         Configures TX, RX, and enables USART2 with polling-based I/O.
+ * @param  index: hardware instance 0-5
  */
-void bare_usart_init(void)
+RAMFUNC static void bare_usart_irq(uint32_t index)
 {
-    /* 1. Enable clocks for GPIOA and USART2 */
-    bare_gpio_enable_clock(GPIOA);
-    RCC->APB1ENR |= (1 << 17); // USART2 clock enable
+    const Usart_Hw_t *hw = &usart_hw[index];
+    Bare_USART_t *usart = usart_open[index];
+    USART_TypeDef *regs = hw->regs;
 
-    /* 2. Configure PA2 and PA3 to alternate function mode (AF7 = USART2) */
-    bare_gpio_AF(GPIOA, 2, AF7);
-    bare_gpio_AF(GPIOA, 3, AF7);
+    uint32_t start = perf_isr_enter();
+    if (hw->trace_src != USART_NO_TRACE)
+    {
+        trace_isr_enter((Trace_Source_t)hw->trace_src);
+    }
 
-    /* 3. Disable USART before configuration */
-    USART2->CR1 &= ~(1 << 13); // UE = 0
+    uint32_t sr = regs->SR;
+    uint32_t cr1 = regs->CR1;
 
-    /* 4. Set baud rate register (BRR) */
-    USART2->BRR = USARTDIV;
+    if (sr & USART_SR_RXNE)
+    {
+        char c = (char)(regs->DR & 0xFF); // Reading DR also clears ORE, FE and NE
+        if (usart != NULL && usart->autobaud != 0U && !usart_autobaud_check(usart, sr, c))
+        {
+            // Still hunting: the character is noise at the wrong rate
+        }
+        else if (usart != NULL && usart->rx_callback != NULL)
+        {
+            usart->rx_callback(usart->context, c);
+        }
+    }
 
-    /* 5. Enable transmitter and receiver */
-    USART2->CR1 |= (1 << 3); // TE = 1 (transmit enable)
-    USART2->CR1 |= (1 << 2); // RE = 1 (receive enable)
+    if (usart != NULL && (cr1 & USART_CR1_TXEIE) && (sr & USART_SR_TXE))
+    {
+        if (usart->tx_tail != usart->tx_head)
+        {
+            regs->DR = usart->tx_buffer[usart->tx_tail];
+            usart->tx_tail = (usart->tx_tail + 1U) & usart->tx_mask;
+        }
+        else
+        {
+            regs->CR1 &= ~USART_CR1_TXEIE; // Ring empty
+            regs->CR1 |= USART_CR1_TCIE;   // Wait for the last bit to leave
+        }
+    }
 
-    /* 6. Enable USART2 */
-    USART2->CR1 |= (1 << 13); // UE = 1
+    if ((cr1 & USART_CR1_TCIE) && (sr & USART_SR_TC))
+    {
+        regs->CR1 &= ~USART_CR1_TCIE;
+        regs->SR &= ~USART_SR_TC;
+        if (usart != NULL && usart->tx_done_callback != NULL && usart->tx_tail == usart->tx_head)
+        {
+            usart->tx_done_callback(usart->context);
+        }
+    }
 
-    // 7. Clear posile garbage in DR/SR
+    if (hw->trace_src != USART_NO_TRACE)
+    {
+        uint32_t left = (usart != NULL) ? ((usart->tx_head - usart->tx_tail) & usart->tx_mask) : 0U;
+        trace_isr_exit((Trace_Source_t)hw->trace_src, left);
+    }
+    if (hw->perf_src < PERF_SRC_COUNT)
+    {
+        perf_isr_exit((Perf_Source_t)hw->perf_src, start);
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Open a USART instance, 8N1, TX and RX enabled, polling I/O.
+ * @param  usart: handle
+ * @param  cfg: instance, pins and baud rate
+ * @retval 0 on success, -1 if unknown or already open
+ */
+int bare_usart_open(Bare_USART_t *usart, const Bare_USART_Config_t *cfg)
+{
+    uint32_t index = 0;
+    while (index < USART_INSTANCES && usart_hw[index].regs != cfg->regs)
+    {
+        index++;
+    }
+    if (index == USART_INSTANCES || usart_open[index] != NULL ||
+        usart_divider(cfg->baud, NULL, NULL) == 0U)
+    {
+        return -1;
+    }
+    const Usart_Hw_t *hw = &usart_hw[index];
+
+    /* 1. Enable clocks for the pin ports and the USART */
+    bare_gpio_enable_clock(cfg->tx_port);
+    bare_gpio_enable_clock(cfg->rx_port);
+    if (hw->apb2)
+    {
+        RCC->APB2ENR |= (1UL << hw->rcc_bit);
+    }
+    else
+    {
+        RCC->APB1ENR |= (1UL << hw->rcc_bit);
+    }
+
+    /* 2. Configure TX and RX to their alternate function */
+    bare_gpio_AF(cfg->tx_port, cfg->tx_pin, cfg->af);
+    bare_gpio_AF(cfg->rx_port, cfg->rx_pin, cfg->af);
+
+    /* 3. Disable USART, set divider and oversampling, enable it again */
+    if (usart_apply_baud(hw->regs, cfg->baud) != 0)
+    {
+        return -1;
+    }
+
+    /* 4. Enable transmitter and receiver */
+    hw->regs->CR1 |= USART_CR1_TE | USART_CR1_RE;
+
+    // 5. Clear possible garbage in DR/SR
     volatile uint32_t tmp;
 
-    tmp = USART2->SR;
-    tmp = USART2->DR;
+    tmp = hw->regs->SR;
+    tmp = hw->regs->DR;
     (void)tmp;
 
+    usart->regs = hw->regs;
+    usart->index = (uint8_t)index;
+    usart->baud = cfg->baud;
+    usart->tx_head = 0;
+    usart->tx_tail = 0;
+    usart->irq_mode = 0;
+    usart_open[index] = usart;
+
     // Delay to wait for initialization
     int x = 100000;
     while (x--)
         ;
+    return 0;
+}
+
+/**
+ * @brief  Enable interrupt-driven RX/TX on a USART.
+ * @param  usart: handle
+ * @param  rx_cb: called from the ISR for every received character (may be NULL)
+ * @param  tx_done_cb: called from the ISR when the TX ring empties (may be NULL)
+ * @param  context: handed to both callbacks
+ */
+void bare_usart_enable_interrupts(Bare_USART_t *usart, bare_usart_rx_callback_t rx_cb,
+                                  bare_usart_tx_done_callback_t tx_done_cb, void *context)
+{
+    usart->rx_callback = rx_cb;
+    usart->tx_done_callback = tx_done_cb;
+    usart->context = context;
+    usart->irq_mode = 1;
+
+    usart->regs->CR1 |= USART_CR1_RXNEIE; // RXNE interrupt
+    bare_nvic_enable_irq(usart_hw[usart->index].irqn);
+}
+
+/**
+ * @brief  Change the baud rate of an open USART, ending an auto-baud hunt.
+ * @param  usart: handle
+ * @param  baud: new rate
+ * @retval 0 on success, -1 if the rate cannot be met
+ */
+int bare_usart_set_baud(Bare_USART_t *usart, uint32_t baud)
+{
+    // The hunt steps the rate from the ISR: keep it out while the rate is replaced
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+    int status = usart_apply_baud(usart->regs, baud);
+    if (status == 0)
+    {
+        usart->autobaud = 0;
+        usart->baud = baud;
+    }
+    bare_nvic_crit_exit(crit);
+    return status;
 }
 
 /**
- * @brief  Send a single character over USART2.
+ * @brief  Get the rate the divider for a baud rate produces.
+ * @param  baud: requested rate
+ * @retval Actual rate, 0 if not supported
+ */
+uint32_t bare_usart_actual_baud(uint32_t baud)
+{
+    return usart_divider(baud, NULL, NULL);
+}
+
+/**
+ * @brief  Wait until everything queued has left the USART.
+ * @param  usart: handle
+ */
+void bare_usart_flush(Bare_USART_t *usart)
+{
+    if (usart->irq_mode)
+    {
+        // The ISR clears TC itself: idle once the ring is empty and TXEIE/TCIE are both off
+        while (usart->tx_tail != usart->tx_head ||
+               (usart->regs->CR1 & (USART_CR1_TXEIE | USART_CR1_TCIE)))
+            ;
+    }
+    else
+    {
+        while (!(usart->regs->SR & USART_SR_TC))
+            ; // Wait for the last stop bit
+    }
+}
+
+/**
+ * @brief  Start hunting for the host's baud rate.
+ * @param  usart: handle (interrupts enabled)
+ */
+void bare_usart_autobaud(Bare_USART_t *usart)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+
+    usart->autobaud = 0;          // Hunt restarts at the first table rate
+    usart->autobaud_tick = SysTick_Get_Ticks() - USART_AUTOBAUD_HOLDOFF_MS;
+    (void)usart_autobaud_check(usart, USART_SR_FE, '\0'); // Step to the first usable rate
+
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Send a single character on a USART.
+ * @param  usart: handle
+ * @param  c: character to send
+ */
+void bare_usart_write_char(Bare_USART_t *usart, char c)
+{
+    if (!usart->irq_mode)
+    {
+        while (!(usart->regs->SR & USART_SR_TXE))
+            ; // Wait for TXE (transmit buffer empty)
+        usart->regs->DR = (uint8_t)c;
+        return;
+    }
+
+    // Thread code and the USART ISRs (echo) both append: mask terminal-level interrupts
+    // only, so PWM/DMA interrupts keep their latency while the ring is updated
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+
+    uint16_t next = (usart->tx_head + 1U) & usart->tx_mask;
+    while (next == usart->tx_tail)
+    {
+        bare_usart_drain_one(usart); // Ring full: make room by polling
+    }
+
+    usart->tx_buffer[usart->tx_head] = (uint8_t)c;
+    usart_tx_publish(usart, next);
+
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Send a null-terminated string on a USART.
+ * @param  usart: handle
+ * @param  str: pointer to null-terminated character array
+ */
+void bare_usart_write_string(Bare_USART_t *usart, const char *str)
+{
+    while (*str)
+    {
+        bare_usart_write_char(usart, *str++);
+    }
+}
+
+/**
+ * @brief  Format directly into the TX ring of a USART.
+ * @param  usart: handle
+ * @param  fmt: format string (fmt.h)
+ * @retval Characters written
+ */
+uint32_t bare_usart_write_fmt(Bare_USART_t *usart, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    uint32_t n = bare_usart_write_vfmt(usart, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/**
+ * @brief  Format directly into the TX ring of a USART.
+ * @param  usart: handle
+ * @param  fmt: format string (fmt.h)
+ * @param  ap: arguments
+ * @retval Characters written
+ */
+uint32_t bare_usart_write_vfmt(Bare_USART_t *usart, const char *fmt, va_list ap)
+{
+    // Same ceiling as bare_usart_write_char(): the echo from the USART ISRs appends too.
+    // The ring is not volatile to the formatter: the ISR cannot run until the head moves.
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+
+    Fmt_Out_t out = {(uint8_t *)usart->tx_buffer, usart->tx_mask, usart->tx_head,
+                     (uint16_t)(usart->tx_tail - usart->tx_head - 1U) & usart->tx_mask,
+                     usart_fmt_more, usart, 0};
+    uint32_t n = fmt_vprint(&out, fmt, ap);
+    usart_tx_publish(usart, (uint16_t)(out.pos & usart->tx_mask));
+
+    if (!usart->irq_mode)
+    {
+        while (usart->tx_tail != usart->tx_head)
+        {
+            bare_usart_drain_one(usart); // Polling mode: the ring was only a staging area
+        }
+    }
+
+    bare_nvic_crit_exit(crit);
+    return n;
+}
+
+/**
+ * @brief  Queue output without starting the transmission.
+ * @param  usart: handle (NULL is ignored)
+ */
+void bare_usart_tx_hold(Bare_USART_t *usart)
+{
+    if (usart == NULL)
+    {
+        return;
+    }
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+    usart->tx_hold++;
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  End a hold and send what was queued.
+ * @param  usart: handle (NULL is ignored)
+ */
+void bare_usart_tx_release(Bare_USART_t *usart)
+{
+    if (usart == NULL)
+    {
+        return;
+    }
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+    if (usart->tx_hold > 0U && --usart->tx_hold == 0U)
+    {
+        usart_tx_publish(usart, usart->tx_head);
+    }
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Receive a single character from a USART (polling).
+ * @param  usart: handle
+ * @retval The received character
+ */
+char bare_usart_read(Bare_USART_t *usart)
+{
+    while (!(usart->regs->SR & USART_SR_RXNE))
+        ; // Wait for RXNE (receive buffer not empty)
+    return (char)(usart->regs->DR & 0xFF);
+}
+
+/**
+ * @brief  Get the deepest fill of a TX ring.
+ * @param  usart: handle
+ * @retval Bytes
+ */
+uint16_t bare_usart_tx_high_water(const Bare_USART_t *usart)
+{
+    return usart->tx_high_water;
+}
+
+/**
+ * @brief  Select the console USART.
+ * @param  usart: handle, NULL to discard console output
+ */
+void bare_usart_set_console(Bare_USART_t *usart)
+{
+    console = usart;
+}
+
+/**
+ * @brief  Get the console USART.
+ * @retval Handle, or NULL
+ */
+Bare_USART_t *bare_usart_get_console(void)
+{
+    return console;
+}
+
+/**
+ * @brief  Send a single character to the console.
  * @param  c: character to send
  */
 void bare_usart_send_char(char c)
 {
-    while (!(USART2->SR & (1 << 7)))
-        ; // Wait for TXE (transmit buffer empty)
-    USART2->DR = (uint8_t)c;
+    Bare_USART_t *usart = console;
+    if (usart != NULL)
+    {
+        bare_usart_write_char(usart, c);
+    }
 }
 
 /**
- * @brief  Send a null-terminated string over USART2.
+ * @brief  Send a null-terminated string to the console.
  * @param  str: pointer to null-terminated character array
  */
 void bare_usart_send_string(const char *str)
@@ -93,14 +661,67 @@ void bare_usart_send_string(const char *str)
 }
 
 /**
- * @brief  Receive a single character via USART2.
- * @retval The received character
+ * @brief  Transmit an unsigned integer in decimal to the console.
+ * @param  value: value to transmit
+ */
+void bare_usart_send_uint(uint32_t value)
+{
+    char digits[10]; // 4294967295 has 10 digits
+    uint32_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+
+    while (count > 0U)
+    {
+        bare_usart_send_char(digits[--count]);
+    }
+}
+
+/**
+ * @brief  Transmit a 32-bit value as 8 hex digits to the console.
+ * @param  value: value to transmit
+ */
+void bare_usart_send_hex32(uint32_t value)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    for (int32_t shift = 28; shift >= 0; shift -= 4)
+    {
+        bare_usart_send_char(hex[(value >> shift) & 0xFU]);
+    }
+}
+
+/**
+ * @brief  Format directly into the console's TX ring.
+ * @param  fmt: format string (fmt.h)
+ * @retval Characters written, 0 without a console
+ */
+uint32_t bare_usart_send_fmt(const char *fmt, ...)
+{
+    Bare_USART_t *usart = console;
+    uint32_t n = 0;
+
+    if (usart != NULL)
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        n = bare_usart_write_vfmt(usart, fmt, ap);
+        va_end(ap);
+    }
+    return n;
+}
+
+/**
+ * @brief  Receive a single character from the console (polling).
+ * @retval The received character, '\r' without a console
  */
 char bare_usart_read_char(void)
 {
-    while (!(USART2->SR & (1 << 5)))
-        ; // Wait for RXNE (receive buffer not empty)
-    return (char)(USART2->DR & 0xFF);
+    return (console != NULL) ? bare_usart_read(console) : '\r';
 }
 
 /**
@@ -111,3 +732,19 @@ void bare_usart_clear_screen(void)
 {
     bare_usart_send_string("\033[2J\033[H");
 }
+
+/*******************************************************************************************
+ *                                  Interrupt Handlers
+ *******************************************************************************************/
+#define USART_IRQ_HANDLER(handler, index) \
+    RAMFUNC void handler(void)            \
+    {                                     \
+        bare_usart_irq(index);            \
+    }
+
+USART_IRQ_HANDLER(USART1_IRQHandler, 0U)
+USART_IRQ_HANDLER(USART2_IRQHandler, 1U)
+USART_IRQ_HANDLER(USART3_IRQHandler, 2U)
+USART_IRQ_HANDLER(UART4_IRQHandler, 3U)
+USART_IRQ_HANDLER(UART5_IRQHandler, 4U)
+USART_IRQ_HANDLER(USART6_IRQHandler, 5U)
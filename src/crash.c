@@ -0,0 +1,349 @@
+/*******************************************************************************************
+ * @file    crash.c
+ * @author  ka5j
+ * @brief   Fault handlers with a post-mortem crash record kept across resets
+ * @version 1.0
+ * @date    2025-06-17
+ *
+ * @details
+ * The fault handler runs on its own small stack: a stack overflow is a likely cause of
+ * the fault, and the capture code must neither need the broken stack nor overwrite the
+ * frame it is about to save. Pointers taken from the faulting context are checked
+ * against the RAM bounds before they are read, so a corrupt SP cannot fault again
+ * inside the handler (which would lock up the core instead of resetting it).
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "crash.h"
+#include "stm32f446re_addresses.h" // SRAM1_BASE
+#include "scb_registers.h"         // Fault status, AIRCR
+#include "mpu_registers.h"         // MPU off while capturing
+#include "bare_core.h"             // IPSR, barriers
+#include "bare_systick.h"          // Uptime
+#include "bare_usart.h"            // Terminal output
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define CRASH_MAGIC 0xDEADFA17UL
+#define CRASH_FAULT_STACK_BYTES 512 /*!< Stack of the capture code (no suffix: used in asm) */
+#define CRASH_FRAME_WORDS 8U         /*!< Basic exception frame, r0 - xPSR   */
+#define CRASH_FRAME_FP_WORDS 26U     /*!< Frame with FPU state (s0-s15, FPSCR) */
+#define CRASH_EXC_RETURN_NOFP (1UL << 4)
+
+#define CRASH_STR(x) #x
+#define CRASH_XSTR(x) CRASH_STR(x)
+
+/*******************************************************************************************
+ *                                   Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Name of one fault status bit
+ */
+typedef struct
+{
+    uint32_t mask;
+    const char *name;
+} Crash_Flag_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+extern uint32_t _estack; // Linker script: top of RAM
+
+static Crash_Record_t crash_record __attribute__((section(".noinit")));
+
+__attribute__((used, aligned(8))) static uint32_t crash_fault_stack[CRASH_FAULT_STACK_BYTES / 4];
+
+static const Crash_Flag_t crash_cfsr_flags[] = {
+    {1UL << 0, "IACCVIOL"},  {1UL << 1, "DACCVIOL"},     {1UL << 3, "MUNSTKERR"},
+    {1UL << 4, "MSTKERR"},   {1UL << 5, "MLSPERR"},      {1UL << 8, "IBUSERR"},
+    {1UL << 9, "PRECISERR"}, {1UL << 10, "IMPRECISERR"}, {1UL << 11, "UNSTKERR"},
+    {1UL << 12, "STKERR"},   {1UL << 13, "LSPERR"},      {1UL << 16, "UNDEFINSTR"},
+    {1UL << 17, "INVSTATE"}, {1UL << 18, "INVPC"},       {1UL << 19, "NOCP"},
+    {1UL << 24, "UNALIGNED"}, {1UL << 25, "DIVBYZERO"},
+};
+
+static const Crash_Flag_t crash_hfsr_flags[] = {
+    {1UL << 1, "VECTTBL"},
+    {1UL << 30, "FORCED"},
+    {1UL << 31, "DEBUGEVT"},
+};
+
+static const char *const crash_exception_names[] = {
+    [3] = "HARDFAULT",
+    [4] = "MEMMANAGE",
+    [5] = "BUSFAULT",
+    [6] = "USAGEFAULT",
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Checksum over every record word before the checksum itself.
+ * @param  rec: record
+ * @retval Checksum
+ */
+static uint32_t crash_checksum(const Crash_Record_t *rec)
+{
+    const uint32_t *w = (const uint32_t *)rec;
+    uint32_t sum = 0x5A5A5A5AUL;
+
+    for (uint32_t i = 0; i < offsetof(Crash_Record_t, check) / sizeof(uint32_t); i++)
+    {
+        sum = (sum << 1 | sum >> 31) ^ w[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief  Check that the record holds a fault.
+ * @retval 1 if valid
+ */
+static uint8_t crash_record_valid(void)
+{
+    return (crash_record.magic == CRASH_MAGIC) &&
+           (crash_record.check == crash_checksum(&crash_record));
+}
+
+/**
+ * @brief  Check that words can be read from RAM without faulting.
+ * @param  addr: first word
+ * @param  words: number of words
+ * @retval 1 if [addr, addr + 4 * words) lies in RAM and is word aligned
+ */
+static uint8_t crash_ram_readable(uint32_t addr, uint32_t words)
+{
+    uint32_t top = (uint32_t)(uintptr_t)&_estack;
+
+    return ((addr & 3U) == 0U) && (addr >= SRAM1_BASE) && (addr < top) &&
+           (words <= (top - addr) / 4U);
+}
+
+/**
+ * @brief  Fill the crash record and reset (fault handler context, fault stack).
+ * @param  frame: exception frame of the faulting code
+ * @param  exc_return: EXC_RETURN value of the fault entry
+ */
+__attribute__((used, noreturn)) static void crash_capture(const uint32_t *frame,
+                                                         uint32_t exc_return)
+{
+    Crash_Record_t *rec = &crash_record;
+
+    // The frame of a stack overflow may sit in the MPU stack guard
+    MPU->CTRL = 0U;
+    bare_core_dsb();
+    bare_core_isb();
+
+    uint32_t count = crash_record_valid() ? rec->count : 0U;
+    uint32_t addr = (uint32_t)(uintptr_t)frame;
+
+    rec->magic = CRASH_MAGIC;
+    rec->count = count + 1U;
+    rec->exception = bare_core_get_ipsr() & 0x1FFU;
+    rec->exc_return = exc_return;
+    rec->sp = addr;
+    rec->cfsr = SCB->CFSR;
+    rec->hfsr = SCB->HFSR;
+    rec->mmfar = SCB->MMFAR;
+    rec->bfar = SCB->BFAR;
+    rec->ticks = SysTick_Get_Ticks();
+
+    uint32_t regs[CRASH_FRAME_WORDS] = {0};
+    if (crash_ram_readable(addr, CRASH_FRAME_WORDS))
+    {
+        for (uint32_t i = 0; i < CRASH_FRAME_WORDS; i++)
+        {
+            regs[i] = frame[i];
+        }
+    }
+    rec->r0 = regs[0];
+    rec->r1 = regs[1];
+    rec->r2 = regs[2];
+    rec->r3 = regs[3];
+    rec->r12 = regs[4];
+    rec->lr = regs[5];
+    rec->pc = regs[6];
+    rec->xpsr = regs[7];
+
+    // Caller's stack starts after the frame (and the FPU state, if it was stacked)
+    uint32_t skip = (exc_return & CRASH_EXC_RETURN_NOFP) ? CRASH_FRAME_WORDS
+                                                         : CRASH_FRAME_FP_WORDS;
+    uint32_t n = 0;
+    while (n < CRASH_STACK_WORDS && crash_ram_readable(addr + 4U * (skip + n), 1U))
+    {
+        rec->stack[n] = frame[skip + n];
+        n++;
+    }
+    rec->stack_words = n;
+    while (n < CRASH_STACK_WORDS)
+    {
+        rec->stack[n++] = 0U;
+    }
+
+    rec->check = crash_checksum(rec);
+
+    bare_core_dsb(); // Record in RAM before the reset
+    SCB->AIRCR = SCB_AIRCR_VECTKEY | (SCB->AIRCR & SCB_AIRCR_PRIGROUP_MASK) |
+                 SCB_AIRCR_SYSRESETREQ;
+    bare_core_dsb();
+
+    while (1)
+        ; // Reset is pending
+}
+
+/**
+ * @brief  Print the names of the bits set in a fault status register.
+ * @param  value: register value
+ * @param  flags: bit names
+ * @param  count: number of bit names
+ */
+static void crash_send_flags(uint32_t value, const Crash_Flag_t *flags, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (value & flags[i].mask)
+        {
+            bare_usart_send_char(' ');
+            bare_usart_send_string(flags[i].name);
+        }
+    }
+}
+
+/**
+ * @brief  Print "<label> <value>" with the value in hex.
+ */
+static void crash_send_reg(const char *label, uint32_t value)
+{
+    bare_usart_send_string(label);
+    bare_usart_send_hex32(value);
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Enable the configurable fault exceptions and divide-by-zero trapping.
+ */
+void crash_init(void)
+{
+    SCB->CCR |= SCB_CCR_DIV_0_TRP;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA | SCB_SHCSR_BUSFAULTENA | SCB_SHCSR_USGFAULTENA;
+}
+
+/**
+ * @brief  Get the record of the last fault.
+ * @retval Pointer to the record, NULL if none
+ */
+const Crash_Record_t *crash_get_record(void)
+{
+    return crash_record_valid() ? &crash_record : NULL;
+}
+
+/**
+ * @brief  Print the recorded fault to the terminal.
+ */
+void crash_report(void)
+{
+    const Crash_Record_t *rec = crash_get_record();
+    if (rec == NULL)
+    {
+        bare_usart_send_string("\nNO CRASH RECORDED\r");
+        return;
+    }
+
+    const char *name = "EXCEPTION";
+    if (rec->exception >= 3U && rec->exception <= 6U)
+    {
+        name = crash_exception_names[rec->exception];
+    }
+    bare_usart_send_string("\n");
+    bare_usart_send_string(name);
+    bare_usart_send_string(" AT ");
+    bare_usart_send_uint(rec->ticks);
+    bare_usart_send_string(" MS (FAULTS ");
+    bare_usart_send_uint(rec->count);
+    bare_usart_send_string(")");
+
+    crash_send_reg("\r\nPC  ", rec->pc);
+    crash_send_reg(" LR  ", rec->lr);
+    crash_send_reg(" SP  ", rec->sp);
+    crash_send_reg(" PSR ", rec->xpsr);
+    crash_send_reg("\r\nR0  ", rec->r0);
+    crash_send_reg(" R1  ", rec->r1);
+    crash_send_reg(" R2  ", rec->r2);
+    crash_send_reg(" R3  ", rec->r3);
+    crash_send_reg(" R12 ", rec->r12);
+    crash_send_reg("\r\nEXC_RETURN ", rec->exc_return);
+    bare_usart_send_string((rec->exc_return & 0x4U) ? " (TASK STACK)" : " (MAIN STACK)");
+
+    crash_send_reg("\r\nCFSR ", rec->cfsr);
+    crash_send_flags(rec->cfsr, crash_cfsr_flags,
+                     sizeof(crash_cfsr_flags) / sizeof(crash_cfsr_flags[0]));
+    crash_send_reg("\r\nHFSR ", rec->hfsr);
+    crash_send_flags(rec->hfsr, crash_hfsr_flags,
+                     sizeof(crash_hfsr_flags) / sizeof(crash_hfsr_flags[0]));
+    if (rec->cfsr & SCB_CFSR_MMARVALID)
+    {
+        crash_send_reg("\r\nMMFAR ", rec->mmfar);
+    }
+    if (rec->cfsr & SCB_CFSR_BFARVALID)
+    {
+        crash_send_reg("\r\nBFAR ", rec->bfar);
+    }
+
+    bare_usart_send_string("\r\nSTACK");
+    for (uint32_t i = 0; i < rec->stack_words && i < CRASH_STACK_WORDS; i++)
+    {
+        bare_usart_send_string((i % 4U == 0U) ? "\r\n  " : " ");
+        bare_usart_send_hex32(rec->stack[i]);
+    }
+    bare_usart_send_string("\r");
+}
+
+/**
+ * @brief  Forget the recorded fault.
+ */
+void crash_clear(void)
+{
+    crash_record.magic = 0U;
+}
+
+/**
+ * @brief  Execute an undefined instruction (UsageFault UNDEFINSTR).
+ */
+void crash_test(void)
+{
+    __asm volatile("udf #0" ::: "memory");
+}
+
+/*******************************************************************************************
+ *                                  Exception Handlers
+ *******************************************************************************************/
+
+/**
+ * @brief  Common fault entry: pick the faulting stack, switch to the fault stack, capture.
+ */
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile(
+        "   tst     lr, #4                           \n" // EXC_RETURN bit 2: task stack (PSP)
+        "   ite     eq                               \n"
+        "   mrseq   r0, msp                          \n"
+        "   mrsne   r0, psp                          \n"
+        "   mov     r1, lr                           \n"
+        "   movw    r2, #:lower16:crash_fault_stack+" CRASH_XSTR(CRASH_FAULT_STACK_BYTES) " \n"
+        "   movt    r2, #:upper16:crash_fault_stack+" CRASH_XSTR(CRASH_FAULT_STACK_BYTES) " \n"
+        "   msr     msp, r2                          \n"
+        "   b       crash_capture                    \n");
+}
+
+void MemManage_Handler(void) __attribute__((alias("HardFault_Handler")));
+void BusFault_Handler(void) __attribute__((alias("HardFault_Handler")));
+void UsageFault_Handler(void) __attribute__((alias("HardFault_Handler")));
@@ -0,0 +1,196 @@
+/*******************************************************************************************
+ * @file    dsp_bench.c
+ * @author  ka5j
+ * @brief   On-target cycle benchmark of the Q15 DSP kernels against their scalar versions
+ * @version 1.1
+ * @date    2025-06-12
+ *
+ * @details
+ * The four channel buffers are only needed while the benchmark runs, so they come from
+ * the scratch arena (released by process_cmd() after the command) instead of .bss.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "dsp_bench.h"
+#include "dsp_q15.h"
+#include "bare_dwt.h" // Cycle counter
+#include "mem_pool.h" // Scratch arena
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static int16_t *bench_a; // Scratch arena buffers of DSP_BENCH_CHANNELS (8-byte aligned)
+static int16_t *bench_b;
+static int16_t *bench_scalar;
+static int16_t *bench_packed;
+
+static const char *const bench_names[DSP_BENCH_COUNT] = {
+    [DSP_BENCH_SCALE] = "SCALE",
+    [DSP_BENCH_BLEND] = "BLEND",
+    [DSP_BENCH_ADD_SAT] = "ADD_SAT",
+    [DSP_BENCH_GAMMA] = "GAMMA",
+    [DSP_BENCH_DITHER] = "DITHER",
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Fill the inputs with a fixed xorshift sequence (includes negative values).
+ */
+static void bench_fill_inputs(void)
+{
+    uint32_t x = 0x2545F491U;
+
+    for (uint32_t i = 0; i < DSP_BENCH_CHANNELS; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        bench_a[i] = (int16_t)x;
+        bench_b[i] = (int16_t)(x >> 16);
+    }
+}
+
+/**
+ * @brief  Run one version of a kernel into the given output buffer.
+ * @param  kernel: kernel id
+ * @param  packed: 1 for the DSP version, 0 for the scalar reference
+ * @param  out: output buffer (the dither kernel writes bytes into it)
+ */
+static void bench_call(Dsp_Bench_Kernel_t kernel, uint32_t packed, int16_t *out)
+{
+    const uint32_t n = DSP_BENCH_CHANNELS;
+
+    if (kernel == DSP_BENCH_SCALE)
+    {
+        if (packed)
+        {
+            dsp_q15_scale(out, bench_a, 0x1800, n); // x1.5, saturates
+        }
+        else
+        {
+            dsp_q15_scale_scalar(out, bench_a, 0x1800, n);
+        }
+    }
+    else if (kernel == DSP_BENCH_BLEND)
+    {
+        if (packed)
+        {
+            dsp_q15_blend(out, bench_a, bench_b, 0x1555U, n); // 1/3 towards b
+        }
+        else
+        {
+            dsp_q15_blend_scalar(out, bench_a, bench_b, 0x1555U, n);
+        }
+    }
+    else if (kernel == DSP_BENCH_ADD_SAT)
+    {
+        if (packed)
+        {
+            dsp_q15_add_sat(out, bench_a, bench_b, n);
+        }
+        else
+        {
+            dsp_q15_add_sat_scalar(out, bench_a, bench_b, n);
+        }
+    }
+    else if (kernel == DSP_BENCH_GAMMA)
+    {
+        if (packed)
+        {
+            dsp_q15_gamma(out, bench_a, n);
+        }
+        else
+        {
+            dsp_q15_gamma_scalar(out, bench_a, n);
+        }
+    }
+    else
+    {
+        if (packed)
+        {
+            dsp_q15_dither_u8((uint8_t *)out, bench_a, n, 1U);
+        }
+        else
+        {
+            dsp_q15_dither_u8_scalar((uint8_t *)out, bench_a, n, 1U);
+        }
+    }
+}
+
+/**
+ * @brief  Time the fastest of DSP_BENCH_RUNS calls.
+ * @retval Cycles for one batch of DSP_BENCH_CHANNELS channels
+ */
+static uint32_t bench_time(Dsp_Bench_Kernel_t kernel, uint32_t packed, int16_t *out)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (uint32_t run = 0; run < DSP_BENCH_RUNS; run++)
+    {
+        uint32_t start = bare_dwt_get_cycles();
+        bench_call(kernel, packed, out);
+        uint32_t cycles = bare_dwt_get_cycles() - start;
+        if (cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Run every kernel benchmark.
+ * @param  results: array of DSP_BENCH_COUNT entries
+ * @retval 0 on success, -1 if the scratch arena cannot hold the buffers
+ */
+int dsp_bench_run(Dsp_Bench_Result_t *results)
+{
+    const uint32_t buf_bytes = DSP_BENCH_CHANNELS * sizeof(int16_t);
+    Mem_Arena_t *scratch = mem_scratch();
+
+    bench_a = mem_arena_alloc(scratch, buf_bytes);
+    bench_b = mem_arena_alloc(scratch, buf_bytes);
+    bench_scalar = mem_arena_alloc(scratch, buf_bytes);
+    bench_packed = mem_arena_alloc(scratch, buf_bytes);
+    if (bench_a == NULL || bench_b == NULL || bench_scalar == NULL || bench_packed == NULL)
+    {
+        return -1;
+    }
+
+    bench_fill_inputs();
+
+    for (uint32_t k = 0; k < DSP_BENCH_COUNT; k++)
+    {
+        Dsp_Bench_Result_t *r = &results[k];
+
+        r->name = bench_names[k];
+        r->scalar_cycles = bench_time((Dsp_Bench_Kernel_t)k, 0U, bench_scalar);
+        r->packed_cycles = bench_time((Dsp_Bench_Kernel_t)k, 1U, bench_packed);
+
+        // The dither kernel writes one byte per channel, the others one halfword
+        const uint8_t *s = (const uint8_t *)bench_scalar;
+        const uint8_t *p = (const uint8_t *)bench_packed;
+        uint32_t bytes = (k == DSP_BENCH_DITHER) ? DSP_BENCH_CHANNELS : 2U * DSP_BENCH_CHANNELS;
+
+        r->match = 1U;
+        for (uint32_t i = 0; i < bytes; i++)
+        {
+            if (s[i] != p[i])
+            {
+                r->match = 0U;
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,420 @@
+/*******************************************************************************************
+ * @file    dsp_q15.c
+ * @author  ka5j
+ * @brief   Q15 fixed-point kernels for batch brightness computation
+ * @version 1.0
+ * @date    2025-06-12
+ *
+ * @details
+ * The packed kernels are written once against a handful of DSP instruction wrappers.
+ * On Cortex-M4 each wrapper is a single instruction; elsewhere it is a C emulation of the
+ * exact ARMv7E-M semantics, which is what makes the two builds bit-exact.
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "dsp_q15.h"
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Two Q15 channels in one word (low halfword = lower index)
+ */
+typedef uint32_t Dsp_Pair_t __attribute__((may_alias));
+
+/*******************************************************************************************
+ *                                   Private Constants
+ *******************************************************************************************/
+
+/**
+ * @brief round(32767 * (i / 256)^2.2), one extra entry for interpolation at full scale
+ */
+static const int16_t dsp_gamma_lut[DSP_GAMMA_LUT_SIZE] = {
+        0,     0,     1,     2,     3,     6,     8,    12,    16,    21,    26,    32,
+       39,    47,    55,    64,    74,    84,    95,   107,   120,   134,   148,   163,
+      179,   196,   214,   232,   252,   272,   293,   315,   338,   361,   386,   411,
+      438,   465,   493,   522,   552,   583,   614,   647,   681,   715,   751,   787,
+      824,   862,   902,   942,   983,  1025,  1068,  1112,  1157,  1203,  1250,  1298,
+     1347,  1396,  1447,  1499,  1552,  1606,  1661,  1717,  1773,  1831,  1890,  1950,
+     2011,  2073,  2136,  2200,  2265,  2331,  2398,  2467,  2536,  2606,  2677,  2750,
+     2823,  2898,  2973,  3050,  3127,  3206,  3286,  3367,  3449,  3532,  3616,  3701,
+     3787,  3874,  3963,  4052,  4143,  4235,  4327,  4421,  4516,  4612,  4710,  4808,
+     4907,  5008,  5109,  5212,  5316,  5421,  5527,  5634,  5743,  5852,  5963,  6075,
+     6187,  6301,  6417,  6533,  6650,  6769,  6888,  7009,  7131,  7254,  7379,  7504,
+     7631,  7759,  7887,  8018,  8149,  8281,  8415,  8550,  8685,  8822,  8961,  9100,
+     9241,  9382,  9525,  9670,  9815,  9961, 10109, 10258, 10408, 10559, 10712, 10865,
+    11020, 11176, 11333, 11492, 11651, 11812, 11974, 12137, 12302, 12467, 12634, 12802,
+    12971, 13142, 13314, 13487, 13661, 13836, 14013, 14190, 14369, 14550, 14731, 14914,
+    15098, 15283, 15469, 15657, 15846, 16036, 16227, 16420, 16613, 16808, 17005, 17202,
+    17401, 17601, 17802, 18005, 18208, 18413, 18620, 18827, 19036, 19246, 19457, 19670,
+    19884, 20099, 20315, 20533, 20751, 20972, 21193, 21416, 21640, 21865, 22091, 22319,
+    22548, 22778, 23010, 23243, 23477, 23712, 23949, 24187, 24426, 24667, 24908, 25152,
+    25396, 25642, 25889, 26137, 26387, 26637, 26890, 27143, 27398, 27654, 27911, 28170,
+    28430, 28691, 28954, 29217, 29483, 29749, 30017, 30286, 30556, 30828, 31101, 31376,
+    31651, 31928, 32206, 32486, 32767,
+};
+
+/**
+ * @brief Ordered dither offsets, in Q15 LSBs below the 8-bit output step (128)
+ */
+static const int16_t dsp_dither_pattern[4] = {0, 64, 32, 96};
+
+/*******************************************************************************************
+ *                               DSP Instruction Wrappers
+ *******************************************************************************************/
+#if defined(__ARM_FEATURE_DSP) && !defined(HOST_BUILD)
+
+static inline uint32_t dsp_qadd16(uint32_t a, uint32_t b)
+{
+    uint32_t r;
+    __asm("qadd16 %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+static inline uint32_t dsp_usat16_15(uint32_t a)
+{
+    uint32_t r;
+    __asm("usat16 %0, #15, %1" : "=r"(r) : "r"(a));
+    return r;
+}
+
+static inline int32_t dsp_smuad(uint32_t a, uint32_t b)
+{
+    int32_t r;
+    __asm("smuad %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+static inline int32_t dsp_smlad(uint32_t a, uint32_t b, int32_t acc)
+{
+    int32_t r;
+    __asm("smlad %0, %1, %2, %3" : "=r"(r) : "r"(a), "r"(b), "r"(acc));
+    return r;
+}
+
+static inline int32_t dsp_smulbb(uint32_t a, uint32_t b)
+{
+    int32_t r;
+    __asm("smulbb %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+static inline int32_t dsp_smultb(uint32_t a, uint32_t b)
+{
+    int32_t r;
+    __asm("smultb %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+}
+
+static inline int32_t dsp_ssat16_asr12(int32_t a)
+{
+    int32_t r;
+    __asm("ssat %0, #16, %1, asr #12" : "=r"(r) : "r"(a));
+    return r;
+}
+
+static inline uint32_t dsp_pkhbt(uint32_t lo, uint32_t hi)
+{
+    uint32_t r;
+    __asm("pkhbt %0, %1, %2, lsl #16" : "=r"(r) : "r"(lo), "r"(hi));
+    return r;
+}
+
+static inline uint32_t dsp_pkhtb(uint32_t hi, uint32_t lo)
+{
+    uint32_t r;
+    __asm("pkhtb %0, %1, %2, asr #16" : "=r"(r) : "r"(hi), "r"(lo));
+    return r;
+}
+
+#else /* Portable emulation (host builds, cores without the DSP extension) */
+
+static inline int32_t dsp_lo(uint32_t a)
+{
+    return (int16_t)(a & 0xFFFFU);
+}
+
+static inline int32_t dsp_hi(uint32_t a)
+{
+    return (int16_t)(a >> 16);
+}
+
+static inline int32_t dsp_sat(int32_t v, int32_t min, int32_t max)
+{
+    return (v < min) ? min : ((v > max) ? max : v);
+}
+
+static inline uint32_t dsp_qadd16(uint32_t a, uint32_t b)
+{
+    uint32_t lo = (uint16_t)dsp_sat(dsp_lo(a) + dsp_lo(b), -32768, 32767);
+    uint32_t hi = (uint16_t)dsp_sat(dsp_hi(a) + dsp_hi(b), -32768, 32767);
+    return lo | (hi << 16);
+}
+
+static inline uint32_t dsp_usat16_15(uint32_t a)
+{
+    uint32_t lo = (uint32_t)dsp_sat(dsp_lo(a), 0, 32767);
+    uint32_t hi = (uint32_t)dsp_sat(dsp_hi(a), 0, 32767);
+    return lo | (hi << 16);
+}
+
+static inline int32_t dsp_smuad(uint32_t a, uint32_t b)
+{
+    // The hardware sum wraps modulo 2^32 (it only sets the Q flag)
+    return (int32_t)((uint32_t)(dsp_lo(a) * dsp_lo(b)) + (uint32_t)(dsp_hi(a) * dsp_hi(b)));
+}
+
+static inline int32_t dsp_smlad(uint32_t a, uint32_t b, int32_t acc)
+{
+    return (int32_t)((uint32_t)dsp_smuad(a, b) + (uint32_t)acc);
+}
+
+static inline int32_t dsp_smulbb(uint32_t a, uint32_t b)
+{
+    return dsp_lo(a) * dsp_lo(b);
+}
+
+static inline int32_t dsp_smultb(uint32_t a, uint32_t b)
+{
+    return dsp_hi(a) * dsp_lo(b);
+}
+
+static inline int32_t dsp_ssat16_asr12(int32_t a)
+{
+    return dsp_sat(a >> 12, -32768, 32767);
+}
+
+static inline uint32_t dsp_pkhbt(uint32_t lo, uint32_t hi)
+{
+    return (lo & 0xFFFFU) | (hi << 16);
+}
+
+static inline uint32_t dsp_pkhtb(uint32_t hi, uint32_t lo)
+{
+    return (hi & 0xFFFF0000U) | (((uint32_t)((int32_t)lo >> 16)) & 0xFFFFU);
+}
+
+#endif /* __ARM_FEATURE_DSP */
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Interpolate the gamma table for one clamped level (0 - DSP_Q15_MAX).
+ * @param  x: linear level
+ * @retval Corrected level
+ */
+static inline int32_t dsp_gamma_one(uint32_t x)
+{
+    uint32_t idx = x >> 7;
+    uint32_t f = x & 0x7FU;
+
+    // lut[idx] * (128 - f) + lut[idx + 1] * f in one dual multiply-accumulate
+    uint32_t points = dsp_pkhbt((uint16_t)dsp_gamma_lut[idx], (uint16_t)dsp_gamma_lut[idx + 1U]);
+    return dsp_smuad(points, dsp_pkhbt(128U - f, f)) >> 7;
+}
+
+/*******************************************************************************************
+ *                                  Packed Kernels
+ *******************************************************************************************/
+
+/**
+ * @brief  Scale levels by a Q4.12 gain with saturation (two channels per word).
+ */
+void dsp_q15_scale(int16_t *dst, const int16_t *src, int16_t gain, uint32_t n)
+{
+    const Dsp_Pair_t *s = (const Dsp_Pair_t *)src;
+    Dsp_Pair_t *d = (Dsp_Pair_t *)dst;
+    uint32_t g = (uint16_t)gain;
+
+    for (uint32_t i = 0; i < n / 2U; i++)
+    {
+        uint32_t w = s[i];
+        uint32_t lo = (uint32_t)dsp_ssat16_asr12(dsp_smulbb(w, g));
+        uint32_t hi = (uint32_t)dsp_ssat16_asr12(dsp_smultb(w, g));
+        d[i] = dsp_pkhbt(lo, hi);
+    }
+
+    if (n & 1U)
+    {
+        dsp_q15_scale_scalar(&dst[n - 1U], &src[n - 1U], gain, 1U);
+    }
+}
+
+/**
+ * @brief  Cross-fade two layers, one SMLAD per channel.
+ */
+void dsp_q15_blend(int16_t *dst, const int16_t *a, const int16_t *b, uint16_t alpha, uint32_t n)
+{
+    const Dsp_Pair_t *pa = (const Dsp_Pair_t *)a;
+    const Dsp_Pair_t *pb = (const Dsp_Pair_t *)b;
+    Dsp_Pair_t *d = (Dsp_Pair_t *)dst;
+
+    if (alpha > DSP_ALPHA_Q14_ONE)
+    {
+        alpha = DSP_ALPHA_Q14_ONE;
+    }
+    uint32_t weights = dsp_pkhbt(DSP_ALPHA_Q14_ONE - alpha, alpha);
+
+    for (uint32_t i = 0; i < n / 2U; i++)
+    {
+        uint32_t wa = pa[i];
+        uint32_t wb = pb[i];
+        uint32_t lo = (uint32_t)(dsp_smlad(dsp_pkhbt(wa, wb), weights, 1 << 13) >> 14);
+        uint32_t hi = (uint32_t)(dsp_smlad(dsp_pkhtb(wb, wa), weights, 1 << 13) >> 14);
+        d[i] = dsp_pkhbt(lo, hi);
+    }
+
+    if (n & 1U)
+    {
+        dsp_q15_blend_scalar(&dst[n - 1U], &a[n - 1U], &b[n - 1U], alpha, 1U);
+    }
+}
+
+/**
+ * @brief  Saturating add of two layers, one QADD16 per two channels.
+ */
+void dsp_q15_add_sat(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t n)
+{
+    const Dsp_Pair_t *pa = (const Dsp_Pair_t *)a;
+    const Dsp_Pair_t *pb = (const Dsp_Pair_t *)b;
+    Dsp_Pair_t *d = (Dsp_Pair_t *)dst;
+
+    for (uint32_t i = 0; i < n / 2U; i++)
+    {
+        d[i] = dsp_qadd16(pa[i], pb[i]);
+    }
+
+    if (n & 1U)
+    {
+        dsp_q15_add_sat_scalar(&dst[n - 1U], &a[n - 1U], &b[n - 1U], 1U);
+    }
+}
+
+/**
+ * @brief  Gamma correction, both channels of a word clamped by one USAT16.
+ */
+void dsp_q15_gamma(int16_t *dst, const int16_t *src, uint32_t n)
+{
+    const Dsp_Pair_t *s = (const Dsp_Pair_t *)src;
+    Dsp_Pair_t *d = (Dsp_Pair_t *)dst;
+
+    for (uint32_t i = 0; i < n / 2U; i++)
+    {
+        uint32_t w = dsp_usat16_15(s[i]);
+        uint32_t lo = (uint32_t)dsp_gamma_one(w & 0xFFFFU);
+        uint32_t hi = (uint32_t)dsp_gamma_one(w >> 16);
+        d[i] = dsp_pkhbt(lo, hi);
+    }
+
+    if (n & 1U)
+    {
+        dsp_q15_gamma_scalar(&dst[n - 1U], &src[n - 1U], 1U);
+    }
+}
+
+/**
+ * @brief  Ordered dither to 8 bits: QADD16 + USAT16 + one shift/mask per two channels.
+ */
+void dsp_q15_dither_u8(uint8_t *dst, const int16_t *src, uint32_t n, uint32_t frame)
+{
+    const Dsp_Pair_t *s = (const Dsp_Pair_t *)src;
+    uint32_t pattern[2];
+
+    // Channel i uses dsp_dither_pattern[(i + frame) & 3]: even pairs, then odd pairs
+    for (uint32_t k = 0; k < 2U; k++)
+    {
+        pattern[k] = dsp_pkhbt((uint16_t)dsp_dither_pattern[(frame + 2U * k) & 3U],
+                               (uint16_t)dsp_dither_pattern[(frame + 2U * k + 1U) & 3U]);
+    }
+
+    for (uint32_t i = 0; i < n / 2U; i++)
+    {
+        uint32_t w = dsp_usat16_15(dsp_qadd16(s[i], pattern[i & 1U]));
+        w = (w >> 7) & 0x00FF00FFU; // Both 15-bit halves down to 8 bits at once
+        dst[2U * i] = (uint8_t)w;
+        dst[2U * i + 1U] = (uint8_t)(w >> 16);
+    }
+
+    if (n & 1U)
+    {
+        // Pattern phase follows the absolute channel index
+        dsp_q15_dither_u8_scalar(&dst[n - 1U], &src[n - 1U], 1U, frame + n - 1U);
+    }
+}
+
+/*******************************************************************************************
+ *                              Scalar Reference Kernels
+ *******************************************************************************************/
+
+/**
+ * @brief  Scale levels by a Q4.12 gain with saturation, one channel at a time.
+ */
+void dsp_q15_scale_scalar(int16_t *dst, const int16_t *src, int16_t gain, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t y = ((int32_t)src[i] * gain) >> 12;
+        dst[i] = (int16_t)((y > 32767) ? 32767 : ((y < -32768) ? -32768 : y));
+    }
+}
+
+/**
+ * @brief  Cross-fade two layers, one channel at a time.
+ */
+void dsp_q15_blend_scalar(int16_t *dst, const int16_t *a, const int16_t *b, uint16_t alpha,
+                          uint32_t n)
+{
+    if (alpha > DSP_ALPHA_Q14_ONE)
+    {
+        alpha = DSP_ALPHA_Q14_ONE;
+    }
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t y = (int32_t)a[i] * (int32_t)(DSP_ALPHA_Q14_ONE - alpha) +
+                    (int32_t)b[i] * (int32_t)alpha + (1 << 13);
+        dst[i] = (int16_t)(y >> 14);
+    }
+}
+
+/**
+ * @brief  Saturating add of two layers, one channel at a time.
+ */
+void dsp_q15_add_sat_scalar(int16_t *dst, const int16_t *a, const int16_t *b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t y = (int32_t)a[i] + b[i];
+        dst[i] = (int16_t)((y > 32767) ? 32767 : ((y < -32768) ? -32768 : y));
+    }
+}
+
+/**
+ * @brief  Gamma correction, one channel at a time.
+ */
+void dsp_q15_gamma_scalar(int16_t *dst, const int16_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t x = (src[i] < 0) ? 0 : src[i];
+        int32_t idx = x >> 7;
+        int32_t f = x & 0x7F;
+        dst[i] = (int16_t)((dsp_gamma_lut[idx] * (128 - f) + dsp_gamma_lut[idx + 1] * f) >> 7);
+    }
+}
+
+/**
+ * @brief  Ordered dither to 8 bits, one channel at a time.
+ */
+void dsp_q15_dither_u8_scalar(uint8_t *dst, const int16_t *src, uint32_t n, uint32_t frame)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t x = src[i] + dsp_dither_pattern[(i + frame) & 3U];
+        dst[i] = (uint8_t)(((x < 0) ? 0 : ((x > DSP_Q15_MAX) ? DSP_Q15_MAX : x)) >> 7);
+    }
+}
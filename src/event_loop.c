@@ -0,0 +1,297 @@
+/*******************************************************************************************
+ * @file    event_loop.c
+ * @author  ka5j
+ * @brief   Cooperative event loop with prioritized run-to-completion handlers
+ * @version 1.0
+ * @date    2025-06-02
+ *
+ * @details
+ * Each priority level owns a bounded multi-producer / single-consumer queue. Producers
+ * (ISRs of any priority, or thread code) claim a slot with a compare-and-swap on the head
+ * index (LDREX/STREX on the Cortex-M4) and publish it by writing the slot sequence number,
+ * so no interrupt masking is needed to post. Only the main loop consumes.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "event_loop.h"
+#include "bare_core.h" // WFI / PRIMASK helpers
+#include "bare_dwt.h"  // Cycle counter for handler timing
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Queue slot, the sequence number tells producers and consumer who owns it
+ */
+typedef struct
+{
+    volatile uint32_t seq;
+    Event_t evt;
+} Event_Slot_t;
+
+/**
+ * @brief Bounded MPSC queue (one per priority)
+ */
+typedef struct
+{
+    Event_Slot_t slots[EVENT_QUEUE_SIZE];
+    volatile uint32_t head; /*!< Next slot to claim (producers) */
+    volatile uint32_t tail; /*!< Next slot to read (consumer)   */
+    volatile uint32_t max_depth;
+} Event_Queue_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Event_Queue_t queues[EVT_PRIO_COUNT];
+static Event_Handler_t handlers[EVT_TYPE_COUNT];
+static uint8_t priorities[EVT_TYPE_COUNT];
+static Event_Stats_t stats[EVT_TYPE_COUNT];
+static Event_Hook_t wait_hook; // Blocks the consumer, NULL: WFI
+static Event_Hook_t wake_hook; // Unblocks it after a post
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Try to pop the oldest published event of a queue (consumer side only).
+ * @retval 1 if an event was copied into *evt, 0 if the queue is empty
+ */
+static int event_queue_pop(Event_Queue_t *q, Event_t *evt)
+{
+    uint32_t pos = q->tail;
+    Event_Slot_t *slot = &q->slots[pos & (EVENT_QUEUE_SIZE - 1U)];
+    uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(seq - (pos + 1U)) < 0)
+    {
+        return 0; // Empty, or the producer of this slot has not published yet
+    }
+
+    *evt = slot->evt;
+    __atomic_store_n(&slot->seq, pos + EVENT_QUEUE_SIZE, __ATOMIC_RELEASE); // Hand slot back
+    q->tail = pos + 1U;
+    return 1;
+}
+
+/**
+ * @brief  Check whether every priority queue is empty.
+ * @retval 1 if nothing is queued, 0 otherwise
+ */
+static int event_loop_is_idle(void)
+{
+    for (uint32_t p = 0; p < EVT_PRIO_COUNT; p++)
+    {
+        if (queues[p].head != queues[p].tail)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Reset all queues, handlers and statistics.
+ */
+void event_loop_init(void)
+{
+    for (uint32_t p = 0; p < EVT_PRIO_COUNT; p++)
+    {
+        for (uint32_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+        {
+            queues[p].slots[i].seq = i;
+        }
+        queues[p].head = 0;
+        queues[p].tail = 0;
+        queues[p].max_depth = 0;
+    }
+
+    for (uint32_t t = 0; t < EVT_TYPE_COUNT; t++)
+    {
+        handlers[t] = NULL;
+        priorities[t] = EVT_PRIO_LOW;
+        stats[t].posted = 0;
+        stats[t].dropped = 0;
+        stats[t].dispatched = 0;
+        stats[t].last_cycles = 0;
+        stats[t].max_cycles = 0;
+        stats[t].total_cycles = 0;
+    }
+    wait_hook = NULL;
+    wake_hook = NULL;
+}
+
+/**
+ * @brief  Register the handler and queue priority used for an event type.
+ */
+void event_loop_register(Event_Type_t type, Event_Priority_t prio, Event_Handler_t handler)
+{
+    if (type >= EVT_TYPE_COUNT || prio >= EVT_PRIO_COUNT)
+    {
+        return;
+    }
+    priorities[type] = (uint8_t)prio;
+    handlers[type] = handler;
+}
+
+/**
+ * @brief  Post an event from any context without masking interrupts.
+ */
+int event_post(Event_Type_t type, uint16_t arg)
+{
+    if (type >= EVT_TYPE_COUNT || handlers[type] == NULL)
+    {
+        return -1;
+    }
+
+    Event_Queue_t *q = &queues[priorities[type]];
+    uint32_t pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    Event_Slot_t *slot;
+
+    for (;;)
+    {
+        slot = &q->slots[pos & (EVENT_QUEUE_SIZE - 1U)];
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0)
+        {
+            // Slot is free: claim it (a nested ISR may win the race, then retry)
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1U, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            stats[type].dropped++; // Queue full
+            return -1;
+        }
+        else
+        {
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->evt.type = (uint8_t)type;
+    slot->evt.reserved = 0;
+    slot->evt.arg = arg;
+    __atomic_store_n(&slot->seq, pos + 1U, __ATOMIC_RELEASE); // Publish
+
+    uint32_t depth = pos + 1U - q->tail;
+    if (depth > q->max_depth)
+    {
+        q->max_depth = depth; // Best effort high-water mark
+    }
+    stats[type].posted++;
+    if (wake_hook != NULL)
+    {
+        wake_hook();
+    }
+    return 0;
+}
+
+/**
+ * @brief  Dispatch at most one event, highest priority first.
+ */
+int event_loop_dispatch_one(void)
+{
+    Event_t evt;
+
+    for (uint32_t p = 0; p < EVT_PRIO_COUNT; p++)
+    {
+        if (!event_queue_pop(&queues[p], &evt))
+        {
+            continue;
+        }
+
+        Event_Stats_t *s = &stats[evt.type];
+        uint32_t start = bare_dwt_get_cycles();
+
+        handlers[evt.type](&evt); // Run to completion
+
+        uint32_t cycles = bare_dwt_get_cycles() - start;
+        s->dispatched++;
+        s->last_cycles = cycles;
+        s->total_cycles += cycles;
+        if (cycles > s->max_cycles)
+        {
+            s->max_cycles = cycles;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief  Dispatch events forever, sleeping whenever all queues are empty.
+ *
+ * @note   With a wait hook the consumer blocks and the kernel idle task sleeps (and counts
+ *         the idle time). The hook keeps a wake-up that arrives after the emptiness check,
+ *         so nothing is lost. Without one, interrupts are masked around the final check so
+ *         an event posted right before WFI still wakes the core (WFI exits on a pending
+ *         interrupt even with PRIMASK set; the ISR then runs once they are re-enabled).
+ */
+void event_loop_run(void)
+{
+    while (1)
+    {
+        if (event_loop_dispatch_one())
+        {
+            continue;
+        }
+        if (wait_hook != NULL)
+        {
+            wait_hook();
+            continue;
+        }
+
+        bare_core_disable_irq();
+        if (event_loop_is_idle())
+        {
+            bare_core_wfi();
+        }
+        bare_core_enable_irq();
+    }
+}
+
+/**
+ * @brief  Block the consumer through hooks instead of WFI.
+ */
+void event_loop_set_blocking(Event_Hook_t wait, Event_Hook_t wake)
+{
+    wake_hook = wake;
+    wait_hook = wait;
+}
+
+/**
+ * @brief  Get the statistics recorded for an event type.
+ */
+const Event_Stats_t *event_loop_get_stats(Event_Type_t type)
+{
+    return &stats[type];
+}
+
+/**
+ * @brief  Get the current and maximum depth of a priority queue.
+ */
+uint32_t event_loop_get_depth(Event_Priority_t prio, uint32_t *max_depth)
+{
+    Event_Queue_t *q = &queues[prio];
+
+    if (max_depth != NULL)
+    {
+        *max_depth = q->max_depth;
+    }
+    return q->head - q->tail;
+}
@@ -0,0 +1,396 @@
+/*******************************************************************************************
+ * @file    fmt.c
+ * @author  ka5j
+ * @brief   Small printf-style formatter writing straight into a byte ring (no libc)
+ * @version 1.0
+ * @date    2025-07-02
+ *
+ * @details
+ * Numbers are converted least significant digit first into the end of a 12-byte stack
+ * buffer (ten decimal digits, the decimal point and a leading zero at most). Literal text,
+ * strings and digits are then copied to the cursor in runs, one room check per run.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#include "fmt.h"
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define FMT_DIGITS_MAX 12U /*!< Digits, point and leading zero of a 32-bit value */
+#define FMT_PREC_MAX 10U   /*!< Largest precision of a number                    */
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief One parsed conversion
+ */
+typedef struct
+{
+    uint8_t left;   /*!< '-' flag                          */
+    uint8_t zero;   /*!< '0' flag                          */
+    uint8_t plus;   /*!< '+' flag                          */
+    uint32_t width; /*!< Minimum field width               */
+    int32_t prec;   /*!< Precision, -1 if not given        */
+} Fmt_Spec_t;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Write one character, asking for room when it runs out.
+ */
+static void fmt_put(Fmt_Out_t *out, char c)
+{
+    out->count++;
+    if (out->room == 0U && (out->more == NULL || (out->room = out->more(out)) == 0U))
+    {
+        return; // No room: discarded, still counted
+    }
+    out->buf[out->pos & out->mask] = (uint8_t)c;
+    out->pos++;
+    out->room--;
+}
+
+/**
+ * @brief  Write n characters: whole runs while there is room, fmt_put() at the edges.
+ */
+static void fmt_write(Fmt_Out_t *out, const char *s, uint32_t n)
+{
+    while (n > 0U)
+    {
+        uint32_t run = (out->room < n) ? out->room : n;
+        if (run == 0U)
+        {
+            fmt_put(out, *s++); // Asks for room or discards
+            n--;
+            continue;
+        }
+        uint8_t *buf = out->buf;
+        uint32_t mask = out->mask;
+        uint32_t pos = out->pos;
+        for (uint32_t i = 0; i < run; i++)
+        {
+            buf[(pos + i) & mask] = (uint8_t)s[i];
+        }
+        out->pos = pos + run;
+        out->room -= run;
+        out->count += run;
+        s += run;
+        n -= run;
+    }
+}
+
+/**
+ * @brief  Write a character n times.
+ */
+static void fmt_fill(Fmt_Out_t *out, char c, uint32_t n)
+{
+    while (n-- > 0U)
+    {
+        fmt_put(out, c);
+    }
+}
+
+/**
+ * @brief  Read a width or precision: digits or '*'.
+ */
+static uint32_t fmt_parse_uint(const char **fmt, va_list *ap, int32_t *star)
+{
+    uint32_t value = 0;
+
+    *star = 0;
+    if (**fmt == '*')
+    {
+        (*fmt)++;
+        *star = 1;
+        return (uint32_t)va_arg(*ap, int);
+    }
+    while (**fmt >= '0' && **fmt <= '9')
+    {
+        value = value * 10U + (uint32_t)(*(*fmt)++ - '0');
+    }
+    return value;
+}
+
+/**
+ * @brief  Write a number field.
+ * @param  value: magnitude
+ * @param  negative: 1 to print a minus sign
+ * @param  base: 10 or 16
+ * @param  conv: conversion character ('q' adds the decimal point)
+ * @param  spec: flags, width and precision
+ */
+static void fmt_number(Fmt_Out_t *out, uint32_t value, uint8_t negative, uint32_t base,
+                       char conv, const Fmt_Spec_t *spec)
+{
+    const char *digit = (conv == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+    char text[FMT_DIGITS_MAX];
+    char *end = &text[FMT_DIGITS_MAX];
+    char *p = end;
+    uint32_t prec = (spec->prec < 0) ? 0U : (uint32_t)spec->prec;
+    uint32_t frac = 0;
+    uint32_t min = 1;
+
+    if (prec > FMT_PREC_MAX)
+    {
+        prec = FMT_PREC_MAX;
+    }
+    if (conv == 'q')
+    {
+        frac = prec;
+        min = (frac != 0U) ? frac + 2U : 1U; // "0." before the fraction
+    }
+    else if (prec > min)
+    {
+        min = prec;
+    }
+
+    // Least significant digit first, from the end of text; constant divisors for speed
+    do
+    {
+        if (base == 16U)
+        {
+            *--p = digit[value & 0xFU];
+            value >>= 4;
+        }
+        else
+        {
+            *--p = digit[value % 10U];
+            value /= 10U;
+        }
+        if ((uint32_t)(end - p) == frac)
+        {
+            *--p = '.';
+        }
+    } while (value != 0U || (uint32_t)(end - p) < min);
+    uint32_t n = (uint32_t)(end - p);
+
+    char sign = negative ? '-' : (spec->plus ? '+' : '\0');
+    uint32_t len = n + ((sign != '\0') ? 1U : 0U);
+    uint32_t pad = (spec->width > len) ? spec->width - len : 0U;
+    uint8_t zero = spec->zero && !spec->left && (conv == 'q' || spec->prec < 0);
+
+    if (!spec->left && !zero)
+    {
+        fmt_fill(out, ' ', pad);
+    }
+    if (sign != '\0')
+    {
+        fmt_put(out, sign);
+    }
+    if (zero)
+    {
+        fmt_fill(out, '0', pad);
+    }
+    fmt_write(out, p, n);
+    if (spec->left)
+    {
+        fmt_fill(out, ' ', pad);
+    }
+}
+
+/**
+ * @brief  Write a string field (precision limits the length).
+ */
+static void fmt_string(Fmt_Out_t *out, const char *s, const Fmt_Spec_t *spec)
+{
+    uint32_t len = 0;
+
+    if (s == NULL)
+    {
+        s = "(null)";
+    }
+    while (s[len] != '\0' && (spec->prec < 0 || len < (uint32_t)spec->prec))
+    {
+        len++;
+    }
+
+    uint32_t pad = (spec->width > len) ? spec->width - len : 0U;
+    if (!spec->left)
+    {
+        fmt_fill(out, ' ', pad);
+    }
+    fmt_write(out, s, len);
+    if (spec->left)
+    {
+        fmt_fill(out, ' ', pad);
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Format into a cursor.
+ * @param  out: cursor
+ * @param  fmt: format string
+ * @param  ap: arguments
+ * @retval Characters produced, including discarded ones
+ */
+uint32_t fmt_vprint(Fmt_Out_t *out, const char *fmt, va_list ap)
+{
+    uint32_t start = out->count;
+    va_list args;
+
+    va_copy(args, ap);
+    while (*fmt != '\0')
+    {
+        if (*fmt != '%')
+        {
+            const char *run = fmt;
+            while (*fmt != '\0' && *fmt != '%')
+            {
+                fmt++;
+            }
+            fmt_write(out, run, (uint32_t)(fmt - run));
+            continue;
+        }
+        const char *conv_start = fmt++;
+
+        Fmt_Spec_t spec = {0, 0, 0, 0, -1};
+        for (;; fmt++)
+        {
+            if (*fmt == '-')
+            {
+                spec.left = 1;
+            }
+            else if (*fmt == '0')
+            {
+                spec.zero = 1;
+            }
+            else if (*fmt == '+')
+            {
+                spec.plus = 1;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        int32_t star;
+        int32_t width = (int32_t)fmt_parse_uint(&fmt, &args, &star);
+        if (star && width < 0)
+        {
+            spec.left = 1; // A negative '*' width left-justifies
+            width = -width;
+        }
+        spec.width = (uint32_t)width;
+        if (*fmt == '.')
+        {
+            fmt++;
+            int32_t prec = (int32_t)fmt_parse_uint(&fmt, &args, &star);
+            spec.prec = (prec < 0) ? -1 : prec; // A negative '*' precision is "none"
+        }
+
+        uint8_t is_long = 0;
+        while (*fmt == 'l')
+        {
+            is_long = 1;
+            fmt++;
+        }
+
+        char conv = *fmt;
+        if (conv != '\0')
+        {
+            fmt++;
+        }
+        switch (conv)
+        {
+        case 'd':
+        case 'i':
+        case 'q':
+        {
+            int32_t v = is_long ? (int32_t)va_arg(args, long) : (int32_t)va_arg(args, int);
+            uint32_t mag = (v < 0) ? 0U - (uint32_t)v : (uint32_t)v;
+            fmt_number(out, mag, (v < 0) ? 1U : 0U, 10U, conv, &spec);
+            break;
+        }
+
+        case 'u':
+        case 'x':
+        case 'X':
+        {
+            uint32_t v = is_long ? (uint32_t)va_arg(args, unsigned long)
+                                 : (uint32_t)va_arg(args, unsigned int);
+            spec.plus = 0;
+            fmt_number(out, v, 0U, (conv == 'u') ? 10U : 16U, conv, &spec);
+            break;
+        }
+
+        case 'c':
+        {
+            uint32_t pad = (spec.width > 1U) ? spec.width - 1U : 0U;
+            fmt_fill(out, ' ', spec.left ? 0U : pad);
+            fmt_put(out, (char)va_arg(args, int));
+            fmt_fill(out, ' ', spec.left ? pad : 0U);
+            break;
+        }
+
+        case 's':
+            fmt_string(out, va_arg(args, const char *), &spec);
+            break;
+
+        case '%':
+            fmt_put(out, '%');
+            break;
+
+        default:
+            while (conv_start < fmt)
+            {
+                fmt_put(out, *conv_start++); // Not a conversion: print it as it is
+            }
+            break;
+        }
+    }
+    va_end(args);
+
+    return out->count - start;
+}
+
+/**
+ * @brief  Format into a cursor.
+ * @param  out: cursor
+ * @param  fmt: format string
+ * @retval Characters produced, including discarded ones
+ */
+uint32_t fmt_print(Fmt_Out_t *out, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    uint32_t n = fmt_vprint(out, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/**
+ * @brief  Format into a plain buffer.
+ * @param  buf: output
+ * @param  size: bytes of buf
+ * @param  fmt: format string
+ * @retval Length of the full output
+ */
+uint32_t fmt_snprint(char *buf, uint32_t size, const char *fmt, ...)
+{
+    Fmt_Out_t out = {(uint8_t *)buf, FMT_LINEAR, 0, (size > 0U) ? size - 1U : 0U,
+                     NULL, NULL, 0};
+    va_list ap;
+
+    va_start(ap, fmt);
+    (void)fmt_vprint(&out, fmt, ap);
+    va_end(ap);
+
+    if (size > 0U)
+    {
+        buf[out.pos] = '\0';
+    }
+    return out.count;
+}
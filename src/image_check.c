@@ -0,0 +1,87 @@
+/*******************************************************************************************
+ * @file    image_check.c
+ * @author  ka5j
+ * @brief   Flash image integrity check at boot (hardware CRC, DMA fed)
+ * @version 1.0
+ * @date    2025-07-01
+ *
+ * @details
+ * HOST_BUILD has no flash image: the check reports IMAGE_CHECK_UNPATCHED.
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "image_check.h"
+#include "stm32f446re_addresses.h" // FLASH_BASE
+#include "bare_crc.h"               // DMA-fed CRC unit
+#include "bare_dwt.h"               // Check duration
+
+#ifndef HOST_BUILD
+extern const uint32_t _image_crc; // Linker script: CRC word after the image
+#endif
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Image_Check_t image;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+#ifndef HOST_BUILD
+/**
+ * @brief  CRC result (DMA ISR context): compare with the stored word.
+ */
+static void image_check_done(uint32_t crc, uint8_t ok)
+{
+    image.computed = crc;
+    image.cycles = bare_dwt_get_cycles() - image.cycles;
+    if (!ok)
+    {
+        image.status = IMAGE_CHECK_ERROR;
+    }
+    else if (image.stored == 0xFFFFFFFFUL)
+    {
+        image.status = IMAGE_CHECK_UNPATCHED;
+    }
+    else
+    {
+        image.status = (crc == image.stored) ? IMAGE_CHECK_OK : IMAGE_CHECK_MISMATCH;
+    }
+}
+#endif
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Start the background image check.
+ */
+void image_check_start(void)
+{
+    image.start = FLASH_BASE;
+#ifdef HOST_BUILD
+    image.stored = 0xFFFFFFFFUL;
+    image.status = IMAGE_CHECK_UNPATCHED;
+#else
+    image.bytes = (uint32_t)((uintptr_t)&_image_crc - FLASH_BASE);
+    image.stored = _image_crc;
+    image.cycles = bare_dwt_get_cycles();
+    image.status = IMAGE_CHECK_RUNNING;
+    if (bare_crc_words_dma((const uint32_t *)FLASH_BASE, image.bytes / 4U, image_check_done) != 0)
+    {
+        image.status = IMAGE_CHECK_ERROR;
+    }
+#endif
+}
+
+/**
+ * @brief  Get the check result.
+ * @retval Pointer to the result
+ */
+const Image_Check_t *image_check_get(void)
+{
+    return &image;
+}
@@ -0,0 +1,438 @@
+/*******************************************************************************************
+ * @file    kernel.c
+ * @author  ka5j
+ * @brief   Minimal fixed-priority preemptive kernel for STM32F446RE (bare metal)
+ * @version 1.0
+ * @date    2025-06-04
+ *
+ * @details
+ * Task stacks run on the PSP, handlers keep using the MSP. A task's context is saved on
+ * its own stack in the following order (high to low addresses):
+ * - Hardware frame pushed on exception entry (xPSR, PC, LR, R12, R3-R0, plus S0-S15 and
+ *   FPSCR if the task used the FPU)
+ * - S16-S31, only when EXC_RETURN bit 4 is clear (task used the FPU)
+ * - R4-R11 and the EXC_RETURN value itself (LR in PendSV)
+ * Storing EXC_RETURN per task is what makes the FPU save lazy and per task.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "kernel.h"
+#include "scb_registers.h" // ICSR (PendSV), SHPR (exception priorities)
+#include "bare_core.h"     // WFI helper
+#include "bare_nvic.h"     // Exception priorities, BASEPRI critical sections
+#include "irq_priorities.h" // CRIT_CEILING_KERNEL, IRQ_PRIO_PENDSV
+#include "stack_check.h"    // Task stack painting and guard
+#include "perf.h"           // Idle time accounting
+
+/*******************************************************************************************
+ *                                   Private Constants
+ *******************************************************************************************/
+#define KERNEL_INITIAL_XPSR 0x01000000UL  /*!< Thumb bit set                         */
+#define KERNEL_EXC_RETURN_PSP 0xFFFFFFFDUL /*!< Thread mode, PSP, basic (no FPU) frame */
+#define KERNEL_BASEPRI 0x40               /*!< CRIT_CEILING_KERNEL as a BASEPRI value */
+#define KERNEL_STR(x) #x
+#define KERNEL_XSTR(x) KERNEL_STR(x)
+
+// PendSV_Handler masks with a literal, keep it in sync with the priority plan
+_Static_assert(KERNEL_BASEPRI == (CRIT_CEILING_KERNEL << (8U - NVIC_PRIO_BITS)),
+               "KERNEL_BASEPRI must match CRIT_CEILING_KERNEL");
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Kernel_TCB_t *tasks[KERNEL_MAX_TASKS];
+static uint32_t task_count;
+static Kernel_TCB_t *current;
+static volatile uint32_t kernel_ticks;
+static volatile uint32_t slice_ticks;
+static volatile uint8_t rotate_request; // Pick the next equal-priority task
+static volatile uint8_t running;
+
+static Kernel_TCB_t idle_tcb;
+static uint32_t idle_stack[KERNEL_IDLE_STACK_WORDS] __attribute__((aligned(STACK_GUARD_BYTES)));
+
+// Referenced by name from PendSV_Handler
+__attribute__((used)) static Kernel_Stats_t kernel_stats;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Request a context switch; PendSV runs once no other handler is active.
+ */
+static void kernel_pend_switch(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET;
+}
+
+/**
+ * @brief  Landing pad for task functions that return.
+ */
+static void kernel_task_exit(void)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+    current->state = KERNEL_TASK_DORMANT;
+    kernel_pend_switch();
+    bare_nvic_crit_exit(crit);
+
+    while (1)
+        ; // Never scheduled again
+}
+
+/**
+ * @brief  Idle task, runs only when no other task is ready. Its time in WFI is the
+ *         CPU idle time reported by PERF.
+ */
+static void kernel_idle_task(void *arg)
+{
+    (void)arg;
+    while (1)
+    {
+        // WFI wakes with PRIMASK set: the ISR runs after the sleep has been measured
+        bare_core_disable_irq();
+        uint32_t start = bare_dwt_get_cycles();
+        bare_core_wfi();
+        perf_idle_add(bare_dwt_get_cycles() - start);
+        bare_core_enable_irq();
+    }
+}
+
+/**
+ * @brief  Pick the task to run next.
+ *
+ * @details
+ * The highest-priority ready task wins. The running task keeps the CPU against tasks of
+ * equal priority unless its time slice expired (rotate_request), in which case the
+ * search starts right after it so equal-priority tasks take turns.
+ */
+static Kernel_TCB_t *kernel_select(void)
+{
+    uint32_t index = 0;
+    Kernel_TCB_t *best = NULL;
+
+    for (uint32_t i = 0; i < task_count; i++)
+    {
+        if (tasks[i] == current)
+        {
+            index = i;
+        }
+    }
+
+    if (current != NULL && current->state == KERNEL_TASK_READY && !rotate_request)
+    {
+        best = current;
+    }
+
+    for (uint32_t i = 1; i <= task_count; i++)
+    {
+        Kernel_TCB_t *t = tasks[(index + i) % task_count];
+        if (t->state == KERNEL_TASK_READY && (best == NULL || t->priority < best->priority))
+        {
+            best = t;
+        }
+    }
+
+    rotate_request = 0;
+    return best; // Never NULL: the idle task is always ready
+}
+
+/**
+ * @brief  Called from PendSV_Handler with SysTick (CRIT_CEILING_KERNEL) masked.
+ *
+ * @param  sp  Process stack pointer of the outgoing task (context already saved)
+ * @return Process stack pointer of the incoming task
+ */
+__attribute__((used)) static uint32_t *kernel_switch_context(uint32_t *sp)
+{
+    Kernel_TCB_t *next;
+
+    current->sp = sp;
+    next = kernel_select();
+    if (next != current)
+    {
+        slice_ticks = 0;
+        current = next;
+        stack_check_guard_task(current->stack_base);
+    }
+    kernel_stats.switches++;
+    return current->sp;
+}
+
+/**
+ * @brief  Called from SVC_Handler to launch the first task.
+ *
+ * @return Process stack pointer of the first task
+ */
+__attribute__((used)) static uint32_t *kernel_launch_first(void)
+{
+    running = 1;
+    stack_check_guard_task(current->stack_base);
+    return current->sp;
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Create a task and build its initial stack frame.
+ */
+int kernel_task_create(Kernel_TCB_t *tcb, const char *name, Kernel_TaskFn_t fn, void *arg,
+                       uint32_t *stack, uint32_t stack_words, uint8_t priority)
+{
+    if (running || task_count >= KERNEL_MAX_TASKS || tcb == NULL || fn == NULL ||
+        stack == NULL || stack_words < 32U + STACK_GUARD_WORDS ||
+        ((uintptr_t)stack & (STACK_GUARD_BYTES - 1U)) != 0U)
+    {
+        return -1;
+    }
+
+    // The lowest words are the MPU guard, armed while the task runs
+    stack += STACK_GUARD_WORDS;
+    stack_words -= STACK_GUARD_WORDS;
+
+    // Painted for the MEM high-water report
+    stack_check_paint(stack, stack_words);
+
+    // Full descending stack, 8-byte aligned as required by AAPCS on exception return
+    uint32_t *sp = (uint32_t *)((uintptr_t)(stack + stack_words) & ~(uintptr_t)7U);
+
+    // Hardware frame, popped by the exception return
+    *--sp = KERNEL_INITIAL_XPSR;
+    *--sp = (uint32_t)(uintptr_t)fn & ~1UL; // PC (Thumb bit lives in xPSR)
+    *--sp = (uint32_t)(uintptr_t)kernel_task_exit; // LR
+    *--sp = 0;                                      // R12
+    *--sp = 0;                                      // R3
+    *--sp = 0;                                      // R2
+    *--sp = 0;                                      // R1
+    *--sp = (uint32_t)(uintptr_t)arg;               // R0
+
+    // Software frame, popped by PendSV/SVC: EXC_RETURN then R11..R4
+    *--sp = KERNEL_EXC_RETURN_PSP;
+    for (uint32_t i = 0; i < 8U; i++)
+    {
+        *--sp = 0;
+    }
+
+    tcb->sp = sp;
+    tcb->stack_base = stack;
+    tcb->stack_words = stack_words;
+    tcb->wake_tick = 0;
+    tcb->priority = priority;
+    tcb->state = KERNEL_TASK_READY;
+    tcb->notified = 0;
+    tcb->name = name;
+
+    tasks[task_count++] = tcb;
+    return 0;
+}
+
+/**
+ * @brief  Start scheduling with the highest-priority task. Never returns.
+ */
+void kernel_start(void)
+{
+    (void)kernel_task_create(&idle_tcb, "idle", kernel_idle_task, NULL,
+                             idle_stack, KERNEL_IDLE_STACK_WORDS, KERNEL_PRIO_IDLE);
+
+    // PendSV must never preempt another handler, it only switches thread contexts
+    bare_nvic_set_priority(PENDSV_IRQn, IRQ_PRIO_PENDSV);
+    bare_nvic_set_priority(SVCALL_IRQn, IRQ_PRIO_SVCALL);
+
+    current = NULL;
+    current = kernel_select();
+
+    __asm volatile("svc 0" ::: "memory");
+
+    while (1)
+        ; // Not reached
+}
+
+/**
+ * @brief  Advance kernel time by one tick (SysTick context).
+ */
+void kernel_tick(void)
+{
+    uint8_t reschedule = 0;
+
+    if (!running)
+    {
+        return;
+    }
+
+    kernel_ticks++;
+
+    for (uint32_t i = 0; i < task_count; i++)
+    {
+        Kernel_TCB_t *t = tasks[i];
+        if (t->state == KERNEL_TASK_DELAYED && (int32_t)(kernel_ticks - t->wake_tick) >= 0)
+        {
+            t->state = KERNEL_TASK_READY;
+            if (t->priority < current->priority)
+            {
+                reschedule = 1; // Preempt the running task
+            }
+        }
+    }
+
+    if (++slice_ticks >= KERNEL_TIME_SLICE_TICKS)
+    {
+        slice_ticks = 0;
+        rotate_request = 1;
+        reschedule = 1;
+    }
+
+    if (reschedule)
+    {
+        kernel_pend_switch();
+    }
+}
+
+/**
+ * @brief  Block the calling task for a number of ticks.
+ */
+void kernel_delay(uint32_t ticks)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+    if (ticks == 0)
+    {
+        rotate_request = 1;
+    }
+    else
+    {
+        current->wake_tick = kernel_ticks + ticks;
+        current->state = KERNEL_TASK_DELAYED;
+    }
+    kernel_pend_switch();
+    bare_nvic_crit_exit(crit); // PendSV is taken here
+}
+
+/**
+ * @brief  Give the CPU to another ready task of the same priority.
+ */
+void kernel_yield(void)
+{
+    kernel_delay(0);
+}
+
+/**
+ * @brief  Block the calling task until it is notified.
+ */
+void kernel_wait(void)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+    while (!current->notified)
+    {
+        current->state = KERNEL_TASK_WAITING;
+        kernel_pend_switch();
+        bare_nvic_crit_exit(crit); // PendSV is taken here, back once notified
+        crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+    }
+    current->notified = 0;
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Notify a task (ISR or thread context).
+ */
+void kernel_notify(Kernel_TCB_t *tcb)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+    tcb->notified = 1;
+    if (tcb->state == KERNEL_TASK_WAITING)
+    {
+        tcb->state = KERNEL_TASK_READY;
+        if (running && tcb->priority < current->priority)
+        {
+            kernel_pend_switch(); // Preempt the running task (taken after the ISR)
+        }
+    }
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Get the currently running task.
+ */
+const Kernel_TCB_t *kernel_current_task(void)
+{
+    return running ? current : NULL;
+}
+
+/**
+ * @brief  Get the context switch statistics.
+ */
+const Kernel_Stats_t *kernel_get_stats(void)
+{
+    return &kernel_stats;
+}
+
+/**
+ * @brief  Get a task by creation order.
+ */
+const Kernel_TCB_t *kernel_get_task(uint32_t index)
+{
+    return (index < task_count) ? tasks[index] : NULL;
+}
+
+/*******************************************************************************************
+ *                                  Exception Handlers
+ *******************************************************************************************/
+
+/**
+ * @brief  SVC handler: launch the first task (only used by kernel_start()).
+ */
+__attribute__((naked)) void SVC_Handler(void)
+{
+    __asm volatile(
+        "   bl      kernel_launch_first     \n" // r0 = first task's PSP
+        "   ldmia   r0!, {r4-r11, lr}       \n" // Software frame, lr = EXC_RETURN
+        "   msr     psp, r0                 \n"
+        "   bx      lr                      \n" // Hardware frame popped from PSP
+    );
+}
+
+/**
+ * @brief  PendSV handler: save the running task, switch to the selected one.
+ *
+ * @details
+ * The DWT cycle counter is sampled on entry and before the exception return; the
+ * difference is stored in kernel_stats.last_switch_cycles / max_switch_cycles.
+ */
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile(
+        "   .fpu    fpv4-sp-d16                      \n"
+        "   movw    r3, #:lower16:0xE0001004         \n" // &DWT->CYCCNT
+        "   movt    r3, #:upper16:0xE0001004         \n"
+        "   ldr     r12, [r3]                        \n" // Entry timestamp
+        "   mrs     r0, psp                          \n"
+        "   tst     lr, #0x10                        \n" // Task used the FPU?
+        "   it      eq                               \n"
+        "   vstmdbeq r0!, {s16-s31}                  \n"
+        "   stmdb   r0!, {r4-r11, lr}                \n"
+        "   push    {r3, r12}                        \n"
+        "   mov     r1, #" KERNEL_XSTR(KERNEL_BASEPRI) " \n" // Mask SysTick (kernel_tick)
+        "   msr     basepri, r1                      \n"
+        "   bl      kernel_switch_context            \n" // r0 = next task's PSP
+        "   mov     r1, #0                           \n"
+        "   msr     basepri, r1                      \n"
+        "   pop     {r3, r12}                        \n"
+        "   ldmia   r0!, {r4-r11, lr}                \n"
+        "   tst     lr, #0x10                        \n"
+        "   it      eq                               \n"
+        "   vldmiaeq r0!, {s16-s31}                  \n"
+        "   msr     psp, r0                          \n"
+        "   ldr     r1, [r3]                         \n" // Exit timestamp
+        "   sub     r1, r1, r12                      \n"
+        "   movw    r2, #:lower16:kernel_stats       \n"
+        "   movt    r2, #:upper16:kernel_stats       \n"
+        "   str     r1, [r2]                         \n" // last_switch_cycles
+        "   ldr     r3, [r2, #4]                     \n"
+        "   cmp     r1, r3                           \n"
+        "   it      hi                               \n"
+        "   strhi   r1, [r2, #4]                     \n" // max_switch_cycles
+        "   bx      lr                               \n");
+}
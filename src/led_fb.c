@@ -0,0 +1,311 @@
+/*******************************************************************************************
+ * @file    led_fb.c
+ * @author  ka5j
+ * @brief   LED frame buffer with dirty tracking and incremental commit
+ * @version 1.0
+ * @date    2025-06-15
+ *
+ * @details
+ * Writers store the level first and then set the output's dirty bit with an atomic OR.
+ * A commit atomically takes the whole dirty mask, so a level written while a commit runs
+ * is either pushed by it or left dirty for the next one; it is never lost.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "led_fb.h"
+#include "led_output.h"
+#include "ws2812.h"         // WS2812 strip driver
+#include "apa102.h"         // APA102 strip driver
+#include "bare_tim2_5.h"    // PWM compare
+#include "bare_nvic.h"      // BASEPRI critical sections
+#include "irq_priorities.h" // CRIT_CEILING_FB
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define FB_SHADOW_UNKNOWN 0xFFFFFFFFUL /*!< Hardware state not known yet: always write */
+
+_Static_assert(LED_OUT_COUNT <= 32U, "Dirty mask holds one bit per output");
+
+/*******************************************************************************************
+ *                                    Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Pending BSRR write for one GPIO port
+ */
+typedef struct
+{
+    GPIO_TypeDef *port;
+    uint32_t bsrr;
+} Fb_PortBatch_t;
+
+/**
+ * @brief Dirty pixel range of one strip, [lo, hi)
+ */
+typedef struct
+{
+    uint32_t lo;
+    uint32_t hi;
+} Fb_Range_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static volatile uint32_t fb_levels[LED_OUT_COUNT];
+static volatile uint32_t fb_dirty;
+static uint32_t fb_shadow[LED_OUT_COUNT] = {
+    [0 ... LED_OUT_COUNT - 1] = FB_SHADOW_UNKNOWN,
+};
+static Fb_Range_t fb_strips[FB_STRIP_COUNT];
+static Fb_Stats_t fb_stats;
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Queue a pin change into the BSRR batch of its port.
+ * @param  batch: batches collected so far
+ * @param  count: number of batches in use (updated)
+ * @param  map: output hardware
+ * @param  on: new pin state
+ */
+static void fb_batch_pin(Fb_PortBatch_t *batch, uint32_t *count, const LED_OutputMap_t *map,
+                         uint32_t on)
+{
+    uint32_t i = 0;
+
+    while (i < *count && batch[i].port != map->port)
+    {
+        i++;
+    }
+    if (i == *count)
+    {
+        batch[i].port = map->port;
+        batch[i].bsrr = 0;
+        (*count)++;
+    }
+
+    batch[i].bsrr |= on ? (1UL << map->pin) : (1UL << (map->pin + 16U));
+}
+
+/**
+ * @brief  Account one commit; a commit with nothing written or skipped counts as clean.
+ */
+static void fb_account(uint32_t registers, uint32_t skipped, uint32_t bytes)
+{
+    if (registers == 0U && bytes == 0U && skipped == 0U)
+    {
+        fb_stats.clean_commits++;
+        return;
+    }
+
+    fb_stats.commits++;
+    fb_stats.registers += registers;
+    fb_stats.registers_skipped += skipped;
+    fb_stats.bytes += bytes;
+    fb_stats.last_registers = registers;
+    fb_stats.last_bytes = bytes;
+}
+
+/**
+ * @brief  Push changed discrete outputs to BSRR/CCR; the caller holds CRIT_CEILING_FB.
+ * @param  registers: incremented by the BSRR/CCR writes
+ * @param  skipped: incremented by the dirty outputs whose register value was equal
+ */
+static void fb_push_outputs(uint32_t *registers, uint32_t *skipped)
+{
+    Fb_PortBatch_t batch[LED_OUT_COUNT];
+    uint32_t ports = 0;
+    uint32_t dirty = __atomic_exchange_n(&fb_dirty, 0U, __ATOMIC_ACQUIRE);
+
+    for (uint32_t out = 0; dirty != 0U; out++, dirty >>= 1)
+    {
+        if (!(dirty & 1U))
+        {
+            continue;
+        }
+
+        const LED_OutputMap_t *map = led_output_map((LED_Output_t)out);
+        uint32_t level = fb_levels[out];
+        uint32_t value;
+
+        if (map->tim != NULL)
+        {
+            value = (level * (map->tim->ARR + 1U)) >> 16; // TIM ARR below 0xFFFF
+        }
+        else
+        {
+            value = (level >= (LED_OUTPUT_Q16_ONE / 2U)) ? 1U : 0U;
+        }
+
+        if (value == fb_shadow[out])
+        {
+            (*skipped)++;
+            continue;
+        }
+        fb_shadow[out] = value;
+
+        if (map->tim != NULL)
+        {
+            bare_pwm_set_compare(map->tim, value);
+            (*registers)++;
+        }
+        else
+        {
+            fb_batch_pin(batch, &ports, map, value);
+        }
+    }
+
+    for (uint32_t i = 0; i < ports; i++)
+    {
+        batch[i].port->BSRR = batch[i].bsrr; // Every changed pin of the port at once
+        (*registers)++;
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Set the level of a discrete output.
+ * @param  out: output id
+ * @param  level: brightness in Q16
+ */
+void fb_set_level(LED_Output_t out, uint32_t level)
+{
+    if (out >= LED_OUT_COUNT)
+    {
+        return;
+    }
+
+    if (level > LED_OUTPUT_Q16_ONE)
+    {
+        level = LED_OUTPUT_Q16_ONE;
+    }
+
+    if (fb_levels[out] != level)
+    {
+        fb_levels[out] = level;
+        (void)__atomic_fetch_or(&fb_dirty, 1UL << out, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief  Get the buffered level of a discrete output.
+ * @param  out: output id
+ * @retval Brightness in Q16
+ */
+uint32_t fb_get_level(LED_Output_t out)
+{
+    return (out < LED_OUT_COUNT) ? fb_levels[out] : 0U;
+}
+
+/**
+ * @brief  Declare strip pixels changed.
+ * @param  strip: strip id
+ * @param  first: first changed pixel
+ * @param  count: number of changed pixels
+ */
+void fb_strip_mark(Fb_Strip_t strip, uint32_t first, uint32_t count)
+{
+    if (strip >= FB_STRIP_COUNT || count == 0U)
+    {
+        return;
+    }
+
+    Fb_Range_t *r = &fb_strips[strip];
+    if (r->hi == 0U)
+    {
+        r->lo = first;
+        r->hi = first + count;
+    }
+    else
+    {
+        r->lo = (first < r->lo) ? first : r->lo;
+        r->hi = (first + count > r->hi) ? first + count : r->hi;
+    }
+}
+
+/**
+ * @brief  Push changed discrete outputs to BSRR/CCR.
+ */
+void fb_commit_outputs(void)
+{
+    uint32_t registers = 0;
+    uint32_t skipped = 0;
+
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_FB);
+    fb_push_outputs(&registers, &skipped);
+    fb_account(registers, skipped, 0U);
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Push changed discrete outputs and strip ranges.
+ */
+void fb_commit(void)
+{
+    uint32_t registers = 0;
+    uint32_t skipped = 0;
+    uint32_t bytes = 0;
+
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_FB);
+    fb_push_outputs(&registers, &skipped);
+    bare_nvic_crit_exit(crit);
+
+    for (uint32_t s = 0; s < FB_STRIP_COUNT; s++)
+    {
+        Fb_Range_t *r = &fb_strips[s];
+        if (r->hi == 0U)
+        {
+            continue;
+        }
+
+        // Shift-register strips must be clocked from pixel 0 up to the last change
+        int sent = (s == FB_STRIP_WS2812) ? ws2812_show_range(r->hi) : apa102_show_range(r->hi);
+        if (sent < 0)
+        {
+            continue; // Previous frame still on the wire: retry on the next commit
+        }
+
+        bytes += (uint32_t)sent;
+        registers++; // One DMA start
+        r->lo = 0;
+        r->hi = 0;
+    }
+
+    // One commit: outputs and strips together
+    crit = bare_nvic_crit_enter(CRIT_CEILING_FB);
+    fb_account(registers, skipped, bytes);
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Get the commit counters.
+ * @retval Pointer to the statistics record
+ */
+const Fb_Stats_t *fb_get_stats(void)
+{
+    return &fb_stats;
+}
+
+/**
+ * @brief  Reset the commit counters.
+ */
+void fb_reset_stats(void)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_FB);
+    fb_stats.commits = 0;
+    fb_stats.clean_commits = 0;
+    fb_stats.registers = 0;
+    fb_stats.registers_skipped = 0;
+    fb_stats.bytes = 0;
+    fb_stats.last_registers = 0;
+    fb_stats.last_bytes = 0;
+    bare_nvic_crit_exit(crit);
+}
@@ -0,0 +1,259 @@
+/*******************************************************************************************
+ * @file    led_fx.c
+ * @author  ka5j
+ * @brief   Concurrent LED effect scripts built on stackless coroutines
+ * @version 1.1
+ * @date    2025-06-06
+ *
+ * @details
+ * Instances are started and stopped by the terminal task and stepped by the effects task,
+ * which has the higher priority. An instance only becomes visible to fx_run() when its
+ * type byte is published last, and stopping it is a single byte exchange, so no lock is
+ * needed between the two. Whoever exchanges a live type for FX_NONE returns the block.
+ *
+ * Instances are blocks of a memory pool, so starting an effect is O(1). fx_run() scans
+ * the blocks by index up to the highest one ever handed out; free blocks hold FX_NONE.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "led_fx.h"
+#include "coroutine.h"
+#include "led_output.h"
+#include "bare_systick.h" // Tick count for the first wake-up
+#include "mem_pool.h"     // Instance pool
+
+/*******************************************************************************************
+ *                                  Coroutine Helpers
+ *******************************************************************************************/
+
+/**
+ * @brief Suspend the script for ms milliseconds (uses fx, now from the script scope)
+ */
+#define FX_WAIT_MS(ms)                                                       \
+    do                                                                       \
+    {                                                                        \
+        fx->wake = (uint16_t)(now + ((ms) ? (ms) : 1U));                     \
+        CORO_YIELD_UNTIL(&fx->lc, (int16_t)((uint16_t)now - fx->wake) >= 0); \
+    } while (0)
+
+/**
+ * @brief Suspend the script until one of the events in mask is signalled
+ */
+#define FX_WAIT_EVENT(mask)                                  \
+    do                                                       \
+    {                                                        \
+        fx->wait_evt = (mask);                               \
+        CORO_YIELD_UNTIL(&fx->lc, (events & fx->wait_evt)); \
+        fx->wait_evt = 0;                                    \
+    } while (0)
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+MEM_POOL_DEFINE(fx_pool, "FX", Fx_Instance_t, FX_MAX_INSTANCES);
+static volatile uint32_t fx_used; // One past the highest block ever allocated
+static volatile uint8_t fx_pending_events;
+
+/*******************************************************************************************
+ *                                   Effect Scripts
+ *******************************************************************************************/
+
+/**
+ * @brief  Square wave with 50 % duty cycle.
+ */
+static Coro_Status_t fx_script_blink(Fx_Instance_t *fx, uint32_t now, uint8_t events)
+{
+    (void)events;
+
+    CORO_BEGIN(&fx->lc);
+    while (1)
+    {
+        led_output_set((LED_Output_t)fx->output, 100);
+        FX_WAIT_MS(fx->period / 2U);
+        led_output_set((LED_Output_t)fx->output, 0);
+        FX_WAIT_MS(fx->period / 2U);
+    }
+    CORO_END(&fx->lc);
+}
+
+/**
+ * @brief  Linear ramp up and down over one period (200 steps of 1 %).
+ */
+static Coro_Status_t fx_script_breathe(Fx_Instance_t *fx, uint32_t now, uint8_t events)
+{
+    (void)events;
+    uint16_t step = (fx->period >= 200U) ? (uint16_t)(fx->period / 200U) : 1U;
+
+    CORO_BEGIN(&fx->lc);
+    while (1)
+    {
+        for (fx->level = 0; fx->level < 100U; fx->level++)
+        {
+            led_output_set((LED_Output_t)fx->output, fx->level);
+            FX_WAIT_MS(step);
+        }
+        for (fx->level = 100U; fx->level > 0U; fx->level--)
+        {
+            led_output_set((LED_Output_t)fx->output, fx->level);
+            FX_WAIT_MS(step);
+        }
+    }
+    CORO_END(&fx->lc);
+}
+
+/**
+ * @brief  Flash the output for one period after every processed terminal command.
+ */
+static Coro_Status_t fx_script_flash(Fx_Instance_t *fx, uint32_t now, uint8_t events)
+{
+    CORO_BEGIN(&fx->lc);
+    while (1)
+    {
+        FX_WAIT_EVENT(FX_EVT_COMMAND);
+        led_output_set((LED_Output_t)fx->output, 100);
+        FX_WAIT_MS(fx->period);
+        led_output_set((LED_Output_t)fx->output, 0);
+    }
+    CORO_END(&fx->lc);
+}
+
+/**
+ * @brief Script table indexed by Fx_Type_t
+ */
+static Coro_Status_t (*const fx_scripts[FX_TYPE_COUNT])(Fx_Instance_t *, uint32_t, uint8_t) = {
+    [FX_NONE] = NULL,
+    [FX_BLINK] = fx_script_blink,
+    [FX_BREATHE] = fx_script_breathe,
+    [FX_FLASH] = fx_script_flash,
+};
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Set up the instance pool. Must be called before the first fx_start().
+ */
+void fx_init(void)
+{
+    mem_pool_init(&fx_pool);
+}
+
+/**
+ * @brief  Start an effect on an output (terminal / thread context).
+ */
+int fx_start(Fx_Type_t type, LED_Output_t output, uint16_t period)
+{
+    if (type == FX_NONE || type >= FX_TYPE_COUNT || output >= LED_OUT_COUNT || period == 0 ||
+        period > FX_PERIOD_MAX)
+    {
+        return -1;
+    }
+
+    Fx_Instance_t *fx = mem_pool_alloc(&fx_pool);
+    if (fx == NULL)
+    {
+        return -1;
+    }
+    uint32_t i = mem_pool_index(&fx_pool, fx);
+
+    fx->type = FX_NONE; // A never-used block holds garbage (.pools is not zeroed)
+    fx->lc = 0;
+    fx->wake = (uint16_t)SysTick_Get_Ticks(); // Due on the next fx_run() pass
+    fx->period = period;
+    fx->output = (uint8_t)output;
+    fx->level = 0;
+    fx->wait_evt = 0;
+    if (i >= fx_used)
+    {
+        fx_used = i + 1U;
+    }
+    __atomic_store_n(&fx->type, (uint8_t)type, __ATOMIC_RELEASE); // Publish last
+    return (int)i;
+}
+
+/**
+ * @brief  Stop every effect driving an output.
+ */
+uint32_t fx_stop_output(LED_Output_t output)
+{
+    uint32_t stopped = 0;
+
+    for (uint32_t i = 0; i < fx_used; i++)
+    {
+        Fx_Instance_t *fx = mem_pool_block(&fx_pool, i);
+        if (fx->type == FX_NONE || fx->output != (uint8_t)output)
+        {
+            continue;
+        }
+        if (__atomic_exchange_n(&fx->type, (uint8_t)FX_NONE, __ATOMIC_ACQ_REL) != FX_NONE)
+        {
+            mem_pool_free(&fx_pool, fx);
+            stopped++;
+        }
+    }
+    return stopped;
+}
+
+/**
+ * @brief  Signal events to waiting instances (any context).
+ */
+void fx_signal(uint8_t mask)
+{
+    (void)__atomic_fetch_or(&fx_pending_events, mask, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief  Step all due effect instances (effects task context).
+ */
+void fx_run(uint32_t now)
+{
+    uint8_t events = __atomic_exchange_n(&fx_pending_events, 0, __ATOMIC_RELAXED);
+    uint32_t used = fx_used;
+
+    for (uint32_t i = 0; i < used; i++)
+    {
+        Fx_Instance_t *fx = mem_pool_block(&fx_pool, i);
+        uint8_t type = __atomic_load_n(&fx->type, __ATOMIC_ACQUIRE);
+
+        if (type == FX_NONE)
+        {
+            continue;
+        }
+        if (fx->wait_evt != 0)
+        {
+            if ((events & fx->wait_evt) == 0)
+            {
+                continue; // Still waiting for its event
+            }
+        }
+        else if ((int16_t)((uint16_t)now - fx->wake) < 0)
+        {
+            continue; // Timed wait not expired
+        }
+
+        if (fx_scripts[type](fx, now, events) == CORO_ENDED &&
+            __atomic_exchange_n(&fx->type, (uint8_t)FX_NONE, __ATOMIC_ACQ_REL) != FX_NONE)
+        {
+            mem_pool_free(&fx_pool, fx);
+        }
+    }
+}
+
+/**
+ * @brief  Get the number of pool blocks ever used.
+ */
+uint32_t fx_high_water(void)
+{
+    return fx_used;
+}
+
+/**
+ * @brief  Count the running effect instances.
+ */
+uint32_t fx_active_count(void)
+{
+    return mem_pool_in_use(&fx_pool);
+}
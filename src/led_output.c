@@ -0,0 +1,62 @@
+/*******************************************************************************************
+ * @file    led_output.c
+ * @author  ka5j
+ * @brief   Logical LED outputs shared by the command terminal and effect engines
+ * @version 1.1
+ * @date    2025-06-06
+ *
+ * @note    Outputs must be initialized (led1_init / led2_init) before the frame buffer
+ *          is committed.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "led_output.h"
+#include "led_fb.h" // LED frame buffer
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static const LED_OutputMap_t output_map[LED_OUT_COUNT] = {
+    [LED_OUT_LED1] = {GPIOC, GPIO_PIN5, NULL},
+    [LED_OUT_LED2] = {NULL, GPIO_PIN6, TIM4},
+};
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Set the brightness of an output.
+ * @param  out: output id
+ * @param  percent: brightness 0–100
+ */
+void led_output_set(LED_Output_t out, uint8_t percent)
+{
+    if (percent > 100U)
+    {
+        percent = 100U;
+    }
+    fb_set_level(out, ((uint32_t)percent << 16) / 100U);
+}
+
+/**
+ * @brief  Set the brightness of an output with 16-bit resolution.
+ * @param  out: output id
+ * @param  level: brightness in Q16 (LED_OUTPUT_Q16_ONE = 100 %)
+ */
+void led_output_set_q16(LED_Output_t out, uint32_t level)
+{
+    fb_set_level(out, level);
+}
+
+/**
+ * @brief  Get the hardware behind an output.
+ * @param  out: output id
+ * @retval Pointer to the output's hardware mapping
+ */
+const LED_OutputMap_t *led_output_map(LED_Output_t out)
+{
+    return &output_map[out];
+}
@@ -0,0 +1,331 @@
+/*******************************************************************************************
+ * @file    led_proto.c
+ * @author  ka5j
+ * @brief   Binary LED control protocol (COBS frames, CRC-32, acknowledged)
+ * @version 1.0
+ * @date    2025-06-30
+ *
+ * @details
+ * Runs in the event loop: the terminal ISR only collects the encoded bytes between the
+ * two zero delimiters. Frames are decoded in place, so no second buffer is needed, and
+ * the CRC is checked by the hardware unit (bare_crc_compute()).
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "led_proto.h"
+#include "bare_usart.h"     // Ack output
+#include "led_output.h"     // LED1 / LED2 levels
+#include "led_fb.h"         // Frame buffer commit and strip marks
+#include "ws2812.h"         // WS2812 strip driver
+#include "apa102.h"         // APA102 strip driver
+#include "main_functions.h" // release_output()
+#include "bare_crc.h"       // CRC unit
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define LED_PROTO_ACK_SIZE (3U + LED_PROTO_CRC_SIZE) /*!< seq, status, done, crc32 */
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Read a little-endian 16-bit argument.
+ */
+static uint32_t get_u16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+/**
+ * @brief  Run the operations of a frame in order.
+ *
+ * @param  ops: first operation code
+ * @param  len: bytes of operations
+ * @param  done: number of operations that ran
+ * @retval LED_PROTO_OK, or the status of the operation that stopped the run
+ */
+static LED_Proto_Status_t led_proto_run(const uint8_t *ops, uint32_t len, uint8_t *done)
+{
+    static const uint8_t arg_size[] = {
+        [LED_PROTO_OP_PING] = 0U,       [LED_PROTO_OP_LED1] = 1U,
+        [LED_PROTO_OP_LED2_PWM] = 1U,   [LED_PROTO_OP_STRIP_FILL] = 3U,
+        [LED_PROTO_OP_STRIP_SET] = 5U,  [LED_PROTO_OP_STRIP_RUN] = 3U,
+        [LED_PROTO_OP_APA_FILL] = 4U,   [LED_PROTO_OP_APA_SET] = 6U,
+    };
+    uint32_t pos = 0;
+
+    while (pos < len)
+    {
+        uint8_t op = ops[pos++];
+        if (op == 0U || op >= sizeof(arg_size) || len - pos < arg_size[op])
+        {
+            return LED_PROTO_BAD_OP;
+        }
+        const uint8_t *a = &ops[pos];
+        pos += arg_size[op];
+
+        switch ((LED_Proto_Op_t)op)
+        {
+        case LED_PROTO_OP_PING:
+            break;
+
+        case LED_PROTO_OP_LED1:
+            if (a[0] > 2U)
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            release_output(LED_OUT_LED1);
+            if (a[0] == 2U)
+            {
+                uint8_t on = (fb_get_level(LED_OUT_LED1) >= LED_OUTPUT_Q16_ONE / 2U);
+                led_output_set(LED_OUT_LED1, on ? 0 : 100);
+            }
+            else
+            {
+                led_output_set(LED_OUT_LED1, a[0] ? 100 : 0);
+            }
+            break;
+
+        case LED_PROTO_OP_LED2_PWM:
+            if (a[0] > 100U)
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            release_output(LED_OUT_LED2);
+            led_output_set(LED_OUT_LED2, a[0]);
+            break;
+
+        case LED_PROTO_OP_STRIP_FILL:
+            ws2812_fill(a[0], a[1], a[2]);
+            fb_strip_mark(FB_STRIP_WS2812, 0U, ws2812_get_length());
+            break;
+
+        case LED_PROTO_OP_STRIP_SET:
+        {
+            uint32_t i = get_u16(a);
+            if (i >= ws2812_get_length())
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            ws2812_set_pixel(i, a[2], a[3], a[4]);
+            fb_strip_mark(FB_STRIP_WS2812, i, 1U);
+            break;
+        }
+
+        case LED_PROTO_OP_STRIP_RUN:
+        {
+            uint32_t first = get_u16(a);
+            uint32_t count = a[2];
+            if (len - pos < count * 3U)
+            {
+                return LED_PROTO_BAD_OP;
+            }
+            if (count == 0U || first + count > ws2812_get_length())
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            const uint8_t *rgb = &ops[pos];
+            for (uint32_t i = 0; i < count; i++, rgb += 3)
+            {
+                ws2812_set_pixel(first + i, rgb[0], rgb[1], rgb[2]);
+            }
+            fb_strip_mark(FB_STRIP_WS2812, first, count);
+            pos += count * 3U;
+            break;
+        }
+
+        case LED_PROTO_OP_APA_FILL:
+            if (a[3] > APA102_BRIGHTNESS_MAX)
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            apa102_fill(a[0], a[1], a[2], a[3]);
+            fb_strip_mark(FB_STRIP_APA102, 0U, apa102_get_length());
+            break;
+
+        case LED_PROTO_OP_APA_SET:
+        {
+            uint32_t i = get_u16(a);
+            if (i >= apa102_get_length() || a[5] > APA102_BRIGHTNESS_MAX)
+            {
+                return LED_PROTO_BAD_ARG;
+            }
+            apa102_set_pixel(i, a[2], a[3], a[4], a[5]);
+            fb_strip_mark(FB_STRIP_APA102, i, 1U);
+            break;
+        }
+
+        default:
+            return LED_PROTO_BAD_OP;
+        }
+        (*done)++;
+    }
+    return LED_PROTO_OK;
+}
+
+/**
+ * @brief  Send an ack frame: 0x00 COBS(seq status done crc32) 0x00.
+ */
+static void led_proto_ack(Bare_USART_t *reply, uint8_t seq, LED_Proto_Status_t status,
+                          uint8_t done)
+{
+    uint8_t ack[LED_PROTO_ACK_SIZE] = {seq, (uint8_t)status, done};
+    uint32_t crc = bare_crc_compute(ack, 3U);
+    for (uint32_t i = 0; i < LED_PROTO_CRC_SIZE; i++)
+    {
+        ack[3U + i] = (uint8_t)(crc >> (8U * i));
+    }
+
+    uint8_t encoded[LED_PROTO_ACK_SIZE + 1U];
+    uint32_t n = led_proto_cobs_encode(ack, LED_PROTO_ACK_SIZE, encoded);
+
+    bare_usart_write_char(reply, '\0');
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bare_usart_write_char(reply, (char)encoded[i]);
+    }
+    bare_usart_write_char(reply, '\0');
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  COBS-encode a buffer.
+ * @param  src: data
+ * @param  len: bytes of data
+ * @param  dst: output (len + len / 254 + 1 bytes)
+ * @retval Encoded length
+ */
+uint32_t led_proto_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst)
+{
+    uint32_t write = 1;
+    uint32_t code_pos = 0;
+    uint8_t code = 1;
+
+    for (uint32_t read = 0; read < len; read++)
+    {
+        if (src[read] == 0U)
+        {
+            dst[code_pos] = code; // Block ends at a zero
+            code_pos = write++;
+            code = 1;
+        }
+        else
+        {
+            dst[write++] = src[read];
+            if (++code == 0xFFU)
+            {
+                dst[code_pos] = code; // 254 non-zero bytes, no zero implied
+                code_pos = write++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_pos] = code;
+    return write;
+}
+
+/**
+ * @brief  COBS-decode a frame in place (the output never overtakes the input).
+ * @param  buf: encoded frame without delimiters
+ * @param  len: encoded length
+ * @retval Decoded length, -1 if malformed
+ */
+int32_t led_proto_cobs_decode(uint8_t *buf, uint32_t len)
+{
+    uint32_t read = 0;
+    uint32_t write = 0;
+
+    while (read < len)
+    {
+        uint8_t code = buf[read++];
+        if (code == 0U || read + code - 1U > len)
+        {
+            return -1;
+        }
+        for (uint32_t i = 1; i < code; i++)
+        {
+            uint8_t b = buf[read++];
+            if (b == 0U)
+            {
+                return -1;
+            }
+            buf[write++] = b;
+        }
+        if (code != 0xFFU && read != len)
+        {
+            buf[write++] = 0U;
+        }
+    }
+    return (int32_t)write;
+}
+
+/**
+ * @brief  Decode, check and run one frame, then acknowledge it.
+ * @param  ch: protocol state of the terminal
+ * @param  frame: encoded frame
+ * @param  len: encoded length
+ * @param  reply: ack destination
+ */
+void led_proto_process(LED_Proto_Channel_t *ch, uint8_t *frame, uint32_t len,
+                       Bare_USART_t *reply)
+{
+    LED_Proto_Status_t status = LED_PROTO_BAD_CRC;
+    uint8_t seq = 0;
+    uint8_t done = 0;
+
+    ch->frames++;
+
+    if (len > LED_PROTO_FRAME_MAX)
+    {
+        status = LED_PROTO_OVERFLOW;
+    }
+    else
+    {
+        int32_t n = led_proto_cobs_decode(frame, len);
+        if (n > 0)
+        {
+            seq = frame[0];
+        }
+        if (n >= (int32_t)(1U + LED_PROTO_CRC_SIZE))
+        {
+            uint32_t body = (uint32_t)n - LED_PROTO_CRC_SIZE;
+            const uint8_t *c = &frame[body];
+            uint32_t crc = (uint32_t)c[0] | ((uint32_t)c[1] << 8) | ((uint32_t)c[2] << 16) |
+                           ((uint32_t)c[3] << 24);
+            if (crc != bare_crc_compute(frame, body))
+            {
+                status = LED_PROTO_BAD_CRC;
+            }
+            else if (ch->has_last && seq == ch->last_seq)
+            {
+                status = LED_PROTO_OK; // Retransmission: the first copy already ran
+                done = ch->last_done;
+            }
+            else
+            {
+                status = led_proto_run(&frame[1], body - 1U, &done);
+                ch->ops += done;
+                fb_commit(); // Push what the frame changed before acknowledging
+            }
+        }
+    }
+
+    if (status == LED_PROTO_OK)
+    {
+        ch->last_seq = seq;
+        ch->last_done = done;
+        ch->has_last = 1;
+    }
+    else
+    {
+        ch->errors++;
+    }
+    led_proto_ack(reply, seq, status, done);
+}
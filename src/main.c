@@ -2,15 +2,19 @@
  * @file    main.c
  * @author  ka5j
  * @brief   Bare-metal example: UART command terminal + SysTick-based LED toggling
- * @version 1.1
- * @date    2025-05-16
+ * @version 1.2
+ * @date    2025-06-02
  *
  * @details
  * This program demonstrates a register-level embedded system using the STM32F446RE.
  * It toggles an LED (PC8) via SysTick timer interrupt and allows terminal-based
- * user interaction via USART2. Commands entered through the UART interface are parsed
- * and executed in real-time. The project uses no HAL or CMSIS and is designed for
- * bare-metal builds using a Makefile on VS Code (e.g., Raspberry Pi 5 toolchain).
+ * user interaction via USART2 and USART1. ISRs post events to a prioritized event loop,
+ * whose run-to-completion handlers parse and execute the commands entered through the
+ * UART. The event loop runs as the low-priority terminal task of a small preemptive
+ * kernel, so time-critical LED effect tasks are never delayed by a slow command.
+ *
+ * The project uses no HAL or CMSIS and is designed for bare-metal builds using a
+ * Makefile on VS Code (e.g., Raspberry Pi 5 toolchain).
  *******************************************************************************************/
 
 #include <stdlib.h>
@@ -26,8 +30,46 @@
 #include "tim2_5_registers.h"      // TIM2-TIM5 register definitions
 #include "bare_systick.h"          // SysTick driver (bare-metal)
 #include "bare_gpio.h"             // GPIO driver (bare-metal)
-#include "bare_usart.h"            // USART2 driver (bare-metal)
+#include "bare_usart.h"            // USART driver (bare-metal)
 #include "bare_tim2_5.h"           // TIM2-TIM5 (bare-metal)
+#include "bare_dwt.h"              // DWT cycle counter (bare-metal)
+#include "event_loop.h"            // Event loop (ISR -> handler events)
+#include "kernel.h"                // Preemptive scheduler
+#include "led_fx.h"                // Coroutine LED effects
+#include "anim.h"                  // Keyframe animations (TIM2)
+#include "ws2812.h"                // WS2812 strip (TIM3 + DMA1)
+#include "apa102.h"                // APA102 strip (SPI1 + DMA2)
+#include "led_fb.h"                // LED frame buffer
+#include "trace.h"                 // Event trace
+#include "crash.h"                 // Fault handlers, crash record
+#include "stack_check.h"           // MPU stack guard
+#include "perf.h"                  // CPU load accounting
+#include "mem_pool.h"              // Pools and scratch arena
+#include "bare_nvic.h"             // NVIC priorities (bare-metal)
+#include "irq_priorities.h"        // System interrupt priority plan
+#include "bare_crc.h"              // CRC unit (bare-metal)
+#include "image_check.h"           // Flash image CRC check
+
+/*******************************************************************************************
+ *                                       Macros
+ *******************************************************************************************/
+#define STATUS_LED_PERIOD_MS 83U  /*!< PC8 heartbeat toggle period            */
+#define EVENT_TIMER_PERIOD_MS 10U /*!< Period of the EVT_TIMER_EXPIRED event */
+
+#define EFFECTS_TASK_PRIO 1U         /*!< Time-critical LED effects            */
+#define EFFECTS_TASK_PERIOD_MS 1U    /*!< Effect update period                 */
+#define EFFECTS_STACK_WORDS 256U     /*!< Effects task stack (1 KB)            */
+#define TERMINAL_TASK_PRIO 10U       /*!< Event loop / command terminal        */
+#define TERMINAL_STACK_WORDS 512U    /*!< Terminal task stack (2 KB)           */
+
+/*******************************************************************************************
+ *                                    Task Storage
+ *******************************************************************************************/
+static Kernel_TCB_t effects_tcb;
+static Kernel_TCB_t terminal_tcb;
+// Aligned for the MPU guard that the kernel keeps in the lowest STACK_GUARD_BYTES
+static uint32_t effects_stack[EFFECTS_STACK_WORDS] __attribute__((aligned(STACK_GUARD_BYTES)));
+static uint32_t terminal_stack[TERMINAL_STACK_WORDS] __attribute__((aligned(STACK_GUARD_BYTES)));
 
 /*******************************************************************************************
  * @brief   Configure PC8 as output and enable SysTick interrupt for LED blinking.
@@ -35,26 +77,81 @@
  * @param   GPIOx Pointer to GPIO port (e.g., GPIOC)
  * @param   pin   GPIO pin number (e.g., GPIO_PIN8)
  *
- * @note    This function initializes the LED status pin and sets up SysTick to toggle
- *          it periodically (approx. every 83ms). Used to indicate program activity.
+ * @note    This function initializes the LED status pin and sets up SysTick as a 1 ms
+ *          system tick that toggles it every 83 ticks. Used to indicate program activity.
  *******************************************************************************************/
 void program_status_led(GPIO_TypeDef *GPIOx, GPIO_Pins_t pin);
 
+/*******************************************************************************************
+ * @brief   Apply the interrupt priority plan from irq_priorities.h.
+ *
+ * @note    Must run before any interrupt is enabled. Uses 16 preemption levels so that
+ *          BASEPRI critical sections can leave PWM/DMA interrupts unmasked.
+ *******************************************************************************************/
+static void configure_irq_priorities(void);
+
+/*******************************************************************************************
+ * @brief   High-priority task for time-critical LED effect updates.
+ *
+ * @param   arg  Unused
+ *
+ * @note    Wakes every EFFECTS_TASK_PERIOD_MS and preempts the terminal task.
+ *******************************************************************************************/
+static void effects_task(void *arg);
+
+/*******************************************************************************************
+ * @brief   Low-priority task running the event loop (command terminal).
+ *
+ * @param   arg  Unused
+ *
+ * @note    Blocks in kernel_wait() while the event queues are empty, so the idle task runs
+ *          and PERF sees the idle time.
+ *******************************************************************************************/
+static void terminal_task(void *arg);
+
 /*******************************************************************************************
  * @brief   Application entry point
  *
  * @details
- * - Initializes USART2 for serial terminal communication
+ * - Opens USART2 and USART1 for serial terminal communication
  * - Initializes PC8 as output and toggles it via SysTick interrupt
- * - Enters an infinite loop waiting for user commands entered via UART
- * - Commands are parsed and executed via `process_cmd()`
+ * - Switches the terminal to interrupt-driven RX/TX feeding the event loop
+ * - Starts the kernel: the effects task and the event loop (terminal) task, where
+ *   command lines are executed via `process_cmd()`
  *
  * @return  int  Always returns 0 (not used in bare-metal systems)
  *******************************************************************************************/
 int main(void)
 {
-    // Initialize USART2 and print terminal header
+    // Report faults by cause (MemManage/BusFault/UsageFault) instead of HardFault
+    crash_init();
+
+    // Main stack overflow faults immediately instead of overwriting .bss
+    stack_check_init();
+
+    // Start the cycle counter used for handler timing
+    bare_dwt_init();
+
+    // Scratch arena and the effect instance pool (no heap)
+    mem_init();
+    fx_init();
+
+    // Reset event queues before any ISR can post
+    event_loop_init();
+
+    // Interrupt priorities before the first interrupt is enabled
+    configure_irq_priorities();
+
+    // Check the flash image CRC in the background, the DMA feeds the CRC unit
+    bare_crc_init();
+    image_check_start();
+
+    // Open the terminal USARTs and print the terminal header
     usart_terminal_init();
+    if (crash_get_record() != NULL)
+    {
+        bare_usart_send_string("\nRESET AFTER A FAULT, TYPE CRASH FOR DETAILS\r\n> ");
+    }
 
     // Initialize PC8 LED and start periodic toggling via SysTick
     program_status_led(GPIOC, GPIO_PIN8);
@@ -65,57 +162,134 @@ int main(void)
     // Initialize an additional LED2 connected to PC4
     led2_init();
 
-    // Buffer to store UART command input
-    char cmd_buffer[CMD_BUFFER_SIZE];
-    uint8_t cmd_index = 0;
+    // 1 kHz TIM2 tick advancing keyframe animations on LED1/LED2
+    anim_init();
+
+    // WS2812 strip data line on PA6 (idles low until the first STRIP command)
+    ws2812_init();
+
+    // APA102/SK9822 strip on SPI1 (PA5 clock, PA7 data) at 8 MHz
+    apa102_init();
+
+    // Receive commands through the USART ISRs from now on
+    terminal_start();
+
+    // --- Kernel (never returns) ---
+    kernel_task_create(&effects_tcb, "effects", effects_task, NULL,
+                       effects_stack, EFFECTS_STACK_WORDS, EFFECTS_TASK_PRIO);
+    kernel_task_create(&terminal_tcb, "terminal", terminal_task, NULL,
+                       terminal_stack, TERMINAL_STACK_WORDS, TERMINAL_TASK_PRIO);
+    kernel_start();
+
+    return 0;
+}
+
+/*******************************************************************************************
+ * @brief   Apply the interrupt priority plan from irq_priorities.h.
+ *******************************************************************************************/
+static void configure_irq_priorities(void)
+{
+    bare_nvic_set_priority_grouping(NVIC_GROUP_4_0);
+
+    bare_nvic_set_priority(SYSTICK_IRQn, IRQ_PRIO_SYSTICK);
+    bare_nvic_set_priority(USART2_IRQn, IRQ_PRIO_USART);
+    bare_nvic_set_priority(USART1_IRQn, IRQ_PRIO_USART); // Second terminal
+    bare_nvic_set_priority(DMA1_STREAM2_IRQn, IRQ_PRIO_DMA);
+    bare_nvic_set_priority(DMA2_STREAM3_IRQn, IRQ_PRIO_DMA);
+    bare_nvic_set_priority(DMA2_STREAM0_IRQn, IRQ_PRIO_DMA_COPY); // BARE_DMA_COPY_STREAM
+    bare_nvic_set_priority(DMA2_STREAM1_IRQn, IRQ_PRIO_DMA_COPY); // BARE_CRC_DMA_STREAM
+    bare_nvic_set_priority(TIM2_IRQn, IRQ_PRIO_PWM);
+    bare_nvic_set_priority(TIM3_IRQn, IRQ_PRIO_PWM);
+    bare_nvic_set_priority(TIM4_IRQn, IRQ_PRIO_PWM);
+    bare_nvic_set_priority(TIM5_IRQn, IRQ_PRIO_PWM);
+}
+
+/*******************************************************************************************
+ * @brief   High-priority task for time-critical LED effect updates.
+ *******************************************************************************************/
+static void effects_task(void *arg)
+{
+    (void)arg;
 
-    // --- UART Command Processing Loop ---
     while (1)
     {
-        // Read one character from terminal
-        char c = bare_usart_read_char();
-
-        // Echo character back to terminal
-        bare_usart_send_char(c);
-
-        // On Enter key (CR or LF), terminate string and parse command
-        if (c == '\r' || c == '\n')
-        {
-            cmd_buffer[cmd_index] = '\0'; // Null-terminate command string
-            process_cmd(cmd_buffer);      // Figure out what the command is
-            cmd_index = 0;                // Reset buffer index
-        }
-        else if (cmd_index < CMD_BUFFER_SIZE - 1)
-        {
-            // Store character into buffer
-            cmd_buffer[cmd_index++] = c;
-        }
+        // Effect engines are stepped here, ahead of any pending terminal work
+        fx_run(SysTick_Get_Ticks());
+        fb_commit_outputs();
+        kernel_delay(EFFECTS_TASK_PERIOD_MS);
     }
 }
 
+/*******************************************************************************************
+ * @brief   event_post() hook: ready the terminal task if it waits for events.
+ *******************************************************************************************/
+static void terminal_wake(void)
+{
+    kernel_notify(&terminal_tcb);
+}
+
+/*******************************************************************************************
+ * @brief   Low-priority task running the event loop (command terminal).
+ *******************************************************************************************/
+static void terminal_task(void *arg)
+{
+    (void)arg;
+
+    // Every event_post() notifies this task; it waits in the kernel when there is no work
+    event_loop_set_blocking(kernel_wait, terminal_wake);
+
+    // --- Event Loop (never returns) ---
+    event_loop_run();
+}
+
 /*******************************************************************************************
  * @brief   Configure GPIO pin and start SysTick timer for LED heartbeat.
  *
  * @details
  * - Initializes PC8 in push-pull output mode
- * - Starts SysTick timer to fire approx. every 83ms
+ * - Starts SysTick timer to fire every 1 ms
  * - LED toggling is handled inside the SysTick ISR
  *******************************************************************************************/
 void program_status_led(GPIO_TypeDef *GPIOx, GPIO_Pins_t pin)
 {
     bare_gpio_init(GPIOx, pin, GPIO_MODE_OUTPUT, GPIO_OTYPE_PP, GPIO_SPEED_LOW, GPIO_NOPULL);
     bare_gpio_write(GPIOx, pin, GPIO_PIN_SET); // Turn on LED
-    SysTick_Init(SYSTICK_1SEC_RELOAD_16MHZ / 12, SYSTICK_PROCESSOR_CLK, SYSTICK_ENABLE_INTERRUPT);
+    SysTick_Init(SYSTICK_1MS_RELOAD_16MHZ, SYSTICK_PROCESSOR_CLK, SYSTICK_ENABLE_INTERRUPT);
 }
 
 /*******************************************************************************************
  * @brief   SysTick interrupt handler
  *
  * @details
- * Called every time the SysTick timer expires (approx. 83ms interval).
- * Toggles PC8 to blink LED as a program-alive indicator.
+ * Called every time the SysTick timer expires (1 ms interval).
+ * - Advances the system tick counter and the kernel (delays, time slicing)
+ * - Toggles PC8 every 83 ms to blink LED as a program-alive indicator (the GPIOC ODR
+ *   read-modify-write is safe here: LED outputs on GPIOC are only written through BSRR
+ *   by the frame buffer commit, which masks SysTick with CRIT_CEILING_FB)
+ * - Posts EVT_TIMER_EXPIRED every 10 ms (dropped if no handler is registered)
+ * - Closes the one-second CPU load window every 1000 ticks
+ * - Records entry and exit in the event trace and its cycles in the CPU load counters
  *******************************************************************************************/
-void SysTick_Handler(void)
+RAMFUNC void SysTick_Handler(void)
 {
-    bare_gpio_toggle(GPIOC, GPIO_PIN8);
+    uint32_t start = perf_isr_enter();
+    trace_isr_enter(TRACE_SRC_SYSTICK);
+    SysTick_Inc_Tick();
+    kernel_tick();
+    uint32_t ticks = SysTick_Get_Ticks();
+
+    if (ticks % STATUS_LED_PERIOD_MS == 0)
+    {
+        bare_gpio_toggle(GPIOC, GPIO_PIN8);
+    }
+
+    if (ticks % EVENT_TIMER_PERIOD_MS == 0)
+    {
+        (void)event_post(EVT_TIMER_EXPIRED, 0);
+    }
+
+    perf_tick(ticks);
+
+    trace_isr_exit(TRACE_SRC_SYSTICK, ticks);
+    perf_isr_exit(PERF_SRC_SYSTICK, start);
 }
@@ -6,13 +6,14 @@
  * @date    2025-05-16
  *
  * @details
- * This source file contains initialization routines for the USART2 terminal and GPIO LED,
+ * This source file contains initialization routines for the USART terminals and GPIO LED,
  * as well as a command parser that interprets user input from UART and maps it to hardware
  * actions (e.g., toggling PC5). All operations are performed using custom bare-metal drivers.
  *******************************************************************************************/
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 
 #include "main_functions.h"
@@ -24,112 +25,1577 @@
 #include "tim2_5_registers.h"      // TIM2-TIM5 register definitions
 #include "bare_systick.h"          // SysTick driver (bare-metal)
 #include "bare_gpio.h"             // GPIO driver (bare-metal)
-#include "bare_usart.h"            // USART2 driver (bare-metal)
+#include "bare_usart.h"            // USART driver (bare-metal)
 #include "bare_tim2_5.h"           // TIM2-TIM5 (bare-metal)
+#include "event_loop.h"            // Event loop (ISR -> handler events)
+#include "led_fx.h"                // Coroutine LED effects
+#include "anim.h"                  // Keyframe animations
+#include "dsp_bench.h"             // DSP kernel benchmark
+#include "ws2812.h"                // WS2812 strip driver
+#include "apa102.h"                // APA102 strip driver
+#include "bare_dwt.h"              // Cycle counter frequency
+#include "led_fb.h"                // LED frame buffer
+#include "trace.h"                 // Event trace
+#include "crash.h"                 // Crash record
+#include "stack_check.h"           // Stack high-water marks
+#include "kernel.h"                // Task list
+#include "perf.h"                  // CPU load windows
+#include "mem_pool.h"              // Pools and scratch arena
+#include "led_proto.h"             // Binary frames
+#include "image_check.h"           // Flash image CRC check
+#include "bare_nvic.h"             // Critical sections
+#include "irq_priorities.h"        // CRIT_CEILING_TERMINAL
+
+/*******************************************************************************************
+ *                                   Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief Baud rate switch-over of a terminal
+ */
+typedef enum
+{
+    TERM_BAUD_IDLE = 0U, /*!< Rate confirmed                                    */
+    TERM_BAUD_SWITCH,    /*!< BAUD <rate> replied, switch after the reply       */
+    TERM_BAUD_HUNT,      /*!< BAUD AUTO replied, hunt after the reply           */
+    TERM_BAUD_CONFIRM,   /*!< New rate set, waiting for Enter or the deadline   */
+    TERM_BAUD_AUTO       /*!< Hunting, waiting for the locking Enter or deadline */
+} Terminal_Baud_State_t;
+
+/**
+ * @brief State a terminal can subscribe to (SUBSCRIBE)
+ */
+typedef enum
+{
+    TERM_TOPIC_LED1 = 0U, /*!< LED1 on/off                                        */
+    TERM_TOPIC_LED2,      /*!< LED2 duty in %                                     */
+    TERM_TOPIC_COUNTERS,  /*!< Commands, binary frames and naks of every terminal */
+    TERM_TOPIC_COUNT
+} Terminal_Topic_t;
+
+#define TERM_TOPIC_VALUES 3U /*!< Values of the largest topic (COUNTERS) */
+
+/**
+ * @brief One subscription: values last pushed, compared against the shadow state
+ */
+typedef struct
+{
+    uint8_t active;                     /*!< Subscribed                        */
+    uint8_t primed;                     /*!< values[] holds a pushed snapshot  */
+    uint16_t period_ms;                 /*!< 0: push on change                 */
+    uint32_t next_tick;                 /*!< SysTick of the earliest next push */
+    uint32_t values[TERM_TOPIC_VALUES]; /*!< Last pushed                       */
+} Terminal_Sub_t;
+
+/**
+ * @brief One command terminal: its USART and the line buffers its ISR fills
+ */
+typedef struct
+{
+    Bare_USART_t *usart;                                // Opened in usart_terminal_init()
+    char lines[CMD_LINE_BUFFERS][CMD_BUFFER_SIZE];      // Filled by ISR, parsed by handler
+    volatile uint8_t pending[CMD_LINE_BUFFERS];         // Line posted, not yet parsed
+    uint8_t line;                                       // Line being filled (ISR only)
+    uint8_t index;                                      // Write position (ISR only)
+    uint32_t tx_bursts;                                 // Completed transmissions
+    uint32_t commands;                                  // Lines executed
+    Terminal_Baud_State_t baud_state;                   // BAUD switch-over
+    uint32_t baud_next;                                 // Rate requested by BAUD <rate>
+    uint32_t baud_prev;                                 // Rate to fall back to
+    uint32_t baud_deadline;                             // SysTick limit to confirm or lock
+    uint8_t frames[TERMINAL_FRAME_BUFFERS][LED_PROTO_FRAME_MAX]; // Encoded binary frames
+    uint16_t frame_len[TERMINAL_FRAME_BUFFERS];         // Encoded length (ISR)
+    volatile uint8_t frame_pending[TERMINAL_FRAME_BUFFERS]; // Frame posted, not yet run
+    uint8_t frame;                                      // Frame being filled (ISR only)
+    uint8_t in_frame;                                   // Opening zero seen: no echo (ISR)
+    uint16_t frame_index;                               // Since the last zero/line end (ISR)
+    uint32_t frames_dropped;                            // Every frame buffer was busy
+    LED_Proto_Channel_t proto;                          // Sequence numbers and counters
+    uint8_t compact;                                    // MODE COMPACT: no echo or prompt
+    volatile uint8_t echo_held;                         // Echo queued under a TX hold
+    volatile uint32_t echo_tick;                        // SysTick of the last echo
+    Terminal_Sub_t subs[TERM_TOPIC_COUNT];              // SUBSCRIBE topics
+} Terminal_Session_t;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+BARE_USART_DEFINE(term_usart2, "USART2", USART_TX_BUFFER_SIZE); // ST-LINK virtual COM port
+BARE_USART_DEFINE(term_usart1, "USART1", USART_TX_BUFFER_SIZE); // Second host (PA9/PA10)
+
+static const Bare_USART_Config_t term_usart_cfg[TERMINAL_SESSIONS] = {
+    {USART2, GPIOA, 2, GPIOA, 3, AF7, TERMINAL_BAUD},
+    {USART1, GPIOA, 9, GPIOA, 10, AF7, TERMINAL_BAUD},
+};
+
+static Terminal_Session_t sessions[TERMINAL_SESSIONS] = {{&term_usart2}, {&term_usart1}};
+
+static Terminal_Session_t *reply_session; // Terminal of the command being executed
+static Reply_Status_t reply_status;       // First failure of the command
+
+static const char *const topic_name[TERM_TOPIC_COUNT] = {"LED1", "LED2", "COUNTERS"};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Send the echo queued since the first character of a line (thread context).
+ */
+static void terminal_echo_release(Terminal_Session_t *s)
+{
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_TERMINAL);
+    if (s->echo_held)
+    {
+        s->echo_held = 0;
+        bare_usart_tx_release(s->usart);
+    }
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Find the terminal a USART belongs to.
+ * @retval Session, NULL if the USART is not a terminal
+ */
+static Terminal_Session_t *terminal_session_of(const Bare_USART_t *usart)
+{
+    for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+    {
+        if (sessions[i].usart == usart)
+        {
+            return &sessions[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  Read a topic from shadow state: frame buffer levels and software counters, no
+ *         peripheral registers.
+ */
+static void terminal_topic_read(Terminal_Topic_t topic, uint32_t values[TERM_TOPIC_VALUES])
+{
+    values[0] = 0;
+    values[1] = 0;
+    values[2] = 0;
+    switch (topic)
+    {
+    case TERM_TOPIC_LED1:
+        values[0] = (fb_get_level(LED_OUT_LED1) >= LED_OUTPUT_Q16_ONE / 2U);
+        break;
+
+    case TERM_TOPIC_LED2:
+        values[0] = (fb_get_level(LED_OUT_LED2) * 100U + LED_OUTPUT_Q16_ONE / 2U) >> 16;
+        break;
+
+    default:
+        for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+        {
+            values[0] += sessions[i].commands;
+            values[1] += sessions[i].proto.frames;
+            values[2] += sessions[i].proto.errors;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief  Push the subscriptions that are due (EVT_TIMER_EXPIRED, thread context).
+ *
+ * @note   Change subscriptions compare the topic with the values they last pushed; a change
+ *         within TERMINAL_NOTIFY_MIN_MS of the previous push waits, and only the value at
+ *         the end of the hold-off is sent. Nothing is pushed into a line being typed or a
+ *         baud rate switch-over.
+ */
+static void terminal_notify(Terminal_Session_t *s, uint32_t now)
+{
+    uint32_t values[TERM_TOPIC_VALUES];
+    uint8_t sent = 0;
+
+    if (s->usart->regs == NULL || s->baud_state != TERM_BAUD_IDLE || s->index != 0U)
+    {
+        return;
+    }
+    for (uint32_t t = 0; t < TERM_TOPIC_COUNT; t++)
+    {
+        Terminal_Sub_t *sub = &s->subs[t];
+        if (!sub->active || (int32_t)(now - sub->next_tick) < 0)
+        {
+            continue;
+        }
+        terminal_topic_read((Terminal_Topic_t)t, values);
+        if (sub->period_ms == 0U && sub->primed &&
+            memcmp(values, sub->values, sizeof(values)) == 0)
+        {
+            continue; // Unchanged; next_tick stays due so a change is sent at once
+        }
+        memcpy(sub->values, values, sizeof(values));
+        sub->primed = 1;
+        sub->next_tick = now + ((sub->period_ms != 0U) ? sub->period_ms : TERMINAL_NOTIFY_MIN_MS);
+
+        if (!sent)
+        {
+            bare_usart_tx_hold(s->usart); // Every push of this tick as one transmission
+            sent = 1;
+        }
+        if (t == TERM_TOPIC_LED1)
+        {
+            bare_usart_write_fmt(s->usart, "\n@LED1 %s\r", values[0] ? "ON" : "OFF");
+        }
+        else if (t == TERM_TOPIC_LED2)
+        {
+            bare_usart_write_fmt(s->usart, "\n@LED2 %" PRIu32 "%%\r", values[0]);
+        }
+        else
+        {
+            bare_usart_write_fmt(s->usart, "\n@COUNTERS CMDS %" PRIu32 " FRAMES %" PRIu32
+                                 " NAKS %" PRIu32 "\r", values[0], values[1], values[2]);
+        }
+    }
+    if (sent)
+    {
+        if (!s->compact)
+        {
+            bare_usart_write_fmt(s->usart, "\r\n> ");
+        }
+        bare_usart_tx_release(s->usart);
+    }
+}
+
+/**
+ * @brief  Apply a switch BAUD requested, once its reply and prompt have left at the old rate.
+ */
+static void terminal_baud_switch(Terminal_Session_t *s)
+{
+    if (s->baud_state != TERM_BAUD_SWITCH && s->baud_state != TERM_BAUD_HUNT)
+    {
+        return;
+    }
+    bare_usart_flush(s->usart);
+    s->baud_prev = s->usart->baud;
+    s->baud_deadline = SysTick_Get_Ticks() + TERMINAL_BAUD_CONFIRM_MS;
+    if (s->baud_state == TERM_BAUD_HUNT)
+    {
+        bare_usart_autobaud(s->usart);
+        s->baud_state = TERM_BAUD_AUTO;
+    }
+    else if (bare_usart_set_baud(s->usart, s->baud_next) == 0)
+    {
+        s->baud_state = TERM_BAUD_CONFIRM;
+    }
+    else
+    {
+        s->baud_state = TERM_BAUD_IDLE; // Checked by BAUD, cannot happen
+    }
+}
+
+/**
+ * @brief  Handle a line that arrives while a new rate waits for its confirmation.
+ *
+ * @note   Only an empty line (Enter) confirms: a line assembled from garbage at a rate the
+ *         host has not switched to is dropped, and the deadline still reverts the rate.
+ */
+static void terminal_baud_confirm(Terminal_Session_t *s, const char *line)
+{
+    if (line[0] != '\0')
+    {
+        return;
+    }
+    s->baud_state = TERM_BAUD_IDLE;
+    bare_usart_send_string("\nBAUD ");
+    bare_usart_send_uint(s->usart->baud);
+    bare_usart_send_string(" OK\r\n> ");
+}
+
+/**
+ * @brief  Collect a binary frame byte (USART ISR context).
+ *
+ * @details
+ * Every zero ends the frame gathered since the previous zero, so one lost delimiter
+ * costs at most the frame it belonged to. An empty frame is ignored: that zero opens
+ * the next frame, and the bytes up to the next zero skip the echo and the line buffers.
+ * After a non-empty frame the terminal is back in text mode; text bytes are gathered
+ * too, up to each line end, so a frame whose opening zero was lost still runs.
+ *
+ * @note   A frame that arrives while every frame buffer is busy is swallowed up to its
+ *         closing zero and dropped without an ack; the host retransmits it.
+ */
+static void terminal_rx_frame(Terminal_Session_t *s, uint8_t b)
+{
+    if (b != 0U)
+    {
+        if (s->frame_index < LED_PROTO_FRAME_MAX && !s->frame_pending[s->frame])
+        {
+            s->frames[s->frame][s->frame_index] = b;
+        }
+        if (s->frame_index <= LED_PROTO_FRAME_MAX)
+        {
+            s->frame_index++; // LED_PROTO_FRAME_MAX + 1 flags an overflow
+        }
+        return;
+    }
+
+    uint16_t len = s->frame_index;
+    s->frame_index = 0;
+    if (len == 0U)
+    {
+        s->in_frame = 1; // Empty frame: this zero opens the next one
+        return;
+    }
+    if (!s->in_frame)
+    {
+        s->index = 0; // The partial text line was a frame that lost its opening zero
+    }
+    s->in_frame = 0;
+    if (s->frame_pending[s->frame])
+    {
+        s->frames_dropped++;
+        return;
+    }
+    s->frame_len[s->frame] = len;
+    s->frame_pending[s->frame] = 1;
+    uint16_t arg = (uint16_t)(((uint32_t)(s - sessions) << 8) | s->frame);
+    if (event_post(EVT_RX_FRAME_READY, arg) != 0)
+    {
+        s->frame_pending[s->frame] = 0; // Queue full: frame is lost, reuse buffer
+        s->frames_dropped++;
+    }
+    else
+    {
+        s->frame = (uint8_t)((s->frame + 1U) % TERMINAL_FRAME_BUFFERS);
+    }
+}
+
+/*******************************************************************************************
+ *                                   Event Handlers
+ *******************************************************************************************/
+
+/**
+ * @brief  EVT_RX_LINE_READY handler: parse the completed line and release its buffer.
+ *
+ * @note   arg is (session << 8) | line. Replies go to the terminal that sent the line.
+ */
+static void terminal_line_handler(const Event_t *evt)
+{
+    Terminal_Session_t *s = &sessions[evt->arg >> 8];
+    uint8_t line = (uint8_t)(evt->arg & 0xFFU);
+
+    bare_usart_set_console(s->usart);
+    if (s->baud_state == TERM_BAUD_CONFIRM || s->baud_state == TERM_BAUD_AUTO)
+    {
+        terminal_baud_confirm(s, s->lines[line]);
+        s->pending[line] = 0;
+        terminal_echo_release(s);
+        return;
+    }
+    process_cmd(s->lines[line]);
+    s->commands++;
+    s->pending[line] = 0;
+    terminal_echo_release(s); // Echo, reply and prompt leave as one transmission
+    terminal_baud_switch(s);  // After the reply, so it still goes out at the old rate
+}
+
+/**
+ * @brief  EVT_RX_FRAME_READY handler: run the binary frame and release its buffer.
+ *
+ * @note   arg is (session << 8) | buffer. The ack goes to the terminal that sent the frame.
+ */
+static void terminal_frame_ready_handler(const Event_t *evt)
+{
+    Terminal_Session_t *s = &sessions[evt->arg >> 8];
+    uint8_t buf = (uint8_t)(evt->arg & 0xFFU);
+
+    led_proto_process(&s->proto, s->frames[buf], s->frame_len[buf], s->usart);
+    s->frame_pending[buf] = 0;
+}
+
+/**
+ * @brief  EVT_TIMER_EXPIRED handler: commit the frame buffer (strips retried when busy),
+ *         send echo held for a line that is being typed by hand, revert baud rates that
+ *         were not confirmed in time, push due subscriptions and report a corrupt image
+ *         once its background check has finished.
+ */
+static void terminal_frame_handler(const Event_t *evt)
+{
+    static uint8_t image_reported;
+
+    (void)evt;
+    fb_commit();
+
+    if (!image_reported && image_check_get()->status != IMAGE_CHECK_RUNNING)
+    {
+        image_reported = 1;
+        if (image_check_get()->status == IMAGE_CHECK_MISMATCH)
+        {
+            bare_usart_send_string("\nFLASH IMAGE CRC MISMATCH, TYPE IMAGE FOR DETAILS\r\n> ");
+        }
+    }
+
+    for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+    {
+        Terminal_Session_t *s = &sessions[i];
+        if (s->echo_held && SysTick_Get_Ticks() - s->echo_tick >= TERMINAL_ECHO_HOLD_MS)
+        {
+            terminal_echo_release(s); // Typing pause: show the echo without waiting for Enter
+        }
+        if ((s->baud_state == TERM_BAUD_CONFIRM || s->baud_state == TERM_BAUD_AUTO) &&
+            (int32_t)(SysTick_Get_Ticks() - s->baud_deadline) >= 0)
+        {
+            uint8_t hunting = (s->baud_state == TERM_BAUD_AUTO);
+            s->baud_state = TERM_BAUD_IDLE;
+            (void)bare_usart_set_baud(s->usart, s->baud_prev); // Also ends the hunt
+            bare_usart_set_console(s->usart);
+            bare_usart_send_string(hunting ? "\nBAUD NOT DETECTED, BACK TO "
+                                           : "\nBAUD NOT CONFIRMED, BACK TO ");
+            bare_usart_send_uint(s->baud_prev);
+            bare_usart_send_string("\r\n> ");
+        }
+        terminal_notify(s, SysTick_Get_Ticks());
+    }
+}
+
+/**
+ * @brief  EVT_TX_DONE handler: count transmissions that have fully left the USART.
+ */
+static void terminal_tx_done_handler(const Event_t *evt)
+{
+    sessions[evt->arg].tx_bursts++;
+}
 
 /*******************************************************************************************
  * @brief   Initialize USART terminal interface
  *
  * @details
- * Sets up USART2 at 115200 baud for UART communication and clears the screen.
- * Prints a startup header to the connected terminal and displays an input prompt.
+ * Opens every terminal USART at TERMINAL_BAUD and clears its screen. Prints a startup
+ * header to each connected terminal and displays an input prompt. The first terminal
+ * (USART2) is left as the console for boot messages.
+ *******************************************************************************************/
+void usart_terminal_init(void)
+{
+    for (int32_t i = TERMINAL_SESSIONS - 1; i >= 0; i--)
+    {
+        if (bare_usart_open(sessions[i].usart, &term_usart_cfg[i]) != 0)
+        {
+            continue;
+        }
+        bare_usart_set_console(sessions[i].usart);
+        bare_usart_clear_screen(); // Clear terminal (ANSI escape)
+        bare_usart_send_string("STM32 Terminal ready. Type commands:\r\n> ");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Start the interrupt-driven terminals
+ *
+ * @details
+ * Binds the terminal handlers to the event loop and enables the RX/TX interrupts of
+ * every terminal USART. Command lines are then parsed by the event loop instead of a
+ * blocking read loop.
+ *******************************************************************************************/
+void terminal_start(void)
+{
+    event_loop_register(EVT_RX_LINE_READY, EVT_PRIO_NORMAL, terminal_line_handler);
+    event_loop_register(EVT_RX_FRAME_READY, EVT_PRIO_NORMAL, terminal_frame_ready_handler);
+    event_loop_register(EVT_TX_DONE, EVT_PRIO_LOW, terminal_tx_done_handler);
+    event_loop_register(EVT_TIMER_EXPIRED, EVT_PRIO_LOW, terminal_frame_handler);
+    for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+    {
+        if (sessions[i].usart->regs != NULL)
+        {
+            bare_usart_enable_interrupts(sessions[i].usart, terminal_rx_char, terminal_tx_done,
+                                         &sessions[i]);
+        }
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Terminal receive callback (USART ISR context)
+ *
+ * @param   context   Terminal session
+ * @param   c         Received character
+ *
+ * @details
+ * Echoes the character (text mode) and assembles command lines. On CR or LF the line
+ * is terminated and posted to the event loop, and the ISR moves on to the next line
+ * buffer so typing can continue while the previous command executes. Binary frames
+ * (zero byte, COBS data, zero byte) bypass the echo and the line buffers; see
+ * terminal_rx_frame() for how a lost delimiter is recovered.
+ *******************************************************************************************/
+void terminal_rx_char(void *context, char c)
+{
+    Terminal_Session_t *s = (Terminal_Session_t *)context;
+
+    if (s->in_frame || c == '\0')
+    {
+        terminal_rx_frame(s, (uint8_t)c);
+        return;
+    }
+
+    // Text is gathered as a frame too, restarting at each line end
+    if (c == '\r' || c == '\n')
+    {
+        s->frame_index = 0;
+    }
+    else
+    {
+        terminal_rx_frame(s, (uint8_t)c);
+    }
+
+    // Echo character back to the terminal it came from, held so that a line sent in one
+    // burst is echoed together with its reply (see terminal_echo_release())
+    if (!s->compact)
+    {
+        if (!s->echo_held)
+        {
+            s->echo_held = 1;
+            bare_usart_tx_hold(s->usart);
+        }
+        s->echo_tick = SysTick_Get_Ticks();
+        bare_usart_write_char(s->usart, c);
+    }
+
+    if (s->pending[s->line])
+    {
+        return; // All line buffers busy: drop input until the handler catches up
+    }
+
+    // On Enter key (CR or LF), terminate string and hand it to the event loop
+    if (c == '\r' || c == '\n')
+    {
+        s->lines[s->line][s->index] = '\0';
+        s->pending[s->line] = 1;
+        uint16_t arg = (uint16_t)(((uint32_t)(s - sessions) << 8) | s->line);
+        if (event_post(EVT_RX_LINE_READY, arg) != 0)
+        {
+            s->pending[s->line] = 0; // Queue full: line is lost, reuse buffer
+        }
+        else
+        {
+            s->line = (uint8_t)((s->line + 1U) % CMD_LINE_BUFFERS);
+        }
+        s->index = 0;
+    }
+    else if (s->index < CMD_BUFFER_SIZE - 1)
+    {
+        // Store character into buffer
+        s->lines[s->line][s->index++] = c;
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Terminal transmit complete callback (USART ISR context)
+ *
+ * @param   context   Terminal session
+ *******************************************************************************************/
+void terminal_tx_done(void *context)
+{
+    Terminal_Session_t *s = (Terminal_Session_t *)context;
+    (void)event_post(EVT_TX_DONE, (uint16_t)(s - sessions));
+}
+
+/*******************************************************************************************
+ * @brief   Initialize PC5 for user-controlled LED output
+ *
+ * @details
+ * Configures GPIOC Pin 5 as push-pull output with low speed and no pull resistors.
+ * This pin is toggled by UART commands such as "LED1 ON" or "LED1 TOGGLE".
+ *******************************************************************************************/
+void led1_init(void)
+{
+    bare_gpio_init(GPIOC, GPIO_PIN5, GPIO_MODE_OUTPUT,
+                   GPIO_OTYPE_PP, GPIO_SPEED_LOW, GPIO_NOPULL);
+}
+
+/*******************************************************************************************
+ * @brief   Initialize user LED on PB6 as GPIO lternate function for TIM4 Channel 1 PWM.
+ *
+ * @details
+ * Configures GPIOB Pin 6 as alternate function (AF2). This pin can be controlled via PWM
+ * via command or from within your embedded application logic.
+ *******************************************************************************************/
+void led2_init(void)
+{
+    bare_gpio_AF(GPIOB, GPIO_PIN6, AF2);
+    bare_tim2_5_PWM(TIM4);
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for LED1
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * Supports commands to control GPIOC Pin 5 (user LED):
+ * - "LED1 ON"         → Sets PC5 high
+ * - "LED1 OFF"        → Sets PC5 low
+ * - "LED1 TOGGLE"     → Inverts PC5
+ * - "LED1 BLINK <ms>" → Blinks PC5 with the given period
+ * - "LED1 FLASH <ms>" → Flashes PC5 for <ms> after every command
+ * ON/OFF/TOGGLE stop any effect or animation running on LED1.
+ * Unrecognized commands print a default error message.
+ *******************************************************************************************/
+void led1_process_cmd(const char *cmd)
+{
+    if (strcmp(cmd, "LED1 ON") == 0)
+    {
+        release_output(LED_OUT_LED1);
+        led_output_set(LED_OUT_LED1, 100);
+        reply_ack("\nLED1 turned ON\r");
+    }
+    else if (strcmp(cmd, "LED1 OFF") == 0)
+    {
+        release_output(LED_OUT_LED1);
+        led_output_set(LED_OUT_LED1, 0);
+        reply_ack("\nLED1 turned OFF\r");
+    }
+    else if (strcmp(cmd, "LED1 TOGGLE") == 0)
+    {
+        release_output(LED_OUT_LED1);
+        uint8_t on = (fb_get_level(LED_OUT_LED1) >= LED_OUTPUT_Q16_ONE / 2U);
+        led_output_set(LED_OUT_LED1, on ? 0 : 100);
+
+        reply_ack("\nLED1 TOGGLED\r");
+    }
+    else if (strcmp(cmd, "LED1 STATUS") == 0)
+    {
+        check_led1_state(GPIOC, GPIO_PIN5);
+    }
+    else if (strncmp(cmd, "LED1 BLINK ", 11) == 0)
+    {
+        start_effect_cmd(FX_BLINK, LED_OUT_LED1, &cmd[11]);
+    }
+    else if (strncmp(cmd, "LED1 FLASH ", 11) == 0)
+    {
+        start_effect_cmd(FX_FLASH, LED_OUT_LED1, &cmd[11]);
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for LED2
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * Supports commands to control the TIM4 CH1 PWM output on PB6:
+ * - "LED2 PWM <0-100>"  → Sets the duty cycle (stops any effect or animation)
+ * - "LED2 BREATHE <ms>" → Ramps the duty cycle up and down over <ms>
+ * - "LED2 BLINK <ms>"   → Blinks with the given period
+ *******************************************************************************************/
+void led2_process_cmd(const char *cmd)
+{
+    if (strncmp(cmd, "LED2 PWM ", 9) == 0)
+    {
+        char *end;
+        unsigned long duty = strtoul(&cmd[9], &end, 10);
+        if (end == &cmd[9] || *end != '\0' || duty > 100UL)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID PWM VALUE (0%-100%)\r");
+            return;
+        }
+
+        release_output(LED_OUT_LED2);
+        led_output_set(LED_OUT_LED2, (uint8_t)duty);
+        reply_ack("\nLED2 PWM MODIFIED\r");
+    }
+    else if (strncmp(cmd, "LED2 BREATHE ", 13) == 0)
+    {
+        start_effect_cmd(FX_BREATHE, LED_OUT_LED2, &cmd[13]);
+    }
+    else if (strncmp(cmd, "LED2 BLINK ", 11) == 0)
+    {
+        start_effect_cmd(FX_BLINK, LED_OUT_LED2, &cmd[11]);
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+void led3_process_cmd(const char *cmd)
+{
+    /***********Incomplete************/
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the keyframe animation engine
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "ANIM START <LED1|LED2> <BREATHE|STROBE|HEARTBEAT> <ms>" → Starts a built-in curve
+ * - "ANIM KEYS <LED1|LED2> <ms>:<0-1000> ..."                → Starts custom keyframes,
+ *   the first at 0 ms, the last one closing the loop
+ * - "ANIM STOP <LED1|LED2>"                                  → Stops the animation
+ * - "ANIM STATUS"                                            → Channel states and the
+ *   cost of the last 1 ms tick in CPU cycles, per active channel
+ * Starting an animation stops any effect running on the same output.
+ *******************************************************************************************/
+void anim_process_cmd(const char *cmd)
+{
+    LED_Output_t out;
+
+    if (strncmp(cmd, "ANIM START ", 11) == 0 && parse_output(&cmd[11], &out) == 0)
+    {
+        if (cmd[15] != ' ')
+        {
+            reply_error(REPLY_INVALID, "\nMISSING CURVE (BREATHE, STROBE, HEARTBEAT)\r");
+            return;
+        }
+        const char *arg = &cmd[16];
+        Anim_Curve_t curve = ANIM_CURVE_CUSTOM;
+
+        for (uint32_t c = ANIM_CURVE_BREATHE; c < ANIM_CURVE_COUNT; c++)
+        {
+            const char *name = anim_curve_name((Anim_Curve_t)c);
+            size_t len = strlen(name);
+            if (strncmp(arg, name, len) == 0 && arg[len] == ' ')
+            {
+                curve = (Anim_Curve_t)c;
+                arg += len + 1U;
+                break;
+            }
+        }
+
+        int period = atoi(arg);
+        if (curve == ANIM_CURVE_CUSTOM)
+        {
+            reply_error(REPLY_UNKNOWN, "\nUNKNOWN CURVE\r");
+        }
+        else if (period < 20 || period > 65535)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID PERIOD (20-65535 ms)\r");
+        }
+        else
+        {
+            release_output(out);
+            (void)anim_start_preset(out, curve, (uint16_t)period);
+            reply_ack("\nANIMATION STARTED\r");
+        }
+    }
+    else if (strncmp(cmd, "ANIM KEYS ", 10) == 0 && parse_output(&cmd[10], &out) == 0)
+    {
+        Anim_Keyframe_t keys[ANIM_MAX_KEYFRAMES];
+        uint32_t count = 0;
+        const char *p = &cmd[14]; // Space before the first keyframe
+
+        while (*p == ' ' && count < ANIM_MAX_KEYFRAMES)
+        {
+            char *end;
+            unsigned long t = strtoul(p + 1, &end, 10);
+            if (*end != ':' || t > 65535UL)
+            {
+                break;
+            }
+            const char *digits = end + 1;
+            unsigned long level = strtoul(digits, &end, 10);
+            if (end == digits || level > ANIM_LEVEL_MAX)
+            {
+                break; // Reported below: *p is not the end of the line
+            }
+            keys[count].time_ms = (uint16_t)t;
+            keys[count].level = (uint16_t)level;
+            count++;
+            p = end;
+        }
+
+        if (*p != '\0')
+        {
+            reply_error(REPLY_INVALID, "\nINVALID KEYFRAME (<ms>:<0-1000>, max 8)\r");
+            return;
+        }
+
+        release_output(out);
+        if (anim_start(out, ANIM_CURVE_CUSTOM, keys, count) != 0)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID CURVE (start at 0, times ascending)\r");
+        }
+        else
+        {
+            reply_ack("\nANIMATION STARTED\r");
+        }
+    }
+    else if (strncmp(cmd, "ANIM STOP ", 10) == 0 && parse_output(&cmd[10], &out) == 0)
+    {
+        anim_stop(out);
+        reply_ack("\nANIMATION STOPPED\r");
+    }
+    else if (strcmp(cmd, "ANIM STATUS") == 0)
+    {
+        for (uint32_t i = 0; i < LED_OUT_COUNT; i++)
+        {
+            Anim_ChannelInfo_t info;
+            anim_get_info((LED_Output_t)i, &info);
+
+            bare_usart_send_string("\nLED");
+            bare_usart_send_uint(i + 1U);
+            if (!info.active)
+            {
+                bare_usart_send_string(" IDLE\r");
+                continue;
+            }
+            bare_usart_send_string(" ");
+            bare_usart_send_string(anim_curve_name((Anim_Curve_t)info.curve));
+            bare_usart_send_string(" SEG ");
+            bare_usart_send_uint(info.segment + 1U);
+            bare_usart_send_string("/");
+            bare_usart_send_uint(info.segments);
+            bare_usart_send_string(" LEVEL ");
+            bare_usart_send_uint(info.level);
+            bare_usart_send_string("\r");
+        }
+
+        const Anim_Stats_t *stats = anim_get_stats();
+        bare_usart_send_string("\nTICK CYCLES ");
+        bare_usart_send_uint(stats->last_cycles);
+        bare_usart_send_string(" (MAX ");
+        bare_usart_send_uint(stats->max_cycles);
+        bare_usart_send_string("), PER CHANNEL ");
+        bare_usart_send_uint(stats->cycles_per_channel);
+        bare_usart_send_string("\r");
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the WS2812 strip on PA6
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "STRIP LEN <1-300>"          → Sets the number of pixels
+ * - "STRIP FILL <r> <g> <b>"     → Fills the strip with one color (0-255 each)
+ * - "STRIP SET <i> <r> <g> <b>"  → Sets one pixel (only pixels 0 to i are resent)
+ * - "STRIP STATUS"               → Frames sent, DMA errors and refill ISR cycles
+ *******************************************************************************************/
+void strip_process_cmd(const char *cmd)
+{
+    if (strncmp(cmd, "STRIP LEN ", 10) == 0)
+    {
+        int len = atoi(&cmd[10]);
+        if (len < 1 || len > (int)WS2812_MAX_PIXELS)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID LENGTH (1-300)\r");
+            return;
+        }
+        ws2812_set_length((uint32_t)len);
+        reply_ack("\nSTRIP LENGTH SET\r");
+    }
+    else if (strncmp(cmd, "STRIP FILL ", 11) == 0)
+    {
+        char *end;
+        unsigned long r = strtoul(&cmd[11], &end, 10);
+        unsigned long g = strtoul(end, &end, 10);
+        unsigned long b = strtoul(end, &end, 10);
+        if (*end != '\0' || r > 255UL || g > 255UL || b > 255UL)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID COLOR (0-255 0-255 0-255)\r");
+            return;
+        }
+
+        ws2812_fill((uint8_t)r, (uint8_t)g, (uint8_t)b);
+        fb_strip_mark(FB_STRIP_WS2812, 0U, ws2812_get_length());
+        reply_ack("\nSTRIP UPDATED\r");
+    }
+    else if (strncmp(cmd, "STRIP SET ", 10) == 0)
+    {
+        char *end;
+        unsigned long i = strtoul(&cmd[10], &end, 10);
+        unsigned long r = strtoul(end, &end, 10);
+        unsigned long g = strtoul(end, &end, 10);
+        unsigned long b = strtoul(end, &end, 10);
+        if (*end != '\0' || i >= ws2812_get_length() || r > 255UL || g > 255UL || b > 255UL)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID PIXEL (<index> 0-255 0-255 0-255)\r");
+            return;
+        }
+
+        ws2812_set_pixel((uint32_t)i, (uint8_t)r, (uint8_t)g, (uint8_t)b);
+        fb_strip_mark(FB_STRIP_WS2812, (uint32_t)i, 1U);
+        reply_ack("\nSTRIP UPDATED\r");
+    }
+    else if (strcmp(cmd, "STRIP STATUS") == 0)
+    {
+        const WS2812_Stats_t *stats = ws2812_get_stats();
+        bare_usart_send_string("\nPIXELS ");
+        bare_usart_send_uint(ws2812_get_length());
+        bare_usart_send_string(" FRAMES ");
+        bare_usart_send_uint(stats->frames);
+        bare_usart_send_string(" ERRORS ");
+        bare_usart_send_uint(stats->dma_errors);
+        bare_usart_send_string("\r\nREFILL ISR CYCLES ");
+        bare_usart_send_uint(stats->isr_last_cycles);
+        bare_usart_send_string(" (MAX ");
+        bare_usart_send_uint(stats->isr_max_cycles);
+        bare_usart_send_string(") PER ");
+        bare_usart_send_uint(WS2812_HALF_PIXELS);
+        bare_usart_send_string(" PIXELS\r");
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the APA102/SK9822 strip on SPI1
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "APA LEN <1-256>"               → Sets the number of pixels
+ * - "APA FILL <r> <g> <b> <0-31>"   → Fills the strip with one color and brightness
+ * - "APA SET <i> <r> <g> <b> <0-31>" → Sets one pixel (only pixels 0 to i are resent)
+ * - "APA STATUS"                    → Frames sent, frame size and transfer time
+ *******************************************************************************************/
+void apa_process_cmd(const char *cmd)
+{
+    if (strncmp(cmd, "APA LEN ", 8) == 0)
+    {
+        int len = atoi(&cmd[8]);
+        if (len < 1 || len > (int)APA102_MAX_PIXELS)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID LENGTH (1-256)\r");
+            return;
+        }
+        apa102_set_length((uint32_t)len);
+        reply_ack("\nSTRIP LENGTH SET\r");
+    }
+    else if (strncmp(cmd, "APA FILL ", 9) == 0)
+    {
+        char *end;
+        unsigned long r = strtoul(&cmd[9], &end, 10);
+        unsigned long g = strtoul(end, &end, 10);
+        unsigned long b = strtoul(end, &end, 10);
+        unsigned long br = strtoul(end, &end, 10);
+        if (*end != '\0' || r > 255UL || g > 255UL || b > 255UL || br > APA102_BRIGHTNESS_MAX)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID COLOR (0-255 0-255 0-255 0-31)\r");
+            return;
+        }
+
+        apa102_fill((uint8_t)r, (uint8_t)g, (uint8_t)b, (uint8_t)br);
+        fb_strip_mark(FB_STRIP_APA102, 0U, apa102_get_length());
+        reply_ack("\nSTRIP UPDATED\r");
+    }
+    else if (strncmp(cmd, "APA SET ", 8) == 0)
+    {
+        char *end;
+        unsigned long i = strtoul(&cmd[8], &end, 10);
+        unsigned long r = strtoul(end, &end, 10);
+        unsigned long g = strtoul(end, &end, 10);
+        unsigned long b = strtoul(end, &end, 10);
+        unsigned long br = strtoul(end, &end, 10);
+        if (*end != '\0' || i >= apa102_get_length() || r > 255UL || g > 255UL || b > 255UL ||
+            br > APA102_BRIGHTNESS_MAX)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID PIXEL (<index> 0-255 0-255 0-255 0-31)\r");
+            return;
+        }
+
+        apa102_set_pixel((uint32_t)i, (uint8_t)r, (uint8_t)g, (uint8_t)b, (uint8_t)br);
+        fb_strip_mark(FB_STRIP_APA102, (uint32_t)i, 1U);
+        reply_ack("\nSTRIP UPDATED\r");
+    }
+    else if (strcmp(cmd, "APA STATUS") == 0)
+    {
+        const APA102_Stats_t *stats = apa102_get_stats();
+        bare_usart_send_string("\nPIXELS ");
+        bare_usart_send_uint(apa102_get_length());
+        bare_usart_send_string(" FRAMES ");
+        bare_usart_send_uint(stats->frames);
+        bare_usart_send_string(" BYTES ");
+        bare_usart_send_uint(stats->bytes);
+        bare_usart_send_string("\r\nFRAME TIME ");
+        bare_usart_send_uint(stats->frame_cycles / (DWT_CPU_FREQ_HZ / 1000000UL));
+        bare_usart_send_string(" US\r");
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the LED frame buffer
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "FB STATS" → Commits, register writes and strip bytes, total and for the last frame
+ * - "FB RESET" → Clears the counters
+ *******************************************************************************************/
+void fb_process_cmd(const char *cmd)
+{
+    if (strcmp(cmd, "FB STATS") == 0)
+    {
+        const Fb_Stats_t *stats = fb_get_stats();
+        bare_usart_send_string("\nCOMMITS ");
+        bare_usart_send_uint(stats->commits);
+        bare_usart_send_string(" (CLEAN ");
+        bare_usart_send_uint(stats->clean_commits);
+        bare_usart_send_string(")\r\nREGISTERS ");
+        bare_usart_send_uint(stats->registers);
+        bare_usart_send_string(" (SKIPPED ");
+        bare_usart_send_uint(stats->registers_skipped);
+        bare_usart_send_string(") BYTES ");
+        bare_usart_send_uint(stats->bytes);
+        bare_usart_send_string("\r\nLAST FRAME REGISTERS ");
+        bare_usart_send_uint(stats->last_registers);
+        bare_usart_send_string(" BYTES ");
+        bare_usart_send_uint(stats->last_bytes);
+        bare_usart_send_string("\r");
+    }
+    else if (strcmp(cmd, "FB RESET") == 0)
+    {
+        fb_reset_stats();
+        reply_ack("\nFB COUNTERS CLEARED\r");
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the event trace
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "TRACE DUMP"     → Streams the ring (decode with tools/trace_decode.py)
+ * - "TRACE ON/OFF"   → Starts or freezes recording
+ * - "TRACE CLEAR"    → Discards every recorded event
+ *******************************************************************************************/
+void trace_process_cmd(const char *cmd)
+{
+    if (strcmp(cmd, "TRACE DUMP") == 0)
+    {
+        trace_dump();
+    }
+    else if (strcmp(cmd, "TRACE ON") == 0)
+    {
+        trace_enable(1);
+        reply_ack("\nTRACE ON\r");
+    }
+    else if (strcmp(cmd, "TRACE OFF") == 0)
+    {
+        trace_enable(0);
+        reply_ack("\nTRACE OFF\r");
+    }
+    else if (strcmp(cmd, "TRACE CLEAR") == 0)
+    {
+        trace_clear();
+        reply_ack("\nTRACE CLEARED\r");
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Parse and execute UART commands for the post-mortem crash record
+ *
+ * @param   cmd   Null-terminated command string from terminal input
+ *
+ * @details
+ * - "CRASH"       → Prints the fault recorded before the last reset
+ * - "CRASH CLEAR" → Forgets the record
+ * - "CRASH TEST"  → Executes an undefined instruction (UsageFault, then reset)
+ *******************************************************************************************/
+void crash_process_cmd(const char *cmd)
+{
+    if (strcmp(cmd, "CRASH") == 0)
+    {
+        crash_report();
+    }
+    else if (strcmp(cmd, "CRASH CLEAR") == 0)
+    {
+        crash_clear();
+        reply_ack("\nCRASH RECORD CLEARED\r");
+    }
+    else if (strcmp(cmd, "CRASH TEST") == 0)
+    {
+        crash_test();
+    }
+    else
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+}
+
+/*******************************************************************************************
+ * @brief   Print stack and static pool high-water marks ("MEM")
+ *
+ * @details
+ * Every line is "<name> <peak used>/<size>": the main stack (main() and ISRs), each task
+ * stack, the event loop queues, each terminal's USART TX ring and the effect instance pool.
+ *******************************************************************************************/
+void mem_cmd(void)
+{
+    bare_usart_send_string("\nMSP STACK ");
+    bare_usart_send_uint(stack_check_main_high_water());
+    bare_usart_send_char('/');
+    bare_usart_send_uint(stack_check_main_size());
+    bare_usart_send_string(" BYTES");
+
+    const Kernel_TCB_t *task;
+    for (uint32_t i = 0; (task = kernel_get_task(i)) != NULL; i++)
+    {
+        bare_usart_send_string("\r\nTASK ");
+        bare_usart_send_string(task->name);
+        bare_usart_send_char(' ');
+        bare_usart_send_uint(stack_check_high_water(task->stack_base, task->stack_words));
+        bare_usart_send_char('/');
+        bare_usart_send_uint(task->stack_words * 4U);
+        bare_usart_send_string(" BYTES");
+    }
+
+    for (uint32_t prio = 0; prio < EVT_PRIO_COUNT; prio++)
+    {
+        uint32_t max_depth;
+        (void)event_loop_get_depth((Event_Priority_t)prio, &max_depth);
+        bare_usart_send_string("\r\nEVENT QUEUE ");
+        bare_usart_send_uint(prio);
+        bare_usart_send_char(' ');
+        bare_usart_send_uint(max_depth);
+        bare_usart_send_char('/');
+        bare_usart_send_uint(EVENT_QUEUE_SIZE);
+    }
+
+    for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+    {
+        bare_usart_send_string("\r\n");
+        bare_usart_send_string(sessions[i].usart->name);
+        bare_usart_send_string(" TX RING ");
+        bare_usart_send_uint(bare_usart_tx_high_water(sessions[i].usart));
+        bare_usart_send_char('/');
+        bare_usart_send_uint(sessions[i].usart->tx_mask);
+    }
+    bare_usart_send_string("\r\nFX POOL ");
+    bare_usart_send_uint(fx_high_water());
+    bare_usart_send_char('/');
+    bare_usart_send_uint(FX_MAX_INSTANCES);
+    bare_usart_send_string("\r");
+}
+
+/*******************************************************************************************
+ * @brief   Print the event loop statistics per event type ("EVENTS")
+ *
+ * @details
+ * One line per type: events posted and dropped (queue full), handler runs, and the last,
+ * longest and average handler time in cycles. The average is taken over the running total,
+ * which wraps after 2^32 cycles.
  *******************************************************************************************/
-void usart_terminal_init(void)
+void events_cmd(void)
+{
+    static const char *const type_name[EVT_TYPE_COUNT] = {"TIMER", "RX LINE", "TX DONE",
+                                                          "RX FRAME"};
+
+    for (uint32_t i = 0; i < EVT_TYPE_COUNT; i++)
+    {
+        const Event_Stats_t *st = event_loop_get_stats((Event_Type_t)i);
+        uint32_t avg = (st->dispatched != 0U) ? st->total_cycles / st->dispatched : 0U;
+        bare_usart_send_fmt("%s%-8s POSTED %" PRIu32 " DROPPED %" PRIu32 " RUNS %" PRIu32,
+                            (i == 0U) ? "\n" : "\r\n", type_name[i], st->posted, st->dropped,
+                            st->dispatched);
+        bare_usart_send_fmt(" LAST %" PRIu32 " MAX %" PRIu32 " AVG %" PRIu32 " CYCLES",
+                            st->last_cycles, st->max_cycles, avg);
+    }
+    bare_usart_send_string("\r");
+}
+
+/**
+ * @brief  Print a cycle count as a percentage of a window with two decimals.
+ */
+static void send_share(uint32_t cycles, uint32_t elapsed)
 {
-    bare_usart_init();         // Initialize USART2 on PA2/PA3
-    bare_usart_clear_screen(); // Clear terminal (ANSI escape)
-    bare_usart_send_string("STM32 Terminal ready. Type commands:\r\n> ");
+    uint32_t unit = elapsed / 10000U; // Cycles per 0.01 %
+    send_centi((unit != 0U) ? cycles / unit : 0U);
+    bare_usart_send_char('%');
 }
 
 /*******************************************************************************************
- * @brief   Initialize PC5 for user-controlled LED output
+ * @brief   Print CPU load over the last 1 s and 10 s ("PERF")
  *
  * @details
- * Configures GPIOC Pin 5 as push-pull output with low speed and no pull resistors.
- * This pin is toggled by UART commands such as "LED1 ON" or "LED1 TOGGLE".
+ * BOOT is the time from reset to main() measured by Reset_Handler. SWITCH is the PendSV
+ * context switch cost, last and worst, and the number of switches.
+ * BUSY is every cycle outside the idle task's WFI. Each interrupt line is its share of
+ * the window, inclusive of higher-priority interrupts that preempted it. TASKS is the
+ * busy time left after the interrupts: the effects and terminal tasks plus PendSV.
  *******************************************************************************************/
-void led1_init(void)
+void perf_cmd(void)
 {
-    bare_gpio_init(GPIOC, GPIO_PIN5, GPIO_MODE_OUTPUT,
-                   GPIO_OTYPE_PP, GPIO_SPEED_LOW, GPIO_NOPULL);
+    Perf_Window_t w1;
+    Perf_Window_t w10;
+    perf_get_window(1U, &w1);
+    perf_get_window(PERF_HISTORY_SECONDS, &w10);
+
+    bare_usart_send_string("\nBOOT     ");
+    bare_usart_send_uint(perf_boot_cycles);
+    bare_usart_send_string(" CYCLES ");
+    bare_usart_send_uint(perf_boot_cycles / (DWT_CPU_FREQ_HZ / 1000000UL));
+    bare_usart_send_string(" US\r");
+
+    const Kernel_Stats_t *ks = kernel_get_stats();
+    bare_usart_send_fmt("\nSWITCH   LAST %" PRIu32 " MAX %" PRIu32 " CYCLES, %" PRIu32
+                        " SWITCHES\r",
+                        ks->last_switch_cycles, ks->max_switch_cycles, ks->switches);
+
+    if (w1.seconds == 0U)
+    {
+        bare_usart_send_string("\nNO COMPLETE WINDOW YET\r");
+        return;
+    }
+
+    bare_usart_send_string("\nWINDOW      1 S   ");
+    bare_usart_send_uint(w10.seconds);
+    bare_usart_send_string(" S\r\nBUSY     ");
+    send_share(w1.elapsed - w1.idle, w1.elapsed);
+    bare_usart_send_string(" ");
+    send_share(w10.elapsed - w10.idle, w10.elapsed);
+
+    uint32_t isr1 = 0;
+    uint32_t isr10 = 0;
+    for (uint32_t i = 0; i < PERF_SRC_COUNT; i++)
+    {
+        bare_usart_send_string("\r\n");
+        bare_usart_send_string(perf_source_name((Perf_Source_t)i));
+        bare_usart_send_string(" ");
+        send_share(w1.isr[i], w1.elapsed);
+        bare_usart_send_string(" ");
+        send_share(w10.isr[i], w10.elapsed);
+        isr1 += w1.isr[i];
+        isr10 += w10.isr[i];
+    }
+
+    uint32_t busy1 = w1.elapsed - w1.idle;
+    uint32_t busy10 = w10.elapsed - w10.idle;
+    bare_usart_send_string("\r\nTASKS    ");
+    send_share((busy1 > isr1) ? busy1 - isr1 : 0U, w1.elapsed);
+    bare_usart_send_string(" ");
+    send_share((busy10 > isr10) ? busy10 - isr10 : 0U, w10.elapsed);
+    bare_usart_send_string("\r");
 }
 
 /*******************************************************************************************
- * @brief   Initialize user LED on PB6 as GPIO lternate function for TIM4 Channel 1 PWM.
+ * @brief   Print the memory pool and scratch arena counters ("POOL")
  *
  * @details
- * Configures GPIOB Pin 6 as alternate function (AF2). This pin can be controlled via PWM
- * via command or from within your embedded application logic.
+ * One line per pool: "<name> <in use>/<capacity> x <block> B PEAK <n> ALLOCS <n> FAILS <n>",
+ * then the scratch arena in bytes. FAILS counts allocations refused for lack of space.
  *******************************************************************************************/
-void led2_init(void)
+void pool_cmd(void)
 {
-    bare_gpio_AF(GPIOB, GPIO_PIN6, AF2);
-    bare_tim2_5_PWM(TIM4);
+    const Mem_Pool_t *pool;
+    bare_usart_send_string("\n");
+    for (uint32_t i = 0; (pool = mem_pool_get(i)) != NULL; i++)
+    {
+        bare_usart_send_string(pool->name);
+        bare_usart_send_char(' ');
+        bare_usart_send_uint(mem_pool_in_use(pool));
+        bare_usart_send_char('/');
+        bare_usart_send_uint(pool->capacity);
+        bare_usart_send_string(" x ");
+        bare_usart_send_uint(pool->block_size);
+        bare_usart_send_string(" B PEAK ");
+        bare_usart_send_uint(pool->high_water);
+        bare_usart_send_string(" ALLOCS ");
+        bare_usart_send_uint(pool->allocs);
+        bare_usart_send_string(" FAILS ");
+        bare_usart_send_uint(pool->exhausted);
+        bare_usart_send_string("\r\n");
+    }
+
+    const Mem_Arena_t *arena = mem_scratch();
+    bare_usart_send_string(arena->name);
+    bare_usart_send_char(' ');
+    bare_usart_send_uint(arena->used);
+    bare_usart_send_char('/');
+    bare_usart_send_uint(arena->size);
+    bare_usart_send_string(" B PEAK ");
+    bare_usart_send_uint(arena->high_water);
+    bare_usart_send_string(" ALLOCS ");
+    bare_usart_send_uint(arena->allocs);
+    bare_usart_send_string(" FAILS ");
+    bare_usart_send_uint(arena->exhausted);
+    bare_usart_send_string("\r");
 }
 
 /*******************************************************************************************
- * @brief   Parse and execute UART commands for LED1
+ * @brief   Print the command terminals ("TERM")
  *
- * @param   cmd   Null-terminated command string from terminal input
+ * @details
+ * One line per terminal: "<usart> <baud> BAUD CMDS <n> TX BURSTS <n> PEAK <n>/<ring>"
+ * followed by the binary protocol counters "FRAMES <n> OPS <n> NAKS <n> DROPPED <n>".
+ * The terminal that issued the command is marked with '*'. Closed terminals print
+ * "CLOSED".
+ *******************************************************************************************/
+void term_cmd(void)
+{
+    for (uint32_t i = 0; i < TERMINAL_SESSIONS; i++)
+    {
+        const Terminal_Session_t *s = &sessions[i];
+        bare_usart_send_fmt("%s%c%s", (i == 0U) ? "\n" : "\r\n",
+                            (s->usart == bare_usart_get_console()) ? '*' : ' ', s->usart->name);
+        if (s->usart->regs == NULL)
+        {
+            bare_usart_send_string(" CLOSED");
+            continue;
+        }
+        bare_usart_send_fmt(" %" PRIu32 " BAUD CMDS %" PRIu32 " TX BURSTS %" PRIu32
+                            " PEAK %" PRIu32 "/%" PRIu32,
+                            s->usart->baud, s->commands, s->tx_bursts,
+                            (uint32_t)bare_usart_tx_high_water(s->usart),
+                            (uint32_t)s->usart->tx_mask);
+        bare_usart_send_fmt(" FRAMES %" PRIu32 " OPS %" PRIu32 " NAKS %" PRIu32
+                            " DROPPED %" PRIu32 "%s",
+                            s->proto.frames, s->proto.ops, s->proto.errors, s->frames_dropped,
+                            s->compact ? " COMPACT" : "");
+    }
+    bare_usart_send_string("\r");
+}
+
+/*******************************************************************************************
+ * @brief   Print the flash image check ("IMAGE")
  *
  * @details
- * Supports commands to control GPIOC Pin 5 (user LED):
- * - "LED1 ON"      → Sets PC5 high
- * - "LED1 OFF"     → Sets PC5 low
- * - "LED1 TOGGLE"  → Inverts PC5
- * Unrecognized commands print a default error message.
+ * Range, computed and stored CRC, outcome and how long the DMA-fed check took.
  *******************************************************************************************/
-void led1_process_cmd(const char *cmd)
+void image_cmd(void)
 {
-    if (strcmp(cmd, "LED1 ON") == 0)
+    static const char *const status_name[] = {"IDLE", "RUNNING", "OK", "MISMATCH", "UNPATCHED",
+                                              "ERROR"};
+    const Image_Check_t *img = image_check_get();
+
+    bare_usart_send_fmt("\nIMAGE 0x%08" PRIX32 " %" PRIu32 " BYTES\r\nCRC 0x%08" PRIX32
+                        " STORED 0x%08" PRIX32 " %s",
+                        img->start, img->bytes, img->computed, img->stored,
+                        status_name[img->status]);
+    if (img->status != IMAGE_CHECK_RUNNING)
     {
-        bare_gpio_write(GPIOC, GPIO_PIN5, GPIO_PIN_SET);
-        bare_usart_send_string("\nLED1 turned ON\r");
+        bare_usart_send_fmt("\r\nCHECKED IN %" PRIu32 " US",
+                            (uint32_t)(img->cycles / (DWT_CPU_FREQ_HZ / 1000000UL)));
     }
-    else if (strcmp(cmd, "LED1 OFF") == 0)
+    bare_usart_send_string("\r");
+}
+
+/*******************************************************************************************
+ * @brief   Show or switch the issuing terminal's response mode ("MODE")
+ *
+ * @details
+ * The switch applies from the reply of this command on: "MODE COMPACT" is answered with
+ * a status code only, "MODE TEXT" with the prompt.
+ *******************************************************************************************/
+void mode_cmd(const char *cmd)
+{
+    Terminal_Session_t *s = reply_session;
+
+    if (s == NULL)
     {
-        bare_gpio_write(GPIOC, GPIO_PIN5, GPIO_PIN_RESET);
-        bare_usart_send_string("\nLED1 turned OFF\r");
+        reply_error(REPLY_FAILED, "\nNOT A TERMINAL\r");
     }
-    else if (strcmp(cmd, "LED1 TOGGLE") == 0)
+    else if (strcmp(cmd, "MODE") == 0)
     {
-        bare_gpio_toggle(GPIOC, GPIO_PIN5);
-        bare_usart_send_string("\nLED1 TOGGLED\r");
+        bare_usart_send_string(s->compact ? "\nMODE COMPACT\r" : "\nMODE TEXT\r");
     }
-    else if (strcmp(cmd, "LED1 STATUS") == 0)
+    else if (strcmp(cmd, "MODE COMPACT") == 0)
     {
-        check_led1_state(GPIOC, GPIO_PIN5);
+        s->compact = 1;
+    }
+    else if (strcmp(cmd, "MODE TEXT") == 0)
+    {
+        s->compact = 0;
+        reply_ack("\nMODE TEXT\r");
     }
     else
     {
-        bare_usart_send_string("\nUNKNOWN COMMAND\r");
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
     }
 }
 
-void led2_process_cmd(const char *cmd)
+/*******************************************************************************************
+ * @brief   Show or change the issuing terminal's baud rate ("BAUD")
+ *
+ * @details
+ * The switch itself happens in the line handler after the reply and the prompt have been
+ * sent: the host then changes its own rate and presses Enter. See terminal_baud_switch().
+ *******************************************************************************************/
+void baud_cmd(const char *cmd)
 {
-    if (strncmp(cmd, "LED2 PWM ", 9) == 0)
+    Terminal_Session_t *s = reply_session;
+
+    if (s == NULL)
+    {
+        reply_error(REPLY_FAILED, "\nNOT A TERMINAL\r");
+    }
+    else if (strcmp(cmd, "BAUD") == 0)
+    {
+        bare_usart_send_string("\nBAUD ");
+        bare_usart_send_uint(s->usart->baud);
+        bare_usart_send_string(" (ACTUAL ");
+        bare_usart_send_uint(bare_usart_actual_baud(s->usart->baud));
+        bare_usart_send_string(")\r");
+    }
+    else if (strcmp(cmd, "BAUD AUTO") == 0)
     {
-        uint8_t duty = (uint8_t)atoi(&cmd[9]);
-        if (duty <= 100 && duty >= 0)
+        reply_ack("\nBAUD AUTO, PRESS ENTER UNTIL THE RATE IS REPORTED\r");
+        s->baud_state = TERM_BAUD_HUNT;
+    }
+    else if (strncmp(cmd, "BAUD ", 5) == 0)
+    {
+        char *end;
+        unsigned long baud = strtoul(&cmd[5], &end, 10);
+        uint32_t actual = 0;
+        if (end != &cmd[5] && *end == '\0' && baud >= BARE_USART_BAUD_MIN &&
+            baud <= BARE_USART_BAUD_MAX)
         {
-            bare_pwm_set_duty(TIM4, duty);
-            bare_usart_send_string("\nLED2 PWM MODIFIED\r");
+            actual = bare_usart_actual_baud((uint32_t)baud); // 0 if too far off the divider
         }
-        else
+        if (actual == 0U)
         {
-            bare_usart_send_string("\nINVALID PWM VALUE (0%-100%)\r");
+            reply_error(REPLY_INVALID, "\nINVALID BAUD (");
+            bare_usart_send_uint(BARE_USART_BAUD_MIN);
+            bare_usart_send_char('-');
+            bare_usart_send_uint(BARE_USART_BAUD_MAX);
+            bare_usart_send_string(", WITHIN ");
+            send_centi(BARE_USART_BAUD_TOLERANCE * 10U);
+            bare_usart_send_string("%)\r");
+            return;
         }
+        bare_usart_send_string("\nBAUD ");
+        bare_usart_send_uint((uint32_t)baud);
+        bare_usart_send_string(" (ACTUAL ");
+        bare_usart_send_uint(actual);
+        bare_usart_send_string(") AFTER THIS REPLY, PRESS ENTER AT THE NEW RATE\r");
+        s->baud_next = (uint32_t)baud;
+        s->baud_state = TERM_BAUD_SWITCH;
     }
     else
     {
-        bare_usart_send_string("\nUNKNOWN COMMAND\r");
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
     }
 }
 
-void led3_process_cmd(const char *cmd)
+/*******************************************************************************************
+ * @brief   Subscribe the issuing terminal to state pushes ("SUBSCRIBE", "UNSUBSCRIBE")
+ *
+ * @details
+ * The host no longer polls: terminal_notify() compares shadow state every timer tick and
+ * pushes what changed or is due. A new subscription is due at once, so its first push
+ * follows this reply and gives the host the starting state.
+ *******************************************************************************************/
+void subscribe_cmd(const char *cmd)
 {
-    /***********Incomplete************/
+    Terminal_Session_t *s = reply_session;
+    uint8_t on = (cmd[0] == 'S');
+    const char *arg = &cmd[on ? 9 : 11];
+    uint32_t first = 0;
+    uint32_t last = TERM_TOPIC_COUNT;
+    unsigned long period = 0;
+
+    if (s == NULL)
+    {
+        reply_error(REPLY_FAILED, "\nNOT A TERMINAL\r");
+        return;
+    }
+    if (on && *arg == '\0')
+    {
+        uint8_t any = 0;
+        for (uint32_t t = 0; t < TERM_TOPIC_COUNT; t++)
+        {
+            const Terminal_Sub_t *sub = &s->subs[t];
+            if (sub->active)
+            {
+                bare_usart_send_fmt("%s%s ", any ? "\r\n" : "\n", topic_name[t]);
+                if (sub->period_ms != 0U)
+                {
+                    bare_usart_send_fmt("EVERY %u MS", (unsigned int)sub->period_ms);
+                }
+                else
+                {
+                    bare_usart_send_string("ON CHANGE");
+                }
+                any = 1;
+            }
+        }
+        bare_usart_send_string(any ? "\r" : "\nNO SUBSCRIPTIONS\r");
+        return;
+    }
+
+    if (*arg == ' ')
+    {
+        arg++;
+        size_t len = strcspn(arg, " ");
+        for (first = 0; first < TERM_TOPIC_COUNT; first++)
+        {
+            if (strlen(topic_name[first]) == len && strncmp(arg, topic_name[first], len) == 0)
+            {
+                break;
+            }
+        }
+        if (first < TERM_TOPIC_COUNT)
+        {
+            last = first + 1U;
+        }
+        else if (len == 3U && strncmp(arg, "ALL", 3) == 0)
+        {
+            first = 0;
+        }
+        else
+        {
+            reply_error(REPLY_INVALID, "\nUNKNOWN TOPIC (LED1, LED2, COUNTERS, ALL)\r");
+            return;
+        }
+        arg += len;
+    }
+    else if (*arg != '\0')
+    {
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+        return;
+    }
+    else if (on)
+    {
+        reply_error(REPLY_INVALID, "\nMISSING TOPIC\r");
+        return;
+    }
+
+    if (*arg == ' ' && on)
+    {
+        char *end;
+        period = strtoul(&arg[1], &end, 10);
+        if (end == &arg[1] || *end != '\0' || period < TERMINAL_NOTIFY_MIN_MS ||
+            period > TERMINAL_NOTIFY_MAX_MS)
+        {
+            reply_error(REPLY_INVALID, "\nINVALID PERIOD (");
+            bare_usart_send_fmt("%u-%u MS)\r", TERMINAL_NOTIFY_MIN_MS, TERMINAL_NOTIFY_MAX_MS);
+            return;
+        }
+    }
+    else if (*arg != '\0')
+    {
+        reply_error(REPLY_INVALID, "\nINVALID ARGUMENT\r");
+        return;
+    }
+
+    uint32_t now = SysTick_Get_Ticks();
+    for (uint32_t t = first; t < last; t++)
+    {
+        Terminal_Sub_t *sub = &s->subs[t];
+        sub->active = on;
+        sub->primed = 0;
+        sub->period_ms = (uint16_t)period;
+        sub->next_tick = now;
+    }
+    reply_ack(on ? "\nSUBSCRIBED\r" : "\nUNSUBSCRIBED\r");
 }
 
 /**
@@ -139,11 +1605,93 @@ void led3_process_cmd(const char *cmd)
  *
  * @details
  * Parses recognized commands and performs the corresponding hardware control. Unrecognized
- * commands print a default error message.
+ * commands print a default error message. Changes made by the command are committed to
+ * the hardware before the prompt is printed, and scratch arena buffers are released. The
+ * dispatch and the event loop queue depths are recorded in the event trace.
  */
 void process_cmd(const char *cmd)
 {
-    if (cmd[3] == '1')
+    uint32_t tag = 0;
+    for (uint32_t i = 0; i < 3U && cmd[i] != '\0'; i++)
+    {
+        tag |= (uint32_t)(uint8_t)cmd[i] << (16U - 8U * i); // First 3 characters
+    }
+    trace_event(TRACE_EVT_CMD_START, tag);
+    Bare_USART_t *reply = bare_usart_get_console();
+    bare_usart_tx_hold(reply); // Reply and prompt leave as one transmission
+    reply_session = terminal_session_of(reply);
+    reply_status = REPLY_OK;
+    for (uint32_t prio = 0; prio < EVT_PRIO_COUNT; prio++)
+    {
+        uint32_t depth = event_loop_get_depth((Event_Priority_t)prio, NULL);
+        trace_event(TRACE_EVT_QUEUE, (prio << 16) | depth);
+    }
+
+    if (strncmp(cmd, "ANIM ", 5) == 0)
+    {
+        anim_process_cmd(cmd); // Execute command
+    }
+    else if (strcmp(cmd, "DSP BENCH") == 0)
+    {
+        dsp_bench_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "MEM") == 0)
+    {
+        mem_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "EVENTS") == 0)
+    {
+        events_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "PERF") == 0)
+    {
+        perf_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "POOL") == 0)
+    {
+        pool_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "TERM") == 0)
+    {
+        term_cmd(); // Execute command
+    }
+    else if (strcmp(cmd, "IMAGE") == 0)
+    {
+        image_cmd(); // Execute command
+    }
+    else if (strncmp(cmd, "MODE", 4) == 0)
+    {
+        mode_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "BAUD", 4) == 0)
+    {
+        baud_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "SUBSCRIBE", 9) == 0 || strncmp(cmd, "UNSUBSCRIBE", 11) == 0)
+    {
+        subscribe_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "STRIP ", 6) == 0)
+    {
+        strip_process_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "APA ", 4) == 0)
+    {
+        apa_process_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "FB ", 3) == 0)
+    {
+        fb_process_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "TRACE ", 6) == 0)
+    {
+        trace_process_cmd(cmd); // Execute command
+    }
+    else if (strncmp(cmd, "CRASH", 5) == 0)
+    {
+        crash_process_cmd(cmd); // Execute command
+    }
+    else if (cmd[3] == '1')
     {
         led1_process_cmd(cmd); // Execute command
     }
@@ -157,10 +1705,28 @@ void process_cmd(const char *cmd)
     }
     else
     {
-        bare_usart_send_string("\nUNKNOWN COMMAND\r");
+        reply_error(REPLY_UNKNOWN, "\nUNKNOWN COMMAND\r");
+    }
+
+    fb_commit(); // Push what the command changed
+
+    mem_arena_reset(mem_scratch()); // Command-lifetime buffers end here
+
+    bare_usart_set_console(reply); // reply_error() silences the rest of a compact reply
+    if (reply_session != NULL && reply_session->compact)
+    {
+        bare_usart_send_fmt("\n%u\r", (unsigned int)reply_status); // Status code, no prompt
+    }
+    else
+    {
+        bare_usart_send_string("\r\n> "); // Prompt for next command
     }
+    bare_usart_tx_release(reply);
+    reply_session = NULL;
 
-    bare_usart_send_string("\r\n> "); // Prompt for next command
+    fx_signal(FX_EVT_COMMAND); // Wake FLASH effects
+
+    trace_event(TRACE_EVT_CMD_END, 0U);
 }
 
 /**
@@ -184,3 +1750,153 @@ void check_led1_state(GPIO_TypeDef *GPIOx, GPIO_Pins_t pin)
         bare_usart_send_string("\nLED1 OFF\r");
     }
 }
+
+/**
+ * @brief  Replace the effect running on an output with a new one.
+ *
+ * @param type    Effect script to start
+ * @param out     Output driven by the effect
+ * @param arg     Null-terminated period argument in ms (1-FX_PERIOD_MAX)
+ * @details
+ * Prints "EFFECT STARTED", "INVALID PERIOD (1-32767 ms)" or "NO FREE EFFECT SLOT".
+ */
+void start_effect_cmd(Fx_Type_t type, LED_Output_t out, const char *arg)
+{
+    int period = atoi(arg);
+    if (period < 1 || period > (int)FX_PERIOD_MAX)
+    {
+        reply_error(REPLY_INVALID, "\nINVALID PERIOD (1-32767 ms)\r");
+        return;
+    }
+
+    release_output(out);
+    if (fx_start(type, out, (uint16_t)period) < 0)
+    {
+        reply_error(REPLY_FAILED, "\nNO FREE EFFECT SLOT\r");
+    }
+    else
+    {
+        reply_ack("\nEFFECT STARTED\r");
+    }
+}
+
+/**
+ * @brief  Parse an output name at the start of a command argument.
+ *
+ * @param arg     Argument text, "LED1" or "LED2" followed by a space or the end
+ * @param out     Set to the matching output
+ * @return 0 on success, -1 if the name is not an output
+ */
+int parse_output(const char *arg, LED_Output_t *out)
+{
+    if (strncmp(arg, "LED", 3) != 0 || (arg[4] != ' ' && arg[4] != '\0'))
+    {
+        return -1;
+    }
+
+    if (arg[3] == '1')
+    {
+        *out = LED_OUT_LED1;
+    }
+    else if (arg[3] == '2')
+    {
+        *out = LED_OUT_LED2;
+    }
+    else
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  Stop every effect and animation driving an output.
+ *
+ * @param out     Output handed over to a new owner
+ */
+void release_output(LED_Output_t out)
+{
+    fx_stop_output(out);
+    anim_stop(out);
+}
+
+/**
+ * @brief  Benchmark the Q15 DSP kernels and print cycles per channel.
+ *
+ * @details
+ * Prints one line per kernel: scalar and DSP cycles per channel (two decimals) and
+ * whether both versions produced identical output.
+ */
+void dsp_bench_cmd(void)
+{
+    Dsp_Bench_Result_t results[DSP_BENCH_COUNT];
+
+    if (dsp_bench_run(results) != 0)
+    {
+        reply_error(REPLY_FAILED, "\nSCRATCH ARENA FULL\r");
+        return;
+    }
+
+    bare_usart_send_string("\nKERNEL CYC/CH: SCALAR DSP (");
+    bare_usart_send_uint(DSP_BENCH_CHANNELS);
+    bare_usart_send_string(" CHANNELS)\r");
+    for (uint32_t k = 0; k < DSP_BENCH_COUNT; k++)
+    {
+        bare_usart_send_string("\n");
+        bare_usart_send_string(results[k].name);
+        bare_usart_send_string(" ");
+        send_centi(results[k].scalar_cycles * 100U / DSP_BENCH_CHANNELS);
+        bare_usart_send_string(" ");
+        send_centi(results[k].packed_cycles * 100U / DSP_BENCH_CHANNELS);
+        bare_usart_send_string(results[k].match ? " MATCH\r" : " MISMATCH\r");
+    }
+}
+
+/**
+ * @brief  Print a value given in hundredths with two decimals.
+ *
+ * @param centi   Value x 100
+ */
+void send_centi(uint32_t centi)
+{
+    bare_usart_send_fmt("%" PRIu32 ".%02" PRIu32, centi / 100U, centi % 100U);
+}
+
+/**
+ * @brief  Send an acknowledgement that carries no data (left out in compact mode).
+ *
+ * @param text   Reply line
+ */
+void reply_ack(const char *text)
+{
+    if (reply_session == NULL || !reply_session->compact)
+    {
+        bare_usart_send_string(text);
+    }
+}
+
+/**
+ * @brief  Report a failed command.
+ *
+ * @param status  Status code for compact mode (the first failure of a command is kept)
+ * @param text    Reply line, or its first part
+ *
+ * @details
+ * In compact mode the text and everything else the command sends is discarded (console
+ * NULL until process_cmd() ends); the status code is the whole reply.
+ */
+void reply_error(Reply_Status_t status, const char *text)
+{
+    if (reply_status == REPLY_OK)
+    {
+        reply_status = status;
+    }
+    if (reply_session != NULL && reply_session->compact)
+    {
+        bare_usart_set_console(NULL);
+    }
+    else
+    {
+        bare_usart_send_string(text);
+    }
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************************
+ * @file    mem_pool.c
+ * @author  ka5j
+ * @brief   Fixed-block pools and a bump arena replacing the heap (bare metal)
+ * @version 1.0
+ * @date    2025-06-25
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mem_pool.h"
+#include "bare_nvic.h"      // BASEPRI critical sections
+#include "irq_priorities.h" // CRIT_CEILING_POOL
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static Mem_Pool_t *mem_pools[MEM_MAX_POOLS]; // Listed by the diagnostics
+static uint32_t mem_pool_count;
+static Mem_Arena_t mem_scratch_arena;
+
+#ifdef HOST_BUILD
+static uint8_t mem_scratch_host[MEM_SCRATCH_HOST_BYTES] __attribute__((aligned(MEM_ARENA_ALIGN)));
+#else
+extern uint8_t _sarena[]; // Linker script: scratch arena region
+extern uint8_t _earena[];
+#endif
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Set up the scratch arena.
+ */
+void mem_init(void)
+{
+#ifdef HOST_BUILD
+    mem_arena_init(&mem_scratch_arena, "SCRATCH", mem_scratch_host, sizeof(mem_scratch_host));
+#else
+    mem_arena_init(&mem_scratch_arena, "SCRATCH", _sarena, (uint32_t)(_earena - _sarena));
+#endif
+}
+
+/**
+ * @brief  Mark every block free and list the pool.
+ * @param  pool: pool defined with MEM_POOL_DEFINE()
+ */
+void mem_pool_init(Mem_Pool_t *pool)
+{
+    // Highest index at the bottom: a fresh pool hands out block 0 first
+    for (uint32_t i = 0; i < pool->capacity; i++)
+    {
+        pool->free_stack[i] = (uint16_t)(pool->capacity - 1U - i);
+    }
+    pool->free_count = pool->capacity;
+    pool->high_water = 0;
+    pool->allocs = 0;
+    pool->exhausted = 0;
+
+    for (uint32_t i = 0; i < mem_pool_count; i++)
+    {
+        if (mem_pools[i] == pool)
+        {
+            return; // Re-initialized, already listed
+        }
+    }
+    if (mem_pool_count < MEM_MAX_POOLS)
+    {
+        mem_pools[mem_pool_count++] = pool;
+    }
+}
+
+/**
+ * @brief  Take a block.
+ * @param  pool: pool
+ * @retval Block, NULL if the pool is exhausted
+ */
+void *mem_pool_alloc(Mem_Pool_t *pool)
+{
+    void *block = NULL;
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_POOL);
+
+    if (pool->free_count == 0U)
+    {
+        pool->exhausted++;
+    }
+    else
+    {
+        block = mem_pool_block(pool, pool->free_stack[--pool->free_count]);
+        pool->allocs++;
+
+        uint16_t in_use = (uint16_t)(pool->capacity - pool->free_count);
+        if (in_use > pool->high_water)
+        {
+            pool->high_water = in_use;
+        }
+    }
+
+    bare_nvic_crit_exit(crit);
+    return block;
+}
+
+/**
+ * @brief  Return a block to its pool.
+ * @param  pool: pool
+ * @param  block: block from mem_pool_alloc()
+ */
+void mem_pool_free(Mem_Pool_t *pool, void *block)
+{
+    const uint8_t *p = block;
+    if (p < pool->blocks || p >= pool->blocks + (uint32_t)pool->capacity * pool->block_size ||
+        (uint32_t)(p - pool->blocks) % pool->block_size != 0U)
+    {
+        return; // Not a block of this pool
+    }
+
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_POOL);
+    if (pool->free_count < pool->capacity)
+    {
+        pool->free_stack[pool->free_count++] = (uint16_t)mem_pool_index(pool, block);
+    }
+    bare_nvic_crit_exit(crit);
+}
+
+/**
+ * @brief  Get the number of blocks in use.
+ * @param  pool: pool
+ * @retval Blocks in use
+ */
+uint32_t mem_pool_in_use(const Mem_Pool_t *pool)
+{
+    return (uint32_t)pool->capacity - pool->free_count;
+}
+
+/**
+ * @brief  Get a listed pool.
+ * @param  index: list position
+ * @retval Pool, NULL past the last one
+ */
+const Mem_Pool_t *mem_pool_get(uint32_t index)
+{
+    return (index < mem_pool_count) ? mem_pools[index] : NULL;
+}
+
+/**
+ * @brief  Carve an arena out of a buffer.
+ * @param  arena: arena to set up
+ * @param  name: diagnostics label
+ * @param  base: buffer (MEM_ARENA_ALIGN aligned)
+ * @param  size: bytes
+ */
+void mem_arena_init(Mem_Arena_t *arena, const char *name, void *base, uint32_t size)
+{
+    arena->name = name;
+    arena->base = base;
+    arena->size = size;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->allocs = 0;
+    arena->exhausted = 0;
+}
+
+/**
+ * @brief  Allocate from an arena.
+ * @param  arena: arena
+ * @param  size: bytes
+ * @retval Memory, NULL if the arena is full
+ */
+void *mem_arena_alloc(Mem_Arena_t *arena, uint32_t size)
+{
+    void *p = NULL;
+    uint32_t rounded = (size + (MEM_ARENA_ALIGN - 1U)) & ~(MEM_ARENA_ALIGN - 1U);
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_POOL);
+
+    if (rounded < size || rounded > arena->size - arena->used)
+    {
+        arena->exhausted++;
+    }
+    else
+    {
+        p = arena->base + arena->used;
+        arena->used += rounded;
+        arena->allocs++;
+        if (arena->used > arena->high_water)
+        {
+            arena->high_water = arena->used;
+        }
+    }
+
+    bare_nvic_crit_exit(crit);
+    return p;
+}
+
+/**
+ * @brief  Release everything allocated from an arena.
+ * @param  arena: arena
+ */
+void mem_arena_reset(Mem_Arena_t *arena)
+{
+    arena->used = 0; // Single word store, no critical section needed
+}
+
+/**
+ * @brief  Get the scratch arena.
+ * @retval Scratch arena
+ */
+Mem_Arena_t *mem_scratch(void)
+{
+    return &mem_scratch_arena;
+}
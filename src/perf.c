@@ -0,0 +1,167 @@
+/*******************************************************************************************
+ * @file    perf.c
+ * @author  ka5j
+ * @brief   CPU load accounting: idle time and per-interrupt cycles over 1 s / 10 s windows
+ * @version 1.0
+ * @date    2025-06-19
+ *
+ * @details
+ * The counters are never reset, so their owners can update them without any lock;
+ * perf_tick() keeps the values seen at the previous window boundary and stores the
+ * modulo-2^32 differences. A one-second difference stays far below 2^32 cycles.
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "perf.h"
+#include "bare_nvic.h"      // BASEPRI critical sections
+#include "irq_priorities.h" // CRIT_CEILING_KERNEL
+
+/*******************************************************************************************
+ *                                   Private Types
+ *******************************************************************************************/
+
+/**
+ * @brief One second of counter deltas
+ */
+typedef struct
+{
+    uint32_t elapsed;
+    uint32_t idle;
+    uint32_t isr[PERF_SRC_COUNT];
+} Perf_Second_t;
+
+/*******************************************************************************************
+ *                    Counters (shared with the inline ISR hooks)
+ *******************************************************************************************/
+volatile uint32_t perf_isr_cycles[PERF_SRC_COUNT];
+
+/*******************************************************************************************
+ *                   Boot Time (written by Reset_Handler before main())
+ *******************************************************************************************/
+uint32_t perf_boot_cycles;
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static volatile uint32_t perf_idle_cycles;
+
+static Perf_Second_t perf_last;                         // Counters at the last boundary
+static Perf_Second_t perf_history[PERF_HISTORY_SECONDS]; // Written in SysTick context
+static uint32_t perf_next;                               // Next history slot
+static uint32_t perf_filled;                             // Complete seconds stored
+static uint8_t perf_started;
+
+static const char *const perf_names[PERF_SRC_COUNT] = {
+    [PERF_SRC_SYSTICK] = "SYSTICK",
+    [PERF_SRC_TIM2] = "TIM2",
+    [PERF_SRC_USART2] = "USART2",
+    [PERF_SRC_USART1] = "USART1",
+    [PERF_SRC_DMA1_S2] = "DMA1 S2",
+    [PERF_SRC_DMA2_S3] = "DMA2 S3",
+};
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Account cycles spent idle.
+ * @param  cycles: cycles spent sleeping
+ */
+void perf_idle_add(uint32_t cycles)
+{
+    perf_idle_cycles += cycles;
+}
+
+/**
+ * @brief  Close a one-second window every PERF_WINDOW_TICKS ticks.
+ * @param  ticks: current SysTick tick count
+ */
+void perf_tick(uint32_t ticks)
+{
+    if (ticks % PERF_WINDOW_TICKS != 0U)
+    {
+        return;
+    }
+
+    Perf_Second_t now;
+    now.elapsed = bare_dwt_get_cycles();
+    now.idle = perf_idle_cycles;
+    for (uint32_t i = 0; i < PERF_SRC_COUNT; i++)
+    {
+        now.isr[i] = perf_isr_cycles[i];
+    }
+
+    if (perf_started)
+    {
+        Perf_Second_t *slot = &perf_history[perf_next];
+        slot->elapsed = now.elapsed - perf_last.elapsed;
+        slot->idle = now.idle - perf_last.idle;
+        for (uint32_t i = 0; i < PERF_SRC_COUNT; i++)
+        {
+            slot->isr[i] = now.isr[i] - perf_last.isr[i];
+        }
+
+        perf_next = (perf_next + 1U) % PERF_HISTORY_SECONDS;
+        if (perf_filled < PERF_HISTORY_SECONDS)
+        {
+            perf_filled++;
+        }
+    }
+
+    perf_last = now;
+    perf_started = 1;
+}
+
+/**
+ * @brief  Sum the most recent complete one-second windows.
+ * @param  seconds: window length
+ * @param  out: totals
+ */
+void perf_get_window(uint32_t seconds, Perf_Window_t *out)
+{
+    if (seconds > PERF_HISTORY_SECONDS)
+    {
+        seconds = PERF_HISTORY_SECONDS;
+    }
+
+    out->elapsed = 0;
+    out->idle = 0;
+    for (uint32_t i = 0; i < PERF_SRC_COUNT; i++)
+    {
+        out->isr[i] = 0;
+    }
+
+    // SysTick must not rotate the history while it is summed
+    uint32_t crit = bare_nvic_crit_enter(CRIT_CEILING_KERNEL);
+
+    if (seconds > perf_filled)
+    {
+        seconds = perf_filled;
+    }
+    for (uint32_t n = 0; n < seconds; n++)
+    {
+        const Perf_Second_t *s =
+            &perf_history[(perf_next + PERF_HISTORY_SECONDS - 1U - n) % PERF_HISTORY_SECONDS];
+        out->elapsed += s->elapsed;
+        out->idle += s->idle;
+        for (uint32_t i = 0; i < PERF_SRC_COUNT; i++)
+        {
+            out->isr[i] += s->isr[i];
+        }
+    }
+
+    bare_nvic_crit_exit(crit);
+    out->seconds = seconds;
+}
+
+/**
+ * @brief  Get the short name of an interrupt.
+ * @param  src: interrupt
+ * @retval Name
+ */
+const char *perf_source_name(Perf_Source_t src)
+{
+    return (src < PERF_SRC_COUNT) ? perf_names[src] : "?";
+}
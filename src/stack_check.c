@@ -0,0 +1,108 @@
+/*******************************************************************************************
+ * @file    stack_check.c
+ * @author  ka5j
+ * @brief   Stack painting, high-water marks and MPU guards below the main and task stacks
+ * @version 1.0
+ * @date    2025-06-18
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "stack_check.h"
+#include "mpu_registers.h" // MPU region setup
+#include "bare_core.h"     // Barriers
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define STACK_GUARD_LOG2 5U // 2^5 = STACK_GUARD_BYTES
+
+_Static_assert((1UL << STACK_GUARD_LOG2) == STACK_GUARD_BYTES, "Guard size is a power of two");
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+extern uint32_t _sstack; // Linker script: lowest address of the main stack
+extern uint32_t _estack; // Linker script: top of the main stack
+extern uint32_t _sguard; // Linker script: guard region below the main stack
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Enable the MPU with the main stack guard region.
+ */
+void stack_check_init(void)
+{
+    MPU->CTRL = 0U;
+    MPU->RBAR = (uint32_t)(uintptr_t)&_sguard | MPU_RBAR_VALID |
+                MPU_RBAR_REGION(STACK_GUARD_REGION);
+    MPU->RASR = MPU_RASR_XN | MPU_RASR_AP_NONE | MPU_RASR_SIZE(STACK_GUARD_LOG2) |
+                MPU_RASR_ENABLE;
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    bare_core_dsb();
+    bare_core_isb();
+}
+
+/**
+ * @brief  Move the task guard region below a task stack.
+ * @param  base: lowest usable address of the task stack
+ */
+void stack_check_guard_task(const uint32_t *base)
+{
+    MPU->RBAR = ((uint32_t)(uintptr_t)base - STACK_GUARD_BYTES) | MPU_RBAR_VALID |
+                MPU_RBAR_REGION(STACK_TASK_GUARD_REGION);
+    MPU->RASR = MPU_RASR_XN | MPU_RASR_AP_NONE | MPU_RASR_SIZE(STACK_GUARD_LOG2) |
+                MPU_RASR_ENABLE;
+    bare_core_dsb();
+}
+
+/**
+ * @brief  Paint a stack.
+ * @param  base: lowest address of the stack
+ * @param  words: stack size in words
+ */
+void stack_check_paint(uint32_t *base, uint32_t words)
+{
+    for (uint32_t i = 0; i < words; i++)
+    {
+        base[i] = STACK_PAINT_WORD;
+    }
+}
+
+/**
+ * @brief  Get the deepest use of a painted stack.
+ * @param  base: lowest address of the stack
+ * @param  words: stack size in words
+ * @retval Bytes used
+ */
+uint32_t stack_check_high_water(const uint32_t *base, uint32_t words)
+{
+    uint32_t untouched = 0;
+
+    // Stacks grow down: the paint survives from the base up to the deepest push
+    while (untouched < words && base[untouched] == STACK_PAINT_WORD)
+    {
+        untouched++;
+    }
+    return (words - untouched) * 4U;
+}
+
+/**
+ * @brief  Get the size of the main stack.
+ * @retval Bytes
+ */
+uint32_t stack_check_main_size(void)
+{
+    return (uint32_t)((uintptr_t)&_estack - (uintptr_t)&_sstack);
+}
+
+/**
+ * @brief  Get the deepest use of the main stack.
+ * @retval Bytes used
+ */
+uint32_t stack_check_main_high_water(void)
+{
+    return stack_check_high_water(&_sstack, stack_check_main_size() / 4U);
+}
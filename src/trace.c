@@ -0,0 +1,87 @@
+/*******************************************************************************************
+ * @file    trace.c
+ * @author  ka5j
+ * @brief   RAM-resident binary event trace (lock-free, ISR safe)
+ * @version 1.0
+ * @date    2025-06-16
+ *
+ * @details
+ * trace_head counts every event ever claimed; the slot is its low bits. The difference
+ * to TRACE_DEPTH tells the dump how many events were overwritten.
+ *******************************************************************************************/
+
+#include <stdint.h>
+
+#include "trace.h"
+#include "bare_usart.h" // Terminal output
+#include "bare_dwt.h"   // DWT_CPU_FREQ_HZ
+
+_Static_assert((TRACE_DEPTH & (TRACE_DEPTH - 1U)) == 0U, "TRACE_DEPTH must be a power of two");
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define TRACE_EVENTS_PER_LINE 4U
+
+/*******************************************************************************************
+ *                          Ring State (shared with the inline recorders)
+ *******************************************************************************************/
+uint32_t trace_ring[TRACE_DEPTH][2];
+volatile uint32_t trace_head;
+volatile uint8_t trace_enabled = 1;
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Start or stop recording.
+ * @param  enable: 1 to record, 0 to freeze the ring
+ */
+void trace_enable(uint8_t enable)
+{
+    trace_enabled = enable ? 1U : 0U;
+}
+
+/**
+ * @brief  Discard every recorded event.
+ */
+void trace_clear(void)
+{
+    uint8_t was_enabled = trace_enabled;
+
+    trace_enabled = 0;
+    trace_head = 0;
+    trace_enabled = was_enabled;
+}
+
+/**
+ * @brief  Stream the ring to the terminal, oldest event first.
+ */
+void trace_dump(void)
+{
+    uint8_t was_enabled = trace_enabled;
+    trace_enabled = 0; // Every ISR that claimed a slot has completed when the thread runs
+
+    uint32_t head = trace_head;
+    uint32_t count = (head < TRACE_DEPTH) ? head : TRACE_DEPTH;
+
+    bare_usart_send_string("\nTRACE BEGIN ");
+    bare_usart_send_uint(count);
+    bare_usart_send_char(' ');
+    bare_usart_send_uint(DWT_CPU_FREQ_HZ);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t slot = (head - count + i) & (TRACE_DEPTH - 1U);
+        bare_usart_send_string((i % TRACE_EVENTS_PER_LINE == 0U) ? "\r\n" : " ");
+        bare_usart_send_hex32(trace_ring[slot][0]);
+        bare_usart_send_hex32(trace_ring[slot][1]);
+    }
+
+    bare_usart_send_string("\r\nTRACE END ");
+    bare_usart_send_uint(head - count);
+    bare_usart_send_string("\r");
+
+    trace_enabled = was_enabled;
+}
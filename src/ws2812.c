@@ -0,0 +1,359 @@
+/*******************************************************************************************
+ * @file    ws2812.c
+ * @author  ka5j
+ * @brief   WS2812/SK6812 addressable LED strip driver (TIM3 PWM + DMA1, bare metal)
+ * @version 1.2
+ * @date    2025-06-13
+ *
+ * @details
+ * The bit timings are checked at compile time against the intersection of the WS2812B
+ * and SK6812 datasheet windows, so a change of timer clock or tick counts that would
+ * break either strip type fails the build.
+ *******************************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ws2812.h"
+#include "rcc_registers.h"    // RCC peripheral access macros
+#include "bare_dma.h"         // DMA stream driver
+#include "tim2_5_registers.h" // TIM2-TIM5 register definitions
+#include "bare_gpio.h"        // GPIO driver (bare-metal)
+#include "bare_tim2_5.h"      // TIM2-TIM5 (bare-metal)
+#include "bare_dwt.h"         // ISR cycle cost
+
+/*******************************************************************************************
+ *                                   Private Macros
+ *******************************************************************************************/
+#define WS_TIM TIM3
+#define WS_DMA_STREAM BARE_DMA1_STREAM2
+#define WS_DMA_CHANNEL 5U /*!< DMA1 Stream 2 channel 5 = TIM3_UP */
+
+#define WS_BYTES_PER_PIXEL 3U
+#define WS_HALF_BYTES (WS2812_HALF_PIXELS * WS_BYTES_PER_PIXEL)
+#define WS_HALF_SLOTS (WS_HALF_BYTES * 8U)   /*!< CCR values per half-buffer  */
+#define WS_HALF_WORDS (WS_HALF_SLOTS / 2U)
+
+#define WS_NS(ticks) ((ticks) * 1000UL / (WS2812_TIM_CLK_HZ / 1000000UL))
+#define WS_RESET_NS 280000UL /*!< Latch time of newer WS2812B, also covers 80 us parts */
+#define WS_RESET_HALVES ((WS_RESET_NS + WS_NS(WS_HALF_SLOTS * WS2812_PERIOD_TICKS) - 1UL) / \
+                         WS_NS(WS_HALF_SLOTS * WS2812_PERIOD_TICKS))
+
+/*******************************************************************************************
+ *                          Bit Timing Checks (WS2812B and SK6812)
+ *******************************************************************************************/
+_Static_assert(WS_NS(WS2812_T0H_TICKS) >= 250UL && WS_NS(WS2812_T0H_TICKS) <= 450UL,
+               "T0H outside 250-450 ns (WS2812B 400+-150, SK6812 300+-150)");
+_Static_assert(WS_NS(WS2812_T1H_TICKS) >= 650UL && WS_NS(WS2812_T1H_TICKS) <= 750UL,
+               "T1H outside 650-750 ns (WS2812B 800+-150, SK6812 600+-150)");
+_Static_assert(WS_NS(WS2812_PERIOD_TICKS - WS2812_T0H_TICKS) >= 750UL &&
+                   WS_NS(WS2812_PERIOD_TICKS - WS2812_T0H_TICKS) <= 1000UL,
+               "T0L outside 750-1000 ns (WS2812B 850+-150, SK6812 900+-150)");
+_Static_assert(WS_NS(WS2812_PERIOD_TICKS - WS2812_T1H_TICKS) >= 450UL &&
+                   WS_NS(WS2812_PERIOD_TICKS - WS2812_T1H_TICKS) <= 600UL,
+               "T1L outside 450-600 ns (WS2812B 450+-150, SK6812 600+-150)");
+_Static_assert(WS_NS(WS2812_PERIOD_TICKS) >= 1100UL && WS_NS(WS2812_PERIOD_TICKS) <= 1400UL,
+               "Bit period outside 1.25 us +-150 ns");
+_Static_assert(WS_RESET_HALVES * WS_NS(WS_HALF_SLOTS * WS2812_PERIOD_TICKS) >= WS_RESET_NS,
+               "Reset (latch) time too short");
+
+/*******************************************************************************************
+ *                                   Private Constants
+ *******************************************************************************************/
+#define WS_SLOT(bit) ((bit) ? WS2812_T1H_TICKS : WS2812_T0H_TICKS)
+#define WS_NIBBLE(n)                                                \
+    {                                                               \
+        WS_SLOT((n) & 8U) | ((uint32_t)WS_SLOT((n) & 4U) << 16),    \
+            WS_SLOT((n) & 2U) | ((uint32_t)WS_SLOT((n) & 1U) << 16) \
+    }
+
+/**
+ * @brief CCR values of a nibble, MSB first, as two little-endian halfword pairs
+ */
+static const uint32_t ws_nibble_slots[16][2] = {
+    WS_NIBBLE(0U), WS_NIBBLE(1U), WS_NIBBLE(2U), WS_NIBBLE(3U),
+    WS_NIBBLE(4U), WS_NIBBLE(5U), WS_NIBBLE(6U), WS_NIBBLE(7U),
+    WS_NIBBLE(8U), WS_NIBBLE(9U), WS_NIBBLE(10U), WS_NIBBLE(11U),
+    WS_NIBBLE(12U), WS_NIBBLE(13U), WS_NIBBLE(14U), WS_NIBBLE(15U),
+};
+
+/*******************************************************************************************
+ *                                   Private Variables
+ *******************************************************************************************/
+static uint8_t ws_frames[2][WS2812_MAX_PIXELS * WS_BYTES_PER_PIXEL] __attribute__((aligned(4)));
+static uint32_t ws_dma_buf[2U * WS_HALF_WORDS] DMA_BSS; // Two halves of encoded CCR slots
+static uint8_t ws_back;                         // Frame written by the application
+static uint32_t ws_length = WS2812_MAX_PIXELS;
+
+static const uint8_t *ws_tx_data;   // Front frame being sent
+static uint32_t ws_tx_pos;          // Next byte to encode
+static uint32_t ws_tx_end;          // Bytes in the frame
+static uint8_t ws_half_is_reset[2]; // Half holds only low (latch) slots
+static uint32_t ws_reset_sent;      // Latch halves fully sent
+static volatile uint8_t ws_active;
+
+static WS2812_Stats_t ws_stats;
+
+/**
+ * @brief TIM3_UP stream: halfwords to CCR1, circular over both halves
+ */
+static const Bare_DMA_Config_t ws_dma_cfg = {
+    .channel = WS_DMA_CHANNEL,
+    .dir = BARE_DMA_M2P,
+    .mode = BARE_DMA_CIRCULAR,
+    .psize = BARE_DMA_HALFWORD,
+    .msize = BARE_DMA_HALFWORD,
+    .pinc = 0U,
+    .minc = 1U,
+    .priority = 3U,
+    .fifo = BARE_DMA_FIFO_DIRECT, // One halfword per request
+    .pburst = BARE_DMA_BURST_SINGLE,
+    .mburst = BARE_DMA_BURST_SINGLE,
+    .events = BARE_DMA_EVT_HALF | BARE_DMA_EVT_DONE | BARE_DMA_EVT_ERROR,
+};
+
+/*******************************************************************************************
+ *                               Internal Helper Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Encode the next pixels (or latch slots) into one DMA half-buffer.
+ * @param  half: 0 for the first half, 1 for the second
+ */
+RAMFUNC static void ws_fill_half(uint32_t half)
+{
+    uint32_t *dst = &ws_dma_buf[half * WS_HALF_WORDS];
+    uint32_t bytes = ws_tx_end - ws_tx_pos;
+    uint32_t used = 0;
+
+    if (bytes > WS_HALF_BYTES)
+    {
+        bytes = WS_HALF_BYTES;
+    }
+
+    if (bytes != 0U)
+    {
+        ws2812_encode((uint16_t *)dst, &ws_tx_data[ws_tx_pos], bytes);
+        ws_tx_pos += bytes;
+        used = bytes * 4U;
+    }
+    ws_half_is_reset[half] = (bytes == 0U);
+
+    // CCR = 0 keeps the line low: pads the last pixels and forms the latch
+    for (uint32_t i = used; i < WS_HALF_WORDS; i++)
+    {
+        dst[i] = 0U;
+    }
+}
+
+/**
+ * @brief  End the frame: stop DMA requests and leave the line low.
+ */
+static void ws_stop(void)
+{
+    WS_TIM->DIER &= ~TIM2_5_DIER_UDE;
+    bare_dma_stop(WS_DMA_STREAM);
+    WS_TIM->CCR1 = 0U;
+    ws_active = 0;
+}
+
+/**
+ * @brief  Refill the half-buffer the DMA has just finished (ISR context).
+ * @param  half: half that was sent
+ */
+RAMFUNC static void ws_half_done(uint32_t half)
+{
+    if (ws_half_is_reset[half] && ++ws_reset_sent >= WS_RESET_HALVES)
+    {
+        ws_stop();
+        ws_stats.frames++;
+        return;
+    }
+    ws_fill_half(half);
+}
+
+/**
+ * @brief  DMA1 Stream 2 event: a half-buffer has been sent, encode the next pixels into it.
+ * @param  events: raised events
+ */
+RAMFUNC static void ws_dma_event(uint32_t events)
+{
+    uint32_t start = bare_dwt_get_cycles();
+
+    if (events & BARE_DMA_EVT_ERROR)
+    {
+        ws_stop();
+        ws_stats.dma_errors++;
+        return;
+    }
+    if (events & BARE_DMA_EVT_HALF)
+    {
+        ws_half_done(0U);
+    }
+    if ((events & BARE_DMA_EVT_DONE) && ws_active)
+    {
+        ws_half_done(1U);
+    }
+
+    uint32_t cycles = bare_dwt_get_cycles() - start;
+    ws_stats.isr_last_cycles = cycles;
+    if (cycles > ws_stats.isr_max_cycles)
+    {
+        ws_stats.isr_max_cycles = cycles;
+    }
+}
+
+/*******************************************************************************************
+ *                               Public API Functions
+ *******************************************************************************************/
+
+/**
+ * @brief  Encode bytes into PWM bit slots, MSB first.
+ * @param  slots: output, 8 CCR values per byte (4-byte aligned)
+ * @param  data: bytes in wire order
+ * @param  count: number of bytes
+ */
+RAMFUNC void ws2812_encode(uint16_t *slots, const uint8_t *data, uint32_t count)
+{
+    uint32_t *dst = (uint32_t *)slots;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint32_t *hi = ws_nibble_slots[data[i] >> 4];
+        const uint32_t *lo = ws_nibble_slots[data[i] & 0x0FU];
+        dst[0] = hi[0];
+        dst[1] = hi[1];
+        dst[2] = lo[0];
+        dst[3] = lo[1];
+        dst += 4;
+    }
+}
+
+/**
+ * @brief  Configure PA6, TIM3 CH1 PWM and DMA1 Stream 2.
+ */
+void ws2812_init(void)
+{
+    bare_gpio_AF(GPIOA, GPIO_PIN6, AF2); // TIM3_CH1
+    bare_tim2_5_PWM_init(WS_TIM, 0U, WS2812_PERIOD_TICKS - 1U);
+
+    bare_dma_claim(WS_DMA_STREAM, &ws_dma_cfg, ws_dma_event);
+}
+
+/**
+ * @brief  Set the number of pixels sent per frame.
+ * @param  count: pixels on the strip
+ */
+void ws2812_set_length(uint32_t count)
+{
+    ws_length = (count > WS2812_MAX_PIXELS) ? WS2812_MAX_PIXELS : count;
+}
+
+/**
+ * @brief  Get the number of pixels sent per frame.
+ * @retval Strip length
+ */
+uint32_t ws2812_get_length(void)
+{
+    return ws_length;
+}
+
+/**
+ * @brief  Set one pixel in the back frame.
+ */
+void ws2812_set_pixel(uint32_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index >= WS2812_MAX_PIXELS)
+    {
+        return;
+    }
+
+    uint8_t *px = &ws_frames[ws_back][index * WS_BYTES_PER_PIXEL];
+    px[0] = g; // Wire order is G, R, B
+    px[1] = r;
+    px[2] = b;
+}
+
+/**
+ * @brief  Set every pixel of the back frame to one color.
+ */
+void ws2812_fill(uint8_t r, uint8_t g, uint8_t b)
+{
+    for (uint32_t i = 0; i < WS2812_MAX_PIXELS; i++)
+    {
+        ws2812_set_pixel(i, r, g, b);
+    }
+}
+
+/**
+ * @brief  Swap the frames and start sending the new front frame.
+ * @retval 0 on success, -1 if the previous frame is still being sent
+ */
+int ws2812_show(void)
+{
+    return (ws2812_show_range(ws_length) < 0) ? -1 : 0;
+}
+
+/**
+ * @brief  Swap the frames and send the first pixels of the new front frame.
+ * @param  count: pixels to send (clamped to the strip length)
+ * @retval Bytes sent, -1 if the previous frame is still being sent
+ */
+int ws2812_show_range(uint32_t count)
+{
+    if (ws_active)
+    {
+        return -1;
+    }
+
+    if (count > ws_length)
+    {
+        count = ws_length;
+    }
+    if (count == 0U)
+    {
+        return 0;
+    }
+
+    uint8_t front = ws_back;
+    ws_back ^= 1U;
+
+    // Keep the back frame identical to what is on the strip
+    const uint32_t *src = (const uint32_t *)ws_frames[front];
+    uint32_t *dst = (uint32_t *)ws_frames[ws_back];
+    for (uint32_t i = 0; i < sizeof(ws_frames[0]) / sizeof(uint32_t); i++)
+    {
+        dst[i] = src[i];
+    }
+
+    ws_tx_data = ws_frames[front];
+    ws_tx_pos = 0;
+    ws_tx_end = count * WS_BYTES_PER_PIXEL;
+    ws_reset_sent = 0;
+    ws_fill_half(0U);
+    ws_fill_half(1U);
+
+    ws_active = 1;
+    bare_dma_start(WS_DMA_STREAM, (uint32_t)(uintptr_t)&WS_TIM->CCR1, ws_dma_buf, NULL,
+                   2U * WS_HALF_SLOTS);
+    WS_TIM->DIER |= TIM2_5_DIER_UDE; // First slot is loaded on the next update event
+    return (int)ws_tx_end;
+}
+
+/**
+ * @brief  Check whether a frame is being sent.
+ * @retval 1 while the DMA is active
+ */
+uint8_t ws2812_busy(void)
+{
+    return ws_active;
+}
+
+/**
+ * @brief  Get the driver statistics.
+ * @retval Pointer to the statistics record
+ */
+const WS2812_Stats_t *ws2812_get_stats(void)
+{
+    return &ws_stats;
+}
@@ -43,6 +43,13 @@ defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
 .word  _ebss
+/* load, start and end addresses of the .ramfunc section. defined in linker script */
+.word  _siramfunc
+.word  _sramfunc
+.word  _eramfunc
+/* start and end addresses of the .dma_bss section (SRAM2). defined in linker script */
+.word  _sdma_bss
+.word  _edma_bss
 /* stack used for SystemInit_ExtMemCtl; always internal RAM used */
 
 /**
@@ -59,40 +66,59 @@ defined in linker script */
   .type  Reset_Handler, %function
 Reset_Handler:  
   ldr   sp, =_estack      /* set stack pointer */
+
+/* Start the DWT cycle counter from zero to time the boot (perf_boot_cycles) */
+  ldr r0, =0xE000EDFC     /* CoreDebug DEMCR */
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000 /* TRCENA: power up DWT */
+  str r1, [r0]
+  ldr r0, =0xE0001000     /* DWT CTRL, CYCCNT at +4 */
+  movs r1, #0
+  str r1, [r0, #4]
+  ldr r1, [r0]
+  orr r1, r1, #1          /* CYCCNTENA */
+  str r1, [r0]
+
+/* Paint the main stack so its high-water mark can be measured (stack_check.h) */
+  ldr r0, =_sstack
+  ldr r1, =_estack
+  ldr r2, =0xA5A5A5A5
+  bl FillBlock
   
 /* Call the clock system initialization function.*/
 //  bl  SystemInit  
 
+/* Copy the RAM-resident functions from flash to SRAM1 */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl CopyBlock
+
 /* Copy the data segment initializers from flash to SRAM */  
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
-
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
+  bl CopyBlock
   
 /* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
-
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
-
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  movs r2, #0
+  bl FillBlock
+
+/* Zero fill the DMA buffers in SRAM2. */
+  ldr r0, =_sdma_bss
+  ldr r1, =_edma_bss
+  movs r2, #0
+  bl FillBlock
+
+/* .noinit, .pools and .arena are deliberately left untouched */
+
+/* Record the boot time (cycles from reset to main) */
+  ldr r0, =0xE0001004     /* DWT CYCCNT */
+  ldr r1, [r0]
+  ldr r0, =perf_boot_cycles
+  str r1, [r0]
   
 /* Call static constructors */
     //bl __libc_init_array
@@ -101,6 +127,71 @@ LoopFillZerobss:
   bx  lr    
 .size  Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Copy words from flash to RAM, eight per LDM/STM pair.
+ * @param  r0: destination start, r1: destination end, r2: source (word aligned)
+ * @retval None (clobbers r0-r10 and r12, nothing is live yet during boot)
+*/
+    .section  .text.CopyBlock,"ax",%progbits
+  .type  CopyBlock, %function
+CopyBlock:
+  sub r12, r1, #32        /* last address a whole 32-byte block can start at */
+  b LoopCopyBlock32
+
+CopyBlock32:
+  ldmia r2!, {r3-r10}
+  stmia r0!, {r3-r10}
+
+LoopCopyBlock32:
+  cmp r0, r12
+  bls CopyBlock32
+  b LoopCopyWord
+
+CopyWord:
+  ldr r3, [r2], #4
+  str r3, [r0], #4
+
+LoopCopyWord:
+  cmp r0, r1
+  bcc CopyWord
+  bx lr
+.size  CopyBlock, .-CopyBlock
+
+/**
+ * @brief  Fill RAM with a word, eight words per STM.
+ * @param  r0: start, r1: end (word aligned), r2: fill value
+ * @retval None (clobbers r0-r9 and r12, nothing is live yet during boot)
+*/
+    .section  .text.FillBlock,"ax",%progbits
+  .type  FillBlock, %function
+FillBlock:
+  mov r3, r2
+  mov r4, r2
+  mov r5, r2
+  mov r6, r2
+  mov r7, r2
+  mov r8, r2
+  mov r9, r2
+  sub r12, r1, #32        /* last address a whole 32-byte block can start at */
+  b LoopFillBlock32
+
+FillBlock32:
+  stmia r0!, {r2-r9}
+
+LoopFillBlock32:
+  cmp r0, r12
+  bls FillBlock32
+  b LoopFillWord
+
+FillWord:
+  str r2, [r0], #4
+
+LoopFillWord:
+  cmp r0, r1
+  bcc FillWord
+  bx lr
+.size  FillBlock, .-FillBlock
+
 /**
  * @brief  This is the code that gets called when the processor receives an 
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Host side of the binary LED control protocol (inc/led_proto.h).
+
+Usage:
+    led_proto.py encode <seq> <op> [<op> ...]      print the frame as hex
+    led_proto.py decode <hex>                      decode a frame or an ack
+    led_proto.py send <port> <baud> <op> [...]     send one frame, wait for its ack (pyserial)
+    led_proto.py selftest [count]                  encoder/decoder round trip
+
+An <op> is the operation name and its comma-separated arguments, e.g.
+    ping  led1:1  led2:50  fill:255,0,0  set:3,0,0,255  run:0,0,0,255,0,255,0
+    apafill:255,255,255,31  apaset:0,255,0,0,31
+
+A frame is 0x00 COBS(seq | ops | crc32) 0x00; the CRC is CRC-32/MPEG-2 (poly 0x04C11DB7,
+init 0xFFFFFFFF, no reflection, no final XOR) of seq and ops, stored little-endian.
+"""
+
+import os
+import random
+import struct
+import sys
+
+OPS = {
+    "ping": (0x01, ""),
+    "led1": (0x02, "B"),
+    "led2": (0x03, "B"),
+    "fill": (0x04, "BBB"),
+    "set": (0x05, "<HBBB"),
+    "run": (0x06, None),  # first (u16), count (u8), count x (r, g, b)
+    "apafill": (0x07, "BBBB"),
+    "apaset": (0x08, "<HBBBB"),
+}
+STATUS = {0: "OK", 1: "BAD_CRC", 2: "BAD_OP", 3: "BAD_ARG", 4: "OVERFLOW"}
+FRAME_MAX = 192  # LED_PROTO_FRAME_MAX
+
+
+def crc32_mpeg2(data):
+    crc = 0xFFFFFFFF
+    for byte in data:
+        crc ^= byte << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+            crc &= 0xFFFFFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for byte in data:
+        if byte == 0:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+        else:
+            out.append(byte)
+            code += 1
+            if code == 0xFF:
+                out[code_pos] = code
+                code_pos, code = len(out), 1
+                out.append(0)
+    out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data):
+            raise ValueError("malformed COBS at byte %d" % pos)
+        block = data[pos + 1:pos + code]
+        if 0 in block:
+            raise ValueError("zero inside COBS block at byte %d" % pos)
+        out += block
+        pos += code
+        if code != 0xFF and pos != len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frame(payload):
+    """Delimited frame for a payload (CRC appended here)."""
+    body = bytes(payload)
+    return b"\0" + cobs_encode(body + struct.pack("<I", crc32_mpeg2(body))) + b"\0"
+
+
+def unframe(raw):
+    """Payload of a delimited or bare frame, CRC checked and removed."""
+    data = cobs_decode(raw.strip(b"\0"))
+    if len(data) < 5:
+        raise ValueError("frame too short")
+    body, crc = data[:-4], struct.unpack("<I", data[-4:])[0]
+    if crc != crc32_mpeg2(body):
+        raise ValueError("CRC mismatch")
+    return body
+
+
+def encode_op(spec):
+    name, _, args = spec.partition(":")
+    if name not in OPS:
+        raise ValueError("unknown op %r" % name)
+    code, fmt = OPS[name]
+    values = [int(v, 0) for v in args.split(",")] if args else []
+    if fmt is None:
+        first, pixels = values[0], values[1:]
+        if len(pixels) % 3:
+            raise ValueError("run needs r,g,b triples")
+        return bytes([code]) + struct.pack("<HB", first, len(pixels) // 3) + bytes(pixels)
+    return bytes([code]) + struct.pack(fmt, *values)
+
+
+def encode(seq, specs):
+    return frame(bytes([seq & 0xFF]) + b"".join(encode_op(s) for s in specs))
+
+
+def describe_ack(body):
+    if len(body) != 3:
+        return "payload %s" % body.hex()
+    return "seq %d %s, %d ops done" % (body[0], STATUS.get(body[1], body[1]), body[2])
+
+
+def send(port, baud, specs):
+    import serial  # pyserial, only needed here
+
+    link = serial.Serial(port, int(baud), timeout=1.0)
+    seq = int.from_bytes(os.urandom(1), "little")
+    link.write(encode(seq, specs))
+    raw = bytearray()
+    while True:
+        byte = link.read(1)
+        if not byte:
+            sys.exit("no ack")
+        if byte == b"\0" and raw.strip(b"\0"):
+            break
+        raw += byte
+    body = unframe(bytes(raw))
+    print(describe_ack(body))
+    return 0 if body[0] == seq and body[1] == 0 else 1
+
+
+def selftest(count):
+    rng = random.Random(1)
+    assert crc32_mpeg2(b"123456789") == 0x0376E6E7, "CRC-32/MPEG-2 check value"
+    vectors = [
+        (b"", b"\x01"),
+        (b"\x00", b"\x01\x01"),
+        (b"\x11\x22\x00\x33", b"\x03\x11\x22\x02\x33"),
+        (bytes(range(1, 255)), b"\xff" + bytes(range(1, 255)) + b"\x01"),
+    ]
+    for raw, enc in vectors:
+        assert cobs_encode(raw) == enc, "COBS vector %s" % raw[:8].hex()
+        assert cobs_decode(enc) == raw, "COBS vector %s" % raw[:8].hex()
+
+    for n in range(count):
+        payload = bytes(rng.choice((0, rng.randrange(256))) for _ in range(rng.randrange(600)))
+        enc = cobs_encode(payload)
+        assert 0 not in enc and len(enc) <= len(payload) + len(payload) // 254 + 1
+        assert cobs_decode(enc) == payload, "round trip %d" % n
+        assert unframe(frame(payload + b"\x00")) == payload + b"\x00"
+
+    ops = ["ping", "led1:2", "led2:50", "fill:1,0,2", "set:300,0,0,0", "apaset:1,0,0,0,31",
+           "run:5," + ",".join(str(v) for v in range(30))]
+    raw = encode(0, ops)
+    assert len(raw) - 2 <= FRAME_MAX and unframe(raw)[0] == 0
+    print("selftest OK: %d random frames, %d bytes for %d ops" % (count, len(raw), len(ops)))
+    return 0
+
+
+def main():
+    args = sys.argv[1:]
+    if not args:
+        sys.exit(__doc__)
+    cmd = args[0]
+    if cmd == "encode" and len(args) >= 3:
+        print(encode(int(args[1], 0), args[2:]).hex())
+        return 0
+    if cmd == "decode" and len(args) == 2:
+        body = unframe(bytes.fromhex(args[1]))
+        print(describe_ack(body) if len(body) == 3 else "seq %d ops %s" % (body[0], body[1:].hex()))
+        return 0
+    if cmd == "send" and len(args) >= 4:
+        return send(args[1], args[2], args[3:])
+    if cmd == "selftest":
+        return selftest(int(args[1]) if len(args) > 1 else 1000)
+    sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Summarize a GNU ld map file by memory region.
+
+Usage:
+    map_report.py [main.map] [top]       (reads stdin when no file is given)
+
+For every region of the "Memory Configuration" table (FLASH, SRAM1, SRAM2) the report
+lists the bytes used, the output sections placed there and the largest input sections
+(object file and section name), so a change in placement shows up at a glance. Sections
+copied at boot (.data, .ramfunc) count against their run region and, through their load
+address, against FLASH. "top" is the number of input sections listed per region
+(default 10).
+"""
+
+import re
+import sys
+
+HEX = r"0x([0-9a-fA-F]+)"
+OUTPUT_LINE = re.compile(r"^(\S+)\s+" + HEX + r"\s+" + HEX + r"(?:\s+load address " + HEX + ")?")
+INPUT_LINE = re.compile(r"^ (\S+)\s+" + HEX + r"\s+" + HEX + r"\s+(\S.*)$")
+WRAPPED_LINE = re.compile(r"^\s+" + HEX + r"\s+" + HEX + r"(?:\s+load address " + HEX + r")?"
+                          r"(?:\s+(\S.*))?$")
+
+# ld prints a load address for every section after an AT> one, but these have no contents
+UNLOADED = re.compile(r"bss|noinit|pools|arena|heap|stack")
+
+
+def parse(lines):
+    """Return (regions, outputs, inputs) of the map.
+
+    regions: [(name, origin, length)]
+    outputs: [(name, vma, size, lma)]
+    inputs:  [(output name, input name, vma, size, object)]
+    """
+    regions = []
+    outputs = []
+    inputs = []
+    state = None
+    current = None
+    pending = None  # Section name whose address and size are on the next line
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if line.startswith("Memory Configuration"):
+            state = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "map"
+            continue
+        if state == "memory":
+            fields = line.split()
+            if len(fields) >= 3 and fields[1].startswith("0x") and fields[0] != "*default*":
+                regions.append((fields[0], int(fields[1], 16), int(fields[2], 16)))
+            continue
+        if state != "map" or not line.strip():
+            continue
+        if line.startswith("OUTPUT("):
+            break
+
+        if pending is not None:
+            wrapped = WRAPPED_LINE.match(line)
+            kind, name = pending
+            pending = None
+            if wrapped:
+                vma, size = int(wrapped.group(1), 16), int(wrapped.group(2), 16)
+                if kind == "output":
+                    lma = int(wrapped.group(3), 16) if wrapped.group(3) else vma
+                    current = name
+                    outputs.append((name, vma, size, lma))
+                elif current is not None and wrapped.group(4):
+                    inputs.append((current, name, vma, size, wrapped.group(4)))
+                continue
+
+        if not line[0].isspace():
+            out = OUTPUT_LINE.match(line)
+            if out:
+                vma, size = int(out.group(2), 16), int(out.group(3), 16)
+                lma = int(out.group(4), 16) if out.group(4) else vma
+                current = out.group(1)
+                outputs.append((current, vma, size, lma))
+            elif len(line.split()) == 1 and line.startswith("."):
+                pending = ("output", line.strip())
+            else:
+                current = None  # LOAD, OUTPUT_FORMAT and similar directives
+            continue
+
+        if current is None or line.startswith("  "):
+            continue  # Symbols, assignments and wildcard patterns
+        inp = INPUT_LINE.match(line)
+        if inp:
+            inputs.append((current, inp.group(1), int(inp.group(2), 16),
+                           int(inp.group(3), 16), inp.group(4)))
+        elif len(line.split()) == 1 and not line.lstrip().startswith("*"):
+            pending = ("input", line.strip())
+
+    return regions, outputs, inputs
+
+
+def region_of(regions, address):
+    for name, origin, length in regions:
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def main():
+    args = sys.argv[1:]
+    top = 10
+    if len(args) > 1:
+        top = int(args[1])
+    stream = open(args[0], errors="replace") if args else sys.stdin
+    regions, outputs, inputs = parse(stream)
+    if not regions:
+        sys.exit("no Memory Configuration found")
+
+    for name, origin, length in regions:
+        placed = [o for o in outputs if o[2] and region_of(regions, o[1]) == name]
+        loaded = [o for o in outputs
+                  if o[2] and o[3] != o[1] and region_of(regions, o[3]) == name
+                  and not UNLOADED.search(o[0])]
+        used = sum(o[2] for o in placed) + sum(o[2] for o in loaded)
+
+        print("%-8s 0x%08X %8d / %8d bytes (%5.1f%%)"
+              % (name, origin, used, length, 100.0 * used / length if length else 0.0))
+        for sect, vma, size, lma in placed:
+            load = "  load 0x%08X" % lma if lma != vma and not UNLOADED.search(sect) else ""
+            print("    %-20s 0x%08X %8d%s" % (sect, vma, size, load))
+        for sect, vma, size, lma in loaded:
+            print("    %-20s 0x%08X %8d  (initializers of %s)" % (sect, lma, size, sect))
+
+        members = [i for i in inputs if i[3] and region_of(regions, i[2]) == name]
+        members.sort(key=lambda i: i[3], reverse=True)
+        if members:
+            print("    largest input sections:")
+        for out, sect, vma, size, obj in members[:top]:
+            print("      %8d  %-32s %s" % (size, sect, obj))
+        print()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Store the flash image CRC in its last word (inc/image_check.h).
+
+Usage:
+    patch_crc.py main.bin [crc.bin]
+
+main.bin is the raw image from FLASH_BASE (objcopy -O binary --gap-fill 0xFF); its last
+word is the .image_crc placeholder (0xFFFFFFFF). The CRC covers every word before it the
+way the STM32 CRC unit sees them when the DMA feeds memory words: CRC-32/MPEG-2 (poly
+0x04C11DB7, init 0xFFFFFFFF, no reflection, no final XOR) with the bytes of each
+little-endian word taken most significant first. The CRC is written into main.bin and,
+when given, into crc.bin as the 4-byte contents for objcopy --update-section .image_crc.
+"""
+
+import struct
+import sys
+
+PLACEHOLDER = 0xFFFFFFFF
+
+
+def crc32_mpeg2(data, crc=0xFFFFFFFF):
+    for byte in data:
+        crc ^= byte << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+            crc &= 0xFFFFFFFF
+    return crc
+
+
+def image_crc(image):
+    """CRC of the words of image, each fed most significant byte first."""
+    count = len(image) // 4
+    words = struct.unpack("<%dI" % count, image)
+    return crc32_mpeg2(struct.pack(">%dI" % count, *words))
+
+
+def main():
+    args = sys.argv[1:]
+    if len(args) not in (1, 2):
+        sys.exit(__doc__)
+    with open(args[0], "rb") as f:
+        data = bytearray(f.read())
+    if len(data) < 8 or len(data) % 4:
+        sys.exit("%s: %d bytes, not a word-aligned image" % (args[0], len(data)))
+
+    crc = image_crc(bytes(data[:-4]))
+    stored = struct.unpack("<I", data[-4:])[0]
+    if stored not in (PLACEHOLDER, crc):
+        sys.exit("%s: last word 0x%08X is neither the placeholder nor the CRC" % (args[0], stored))
+
+    data[-4:] = struct.pack("<I", crc)
+    with open(args[0], "wb") as f:
+        f.write(data)
+    if len(args) == 2:
+        with open(args[1], "wb") as f:
+            f.write(struct.pack("<I", crc))
+    print("image CRC 0x%08X over %d bytes" % (crc, len(data) - 4))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Decode a TRACE DUMP captured from the terminal into a timeline.
+
+Usage:
+    trace_decode.py [capture.log]        (reads stdin when no file is given)
+
+The capture may contain other terminal output; only the lines between
+"TRACE BEGIN" and "TRACE END" are decoded. Each event is 16 hex digits: the
+DWT cycle count followed by the event word (id << 24 | data), see inc/trace.h.
+"""
+
+import re
+import sys
+
+EVT_ISR_ENTER = 1
+EVT_ISR_EXIT = 2
+EVT_CMD_START = 3
+EVT_CMD_END = 4
+EVT_QUEUE = 5
+
+SOURCES = {0: "SysTick", 1: "TIM2", 2: "USART2", 3: "USART1"}
+EXIT_VALUES = {0: "tick", 2: "tx_ring", 3: "tx_ring"}
+QUEUES = {0: "evt_high", 1: "evt_normal", 2: "evt_low"}
+
+
+def parse(lines):
+    """Return (cpu_hz, dropped, [(cycles, word), ...]) of the last dump in the capture."""
+    dump = None
+    for line in lines:
+        line = line.strip()
+        begin = re.match(r"TRACE BEGIN (\d+) (\d+)", line)
+        if begin:
+            dump = {"hz": int(begin.group(2)), "events": [], "dropped": None}
+            continue
+        if dump is None or dump["dropped"] is not None:
+            continue
+        end = re.match(r"TRACE END (\d+)", line)
+        if end:
+            dump["dropped"] = int(end.group(1))
+            continue
+        for token in line.split():
+            if re.fullmatch(r"[0-9A-Fa-f]{16}", token):
+                dump["events"].append((int(token[:8], 16), int(token[8:], 16)))
+
+    if dump is None:
+        sys.exit("no TRACE BEGIN found")
+    if dump["dropped"] is None:
+        print("warning: dump is truncated (no TRACE END)", file=sys.stderr)
+    return dump["hz"], dump["dropped"] or 0, dump["events"]
+
+
+def unwrap(events):
+    """Turn 32-bit wrapping cycle counts into a 64-bit timeline.
+
+    A writer reads the cycle counter after claiming its slot, so an event recorded by a
+    preempting ISR can carry a slightly earlier time than the slot before it. Steps are
+    therefore taken as signed 32-bit differences, and the events are sorted by time.
+    """
+    now = None
+    out = []
+    for cycles, word in events:
+        if now is None:
+            now = cycles
+        else:
+            step = (cycles - now) & 0xFFFFFFFF
+            now += step - (1 << 32) if step >= (1 << 31) else step
+        out.append((now, word))
+    return sorted(out, key=lambda event: event[0])
+
+
+def describe(word):
+    evt = word >> 24
+    data = word & 0xFFFFFF
+    src = SOURCES.get(data >> 16, "src%d" % (data >> 16))
+    if evt == EVT_ISR_ENTER:
+        return "enter", src, ""
+    if evt == EVT_ISR_EXIT:
+        label = EXIT_VALUES.get(data >> 16)
+        return "exit", src, ("%s=%d" % (label, data & 0xFFFF)) if label else ""
+    if evt == EVT_CMD_START:
+        text = "".join(chr(b) for b in data.to_bytes(3, "big") if 32 <= b < 127)
+        return "cmd", "command", "'%s...'" % text
+    if evt == EVT_CMD_END:
+        return "cmd_end", "command", ""
+    if evt == EVT_QUEUE:
+        queue = QUEUES.get(data >> 16, "queue%d" % (data >> 16))
+        return "queue", queue, "depth=%d" % (data & 0xFFFF)
+    return "unknown", "event%d" % evt, "data=0x%06X" % data
+
+
+def main():
+    stream = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+    hz, dropped, raw = parse(stream)
+    events = unwrap(raw)
+    if not events:
+        print("trace is empty")
+        return
+
+    us_per_cycle = 1e6 / hz
+    t0 = events[0][0]
+    open_isrs = []  # stack of (source, entry time) for nesting and durations
+    cmd_start = None
+    stats = {}
+
+    print("%d events, %d older events overwritten, %d Hz" % (len(events), dropped, hz))
+    print("%12s  %s" % ("time [us]", "event"))
+    for cycles, word in events:
+        kind, name, detail = describe(word)
+        time_us = (cycles - t0) * us_per_cycle
+        extra = ""
+
+        if kind == "enter":
+            depth = len(open_isrs)
+            open_isrs.append((name, cycles))
+        elif kind == "exit":
+            # An exit without its entry happens at the start of the ring
+            while open_isrs and open_isrs[-1][0] != name:
+                open_isrs.pop()
+            if open_isrs:
+                entry = open_isrs.pop()[1]
+                duration = (cycles - entry) * us_per_cycle
+                extra = " (%.2f us)" % duration
+                count, total, worst = stats.get(name, (0, 0.0, 0.0))
+                stats[name] = (count + 1, total + duration, max(worst, duration))
+            depth = len(open_isrs)
+        elif kind == "cmd":
+            depth = len(open_isrs)
+            cmd_start = cycles
+        elif kind == "cmd_end":
+            depth = len(open_isrs)
+            if cmd_start is not None:
+                extra = " (%.2f us)" % ((cycles - cmd_start) * us_per_cycle)
+                cmd_start = None
+        else:
+            depth = len(open_isrs)
+
+        print("%12.2f  %s%s %s %s%s" % (time_us, "  " * depth, kind, name, detail, extra))
+
+    if stats:
+        print("\n%-10s %8s %12s %12s" % ("isr", "count", "avg [us]", "max [us]"))
+        for name, (count, total, worst) in sorted(stats.items()):
+            print("%-10s %8d %12.2f %12.2f" % (name, count, total / count, worst))
+
+
+if __name__ == "__main__":
+    main()